@@ -5,16 +5,26 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "../Utils/Allocator.h"
+
 /**
  * @brief A dynamic array, that dynamically expands its memory footprint when necessary.
 */
 typedef struct Array Array;
 
 Array* ArrayNew(size_t elementSize);
+Array* ArrayNewWithAllocator(size_t elementSize, const Allocator* allocator);
+Array* ArrayNewAligned(size_t elementSize, const size_t alignment, const Allocator* allocator);
+Array* ArrayNewReserved(size_t elementSize, const uint64_t maxCapacity, const bool useHugePages);
 void* ArrayAdd(Array* array, const void* newElement);
+void* ArrayAppend(Array* array, const void* newElements, const uint64_t numElements);
+void* ArrayInsert(Array* array, const uint64_t index, const void* newElements, const uint64_t numElements);
+void ArrayErase(Array* array, const uint64_t index, const uint64_t numElements);
+void ArraySwapRemove(Array* array, const uint64_t index, void* removedElement);
 void ArrayPopBack(Array* array, void* poppedElement);
 void* ArrayGet(const Array* array, const uint64_t index);
-void ArrayResize(Array* array, const uint64_t newCapacity);
+bool ArrayResize(Array* array, const uint64_t newCapacity);
+bool ArrayReserve(Array* array, const uint64_t minCapacity);
 void ArrayFill(Array* array, void* value);
 void ArrayClear(Array* array);
 bool ArrayContains(Array* array, void* element);
@@ -1,26 +1,64 @@
 #ifndef BUCKETARRAY_H
 #define BUCKETARRAY_H
 
+#include "Index.h"
+
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+
+#include "../Utils/Allocator.h"
 
 /**
  * @brief A dynamic array, that dynamically expands its memory footprint when necessary. This expanding happens in buckets, in order to prevent pointers to elements becoming corrupt.
  */
 typedef struct BucketArray BucketArray;
 
-BucketArray* BucketArrayNew(const size_t elementSize, const uint64_t bucketCapacity);
+/**
+ * @brief The way the buckets of a bucketArray are sized.
+ */
+typedef enum BucketArrayLayout
+{
+    BUCKET_ARRAY_LAYOUT_FIXED,      // Every bucket holds the same number of elements.
+    BUCKET_ARRAY_LAYOUT_GEOMETRIC,  // Every bucket holds twice as many elements as the previous one, starting from a power of 2.
+    BUCKET_ARRAY_LAYOUT_RESERVED    // A single bucket in a reserved range of address space, which gets committed as the bucketArray grows.
+} BucketArrayLayout;
+
+/**
+ * @brief Iterates over a bucketArray one contiguous span of elements at a time. Every span covers (part of) a single bucket.
+ */
+typedef struct BucketArrayIterator
+{
+    const BucketArray* bucketArray;     // The bucketArray being iterated.
+    Index bucketIndex;                  // The bucket the next span starts in. Only used by forward iteration.
+    Index elementIndex;                 // Forward: the index of the first element of the next span. Reverse: the index after the last element of the next span.
+    bool isReversed;                    // Wether the spans are returned from the back to the front.
+} BucketArrayIterator;
+
+BucketArray* BucketArrayNew(const size_t elementSize, const Index bucketCapacity);
+BucketArray* BucketArrayNewWithAllocator(const size_t elementSize, const Index bucketCapacity, const Allocator* allocator);
+BucketArray* BucketArrayNewAligned(const size_t elementSize, const Index bucketCapacity, const size_t alignment, const Allocator* allocator);
+BucketArray* BucketArrayNewGeometric(const size_t elementSize, const Index firstBucketCapacity);
+BucketArray* BucketArrayNewReserved(const size_t elementSize, const Index maxCapacity, const bool useHugePages);
 void* BucketArrayAdd(BucketArray* bucketArray, const void* newElement);
+void* BucketArrayAppend(BucketArray* bucketArray, const void* newElements, const Index numElements);
+void BucketArraySwapRemove(BucketArray* bucketArray, const Index index, void* removedElement);
 void BucketArrayPopBack(BucketArray* bucketArray, void* poppedElement);
-void* BucketArrayGet(const BucketArray* bucketArray, const uint64_t index);
-void BucketArrayResize(BucketArray* bucketArray, const uint64_t newCapacity);
+void* BucketArrayGet(const BucketArray* bucketArray, const Index index);
+bool BucketArrayResize(BucketArray* bucketArray, const Index newCapacity);
+bool BucketArrayReserve(BucketArray* bucketArray, const Index minCapacity);
 void BucketArrayFill(BucketArray* array, void* value);
 void BucketArrayClear(BucketArray* bucketArray);
+uint64_t BucketArrayShrink(BucketArray* bucketArray, const uint64_t maxBucketsToRelease);
 void BucketArrayFree(BucketArray* bucketArray);
 
-uint64_t BucketArrayNum(BucketArray* bucketArray);
-uint64_t BucketArrayNumBuckets(BucketArray* bucketArray);
-uint64_t BucketArrayCapacity(BucketArray* bucketArray);
-uint64_t BucketArrayBucketCapacity(BucketArray* bucketArray);
+BucketArrayIterator BucketArrayIterate(const BucketArray* bucketArray);
+BucketArrayIterator BucketArrayIterateReverse(const BucketArray* bucketArray);
+bool BucketArrayIteratorNext(BucketArrayIterator* iterator, void** span, Index* spanNum);
+
+Index BucketArrayNum(BucketArray* bucketArray);
+Index BucketArrayNumBuckets(BucketArray* bucketArray);
+Index BucketArrayCapacity(BucketArray* bucketArray);
+Index BucketArrayBucketCapacity(BucketArray* bucketArray);
 
 #endif
\ No newline at end of file
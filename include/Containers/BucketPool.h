@@ -0,0 +1,20 @@
+#ifndef BUCKETPOOL_H
+#define BUCKETPOOL_H
+
+#include <stddef.h>
+
+#include "../Utils/Allocator.h"
+
+/**
+ * @brief A cache of freed buckets, grouped by their exact size, so containers with the same bucket size can recycle each other's buckets instead of going back to the system allocator.
+ */
+typedef struct BucketPool BucketPool;
+
+BucketPool* BucketPoolNew(const Allocator* allocator, const size_t maxIdleSize);
+const Allocator* BucketPoolGetAllocator(BucketPool* bucketPool);
+void BucketPoolTrim(BucketPool* bucketPool, const size_t maxIdleSize);
+void BucketPoolFree(BucketPool* bucketPool);
+
+size_t BucketPoolIdleSize(const BucketPool* bucketPool);
+
+#endif
\ No newline at end of file
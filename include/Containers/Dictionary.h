@@ -5,12 +5,17 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "../Utils/Allocator.h"
+#include "../Utils/Hash.h"
+
 /**
 * @brief A container, which stores its data in a value, which is associated with a key. There is no limit to the number of elements, although the main capacity should be considered carefully.
 */
 typedef struct Dictionary Dictionary;
 
 Dictionary* DictionaryNew(const size_t keySize, const size_t valueSize);
+Dictionary* DictionaryNewWithAllocator(const size_t keySize, const size_t valueSize, const Allocator* allocator);
+Dictionary* DictionaryNewWithHash(const size_t keySize, const size_t valueSize, const HashFunction hashFunction, const Allocator* allocator);
 void* DictionaryAdd(Dictionary* dict, const void* key, const void* value);
 void DictionaryRemove(Dictionary* dict, const void* key);
 void* DictionaryGet(const Dictionary* dict, const void* key);
@@ -0,0 +1,18 @@
+#ifndef INDEX_H
+#define INDEX_H
+
+#include <stdint.h>
+
+/**
+ * @brief The integer type used for element indices and counts in bucketArrays and sparse sets, and for entity handles.
+ * Defining INDEX_32 at compile time halves the memory footprint of the sparse data, so twice as many indices fit in a cache line. This limits the number of elements to 2^32 - 1.
+ */
+#ifdef INDEX_32
+typedef uint32_t Index;
+#define INDEX_MAX UINT32_MAX
+#else
+typedef uint64_t Index;
+#define INDEX_MAX UINT64_MAX
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef SORTEDARRAY_H
+#define SORTEDARRAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "../Utils/Allocator.h"
+
+/**
+ * @brief An array of 64 bit keys, kept in ascending order, so keys can be found with a binary search instead of a linear scan. The same key can be present multiple times.
+ */
+typedef struct SortedArray SortedArray;
+
+SortedArray* SortedArrayNew();
+SortedArray* SortedArrayNewWithAllocator(const Allocator* allocator);
+uint64_t SortedArrayInsert(SortedArray* sortedArray, const uint64_t key);
+void SortedArrayBuild(SortedArray* sortedArray, const uint64_t keys[], const uint64_t numKeys);
+bool SortedArrayRemove(SortedArray* sortedArray, const uint64_t key);
+bool SortedArrayContains(const SortedArray* sortedArray, const uint64_t key);
+uint64_t SortedArrayLowerBound(const SortedArray* sortedArray, const uint64_t key);
+uint64_t SortedArrayUpperBound(const SortedArray* sortedArray, const uint64_t key);
+uint64_t SortedArrayGet(const SortedArray* sortedArray, const uint64_t index);
+void SortedArrayClear(SortedArray* sortedArray);
+void SortedArrayFree(SortedArray* sortedArray);
+
+uint64_t SortedArrayNum(const SortedArray* sortedArray);
+
+#endif
\ No newline at end of file
@@ -1,11 +1,20 @@
 #ifndef COMPONENT_H
 #define COMPONENT_H
 
+#include "../Containers/Index.h"
+#include "../Utils/Hash.h"
+
 #include <stdint.h>
 
 typedef uint64_t ComponentTypeID;
-typedef uint64_t ComponentInstanceID;
+typedef Index ComponentInstanceID;
 
 typedef struct Component Component;
 
+/**
+ * @brief The ID of a component type, computed at compile time from the name of the type. This equals the ID ECSRegisterComponent computes from the same name at runtime.
+ * @param componentType The component type, e.g. Transform.
+ */
+#define COMPONENT_TYPE_ID(componentType) ((ComponentTypeID) HASH_FNV1A64_LITERAL(#componentType))
+
 #endif
\ No newline at end of file
@@ -6,10 +6,14 @@
 #include "Entity.h"
 
 #include <stdint.h>
+#include <stdbool.h>
+
+#include "../Utils/Allocator.h"
 
 typedef struct ECS ECS;
 
 ECS* ECSNew();
+ECS* ECSNewWithAllocator(const Allocator* allocator);
 void ECSFree(ECS* ecs);
 
 //-------------------------------------------
@@ -17,14 +21,25 @@ void ECSFree(ECS* ecs);
 // void ECSAddEntity(Entity* e);
 
 ComponentTypeID ECSRegisterComponent(ECS* ecs, char* componentName, size_t componentNameSize, size_t componentSize);
+ComponentTypeID ECSRegisterComponentAligned(ECS* ecs, char* componentName, size_t componentNameSize, size_t componentSize, size_t componentAlignment);
+ComponentTypeID ECSRegisterComponentWithID(ECS* ecs, ComponentTypeID componentTypeID, size_t componentSize, size_t componentAlignment);
+
+/**
+ * @brief Register a component type by its type name. The name, its length, the component's size and its alignment are all derived from the type, and its ID is computed at compile time.
+ * @param ecs The ECS to register the component type to.
+ * @param componentType The component type, e.g. Transform.
+ */
+#define ECS_REGISTER_COMPONENT(ecs, componentType) ECSRegisterComponentWithID(ecs, COMPONENT_TYPE_ID(componentType), sizeof(componentType), _Alignof(componentType))
 ComponentInstanceID ECSAddComponent(ECS* ecs, ComponentTypeID componentTypeID, void* component, Entity entity, Scene* scene);
 ComponentTypeID ECSGetComponentTypeID(ECS* ecs, char* componentName);
 
-void ECSRegisterSystem(ECS* ecs, System* system);
+bool ECSRegisterSystem(ECS* ecs, System* system);
 // void ECSAddSystem(char* systemName, uint64_t entityId); // SHOULD GO AWAY
 
 Entity ECSAddEntity(ECS* ecs, Scene* sceneToAddEntityTo);
+void ECSAddEntities(ECS* ecs, Scene* sceneToAddEntitiesTo, Entity newEntities[], const Index numEntities);
 
 void ECSUpdate();
+uint64_t ECSCompact(ECS* ecs, Scene* scene, const uint64_t maxSteps, const bool reorderComponents, bool* isCompact);
 
 #endif
\ No newline at end of file
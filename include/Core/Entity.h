@@ -2,6 +2,8 @@
 #define ENTITY_H
 
 #include <math.h>
+#include "../Containers/Index.h"
+
 #include <stdint.h>
 
 // const uint8_t MAX_COMPONENT_TYPES = 64;
@@ -11,9 +13,9 @@
 // const int SYSTEM_BITFIELD_SIZE = (int) (MAX_SYSTEM_TYPES / 8) + ((MAX_SYSTEM_TYPES % 8 > 0) ? 1 : 0);
 
 // typedef uint64_t EntityID;
-typedef uint64_t Entity;
+typedef Index Entity;
 
-uint64_t EntityGetID(const void* entity);
+Index EntityGetID(const void* entity);
 
 // struct Entity
 // {
@@ -1,11 +1,14 @@
 #ifndef SCENE_H
 #define SCENE_H
 
+#include "../Utils/Allocator.h"
+
 // Entity nextEntityID;
 
 typedef struct Scene Scene;
 
 Scene* SceneNew();
+Scene* SceneNewWithAllocator(const Allocator* allocator);
 void SceneFree(Scene* scene);
 
 // Entity SceneAddEntity(Scene* scene);
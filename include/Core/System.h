@@ -5,9 +5,26 @@
 
 #include <stddef.h>
 
+#include "../Utils/Allocator.h"
+
 typedef struct System System;
+typedef uint64_t SystemTypeID;
 
 System* SystemNew(const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []));
+System* SystemNewWithAllocator(const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator);
+System* SystemNewWithID(const SystemTypeID systemID, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator);
 void SystemFree(System* system);
 
+/**
+ * @brief The ID of a system, computed at compile time from its name. This equals the ID SystemNew computes from the same name at runtime.
+ * @param systemName The name of the system, as a string literal.
+ */
+#define SYSTEM_TYPE_ID(systemName) ((SystemTypeID) HASH_FNV1A64_LITERAL(systemName))
+
+/**
+ * @brief Create a new system, named by a string literal. The length of the name is derived from the literal, and the system's ID is computed at compile time.
+ * @param systemName The name of the system, as a string literal.
+ */
+#define SYSTEM_NEW(systemName, componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction) SystemNewWithID(SYSTEM_TYPE_ID(systemName), componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction, NULL)
+
 #endif
\ No newline at end of file
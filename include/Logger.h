@@ -3,22 +3,158 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define LOG_SITE_MAX_ARGUMENTS 16
+
+// The levels are plain numbers instead of an enum, so LOG_MIN_LEVEL can be compared against them by the preprocessor.
+#define LOG_LEVEL_INFO 0
+#define LOG_LEVEL_WARNING 1
+#define LOG_LEVEL_ERROR 2
+#define LOG_LEVEL_ASSERT 3
+#define LOG_LEVEL_NONE 4
+
+typedef uint8_t LogLevel;
+
+// Info and warnings below this level are compiled out. Errors and asserts are always compiled in, in debug builds.
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+/**
+ * @brief The parts of the library that can be given their own log level at runtime. A source file picks its module by defining LOG_MODULE before including any header. Files that don't, log as LOG_MODULE_DEFAULT.
+ */
+typedef enum LogModule
+{
+    LOG_MODULE_DEFAULT,
+    LOG_MODULE_CONTAINERS,
+    LOG_MODULE_ECS,
+    LOG_MODULE_UTILS,
+    LOG_NUM_MODULES
+} LogModule;
+
+#ifndef LOG_MODULE
+#define LOG_MODULE LOG_MODULE_DEFAULT
+#endif
+
+/**
+ * @brief The state of a rate limited call site, packing the second of its current window in the upper 32 bits, and the number of messages logged in that window in the lower 32 bits.
+ */
+typedef _Atomic(uint64_t) LogRateLimit;
+
+/**
+ * @brief What a thread does when it logs a message while its ring buffer is full.
+ */
+typedef enum LogFullPolicy
+{
+    LOG_FULL_POLICY_DROP,   // Drop the message, and count it. The logger reports the number of dropped messages once there's room again.
+    LOG_FULL_POLICY_BLOCK   // Wait for the flush thread to make room. No messages get lost, but logging threads can be held up by slow output.
+} LogFullPolicy;
+
+/**
+ * @brief The settings of the asynchronous logger.
+ */
+typedef struct LoggerAsyncSettings
+{
+    const char* filePath;               // The file to append the messages to. NULL to write them to stdout.
+    uint32_t ringCapacity;              // The number of messages each logging thread can have waiting to be written. Rounded up to a power of 2.
+    LogFullPolicy fullPolicy;           // What a thread does when it logs a message while its ring is full.
+    uint32_t flushIntervalMilliseconds; // How long the flush thread waits after finding all rings empty.
+} LoggerAsyncSettings;
+
+/**
+ * @brief The static state of a single logging call site, filled in by the logger. The binary logger identifies messages by their site, so it only has to store the arguments of each message.
+ */
+typedef struct LogSite
+{
+    _Atomic(uint32_t) id;                               // 0 until the site first logs a binary message.
+    _Atomic(uint32_t) generation;                       // The binary log the site was last defined in.
+    uint8_t numArguments;
+    uint8_t argumentTypes[LOG_SITE_MAX_ARGUMENTS];      // The types of the arguments, as read from the format string.
+} LogSite;
 
 void _LogAssert(const char* file, const int line, const bool expression, const char* expressionString, ...);
 void _LogError(const char* file, const int line, const char* message, ...);
-void _LogWarning(const char* file, const int line, const char* message, ...);
-void _LogInfo(const char* file, const int line, const char* message, ...);
+void _LogWarning(LogSite* site, const char* file, const int line, const char* message, ...);
+void _LogInfo(LogSite* site, const char* file, const int line, const char* message, ...);
+bool _LogRateLimitAllows(LogRateLimit* rateLimit, const uint32_t maxPerSecond);
+
+extern LogLevel _logModuleLevels[LOG_NUM_MODULES];
+
+void LoggerSetModuleLevel(const LogModule module, const LogLevel minLevel);
+void LoggerSetLevel(const LogLevel minLevel);
+LogLevel LoggerGetModuleLevel(const LogModule module);
+
+LoggerAsyncSettings LoggerAsyncDefaultSettings();
+bool LoggerAsyncStart(const LoggerAsyncSettings* settings);
+void LoggerAsyncStop();
+bool LoggerAsyncIsRunning();
+uint64_t LoggerAsyncNumDropped();
+
+bool LoggerBinaryStart(const char* filePath);
+void LoggerBinaryStop();
+bool LoggerBinaryIsRunning();
+bool LoggerBinaryDecode(const char* binaryFilePath, const char* textFilePath);
+
+bool LoggerRingStart(const char* filePath, const size_t size);
+void LoggerRingStop();
+bool LoggerRingIsRunning();
+bool LoggerRingDecode(const char* ringFilePath, const char* textFilePath);
+
+// Checking wether a level is enabled for the module of the calling file takes a single load and branch.
+#define LOG_IS_ENABLED(level) ((level) >= _logModuleLevels[LOG_MODULE])
+
+#define _LOG_AT_SITE(function, message, ...) do { static LogSite logSite = { 0 }; function(&logSite, __FILE__, __LINE__, message, ## __VA_ARGS__); } while(0)
+
+// Log only every nth call of the call site, counting the calls made while the level is enabled.
+#define _LOG_EVERY_N(function, level, n, message, ...)                                                  \
+    do                                                                                                  \
+    {                                                                                                   \
+        static atomic_uint_fast32_t logNumCalls = 0;                                                    \
+        if(LOG_IS_ENABLED(level) && atomic_fetch_add_explicit(&logNumCalls, 1, memory_order_relaxed) % (n) == 0) \
+        {                                                                                               \
+            _LOG_AT_SITE(function, message, ## __VA_ARGS__);                                            \
+        }                                                                                               \
+    } while(0)
+
+// Log at most maxPerSecond messages per second from the call site, dropping the rest.
+#define _LOG_RATE_LIMITED(function, level, maxPerSecond, message, ...)                                  \
+    do                                                                                                  \
+    {                                                                                                   \
+        static LogRateLimit logRateLimit = 0;                                                           \
+        if(LOG_IS_ENABLED(level) && _LogRateLimitAllows(&logRateLimit, (maxPerSecond)))                 \
+        {                                                                                               \
+            _LOG_AT_SITE(function, message, ## __VA_ARGS__);                                            \
+        }                                                                                               \
+    } while(0)
 
 #ifdef DEBUG
 #define LogAssert(expression, ...) _LogAssert(__FILE__, __LINE__, expression, #expression, ## __VA_ARGS__, NULL)
 #define LogError(message, ...) _LogError(__FILE__, __LINE__, message, ## __VA_ARGS__)
-#define LogWarning(message, ...) _LogWarning(__FILE__, __LINE__, message, ## __VA_ARGS__)
-#define LogInfo(message, ...) _LogInfo(__FILE__, __LINE__, message, ## __VA_ARGS__)
 #else
 #define LogAssert(expression, ...)
 #define LogError(message, ...)
+#endif
+
+#if defined(DEBUG) && LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+#define LogWarning(message, ...) do { if(LOG_IS_ENABLED(LOG_LEVEL_WARNING)) _LOG_AT_SITE(_LogWarning, message, ## __VA_ARGS__); } while(0)
+#define LogWarningEveryN(n, message, ...) _LOG_EVERY_N(_LogWarning, LOG_LEVEL_WARNING, n, message, ## __VA_ARGS__)
+#define LogWarningRateLimited(maxPerSecond, message, ...) _LOG_RATE_LIMITED(_LogWarning, LOG_LEVEL_WARNING, maxPerSecond, message, ## __VA_ARGS__)
+#else
 #define LogWarning(message, ...)
+#define LogWarningEveryN(n, message, ...)
+#define LogWarningRateLimited(maxPerSecond, message, ...)
+#endif
+
+#if defined(DEBUG) && LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LogInfo(message, ...) do { if(LOG_IS_ENABLED(LOG_LEVEL_INFO)) _LOG_AT_SITE(_LogInfo, message, ## __VA_ARGS__); } while(0)
+#define LogInfoEveryN(n, message, ...) _LOG_EVERY_N(_LogInfo, LOG_LEVEL_INFO, n, message, ## __VA_ARGS__)
+#define LogInfoRateLimited(maxPerSecond, message, ...) _LOG_RATE_LIMITED(_LogInfo, LOG_LEVEL_INFO, maxPerSecond, message, ## __VA_ARGS__)
+#else
 #define LogInfo(message, ...)
+#define LogInfoEveryN(n, message, ...)
+#define LogInfoRateLimited(maxPerSecond, message, ...)
 #endif
 
 #endif
\ No newline at end of file
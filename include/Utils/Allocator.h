@@ -0,0 +1,28 @@
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <stddef.h>
+
+#define ALLOCATOR_DEFAULT_ALIGNMENT 16
+
+/**
+ * @brief A set of functions, used by the containers and the ECS to manage their memory. A container passes its allocator on to the containers it owns, so arenas, pools or tracking allocators can be plugged in per ECS or per scene.
+ */
+typedef struct Allocator
+{
+    void* (*allocFunc)(void* userData, const size_t size);                                          // Allocate a block of memory, aligned to at least ALLOCATOR_DEFAULT_ALIGNMENT bytes. Returns NULL on failure.
+    void* (*reallocFunc)(void* userData, void* memory, const size_t prevSize, const size_t newSize); // Resize a block of memory, preserving its content. Returns NULL on failure.
+    void (*freeFunc)(void* userData, void* memory, const size_t size);                              // Free a block of memory, previously returned by allocFunc or reallocFunc.
+    void* userData;                                                                                 // Passed to every function, e.g. the arena or pool to allocate from.
+} Allocator;
+
+const Allocator* AllocatorGetDefault();
+void* AllocatorAlloc(const Allocator* allocator, const size_t size);
+void* AllocatorCalloc(const Allocator* allocator, const size_t num, const size_t size);
+void* AllocatorRealloc(const Allocator* allocator, void* memory, const size_t prevSize, const size_t newSize);
+void AllocatorFree(const Allocator* allocator, void* memory, const size_t size);
+void* AllocatorAllocAligned(const Allocator* allocator, const size_t size, const size_t alignment);
+void* AllocatorReallocAligned(const Allocator* allocator, void* memory, const size_t prevSize, const size_t newSize, const size_t alignment);
+void AllocatorFreeAligned(const Allocator* allocator, void* memory, const size_t size, const size_t alignment);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "Allocator.h"
+
+/**
+ * @brief A linear allocator, which hands out memory by bumping a pointer through a reserved range of address space. Memory is not freed individually, but all at once by resetting or rewinding the arena.
+ */
+typedef struct Arena Arena;
+
+Arena* ArenaNew(const size_t maxSize);
+void* ArenaAlloc(Arena* arena, const size_t size);
+size_t ArenaMark(const Arena* arena);
+void ArenaRewind(Arena* arena, const size_t mark);
+void ArenaReset(Arena* arena);
+const Allocator* ArenaGetAllocator(Arena* arena);
+void ArenaFree(Arena* arena);
+
+size_t ArenaNumBytesUsed(const Arena* arena);
+
+Arena* ArenaGetFrame();
+void ArenaFreeFrame();
+
+#endif
\ No newline at end of file
@@ -0,0 +1,21 @@
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CLOCK_WALL_STRING_SIZE 32
+
+uint64_t ClockMonotonicNanoseconds();
+uint64_t ClockWallNanoseconds();
+
+uint64_t ClockTicks();
+void ClockCalibrate();
+double ClockNanosecondsPerTick();
+uint64_t ClockTicksToNanoseconds(const uint64_t ticks);
+uint64_t ClockTicksToWallNanoseconds(const uint64_t ticks);
+
+const char* ClockWallString();
+void ClockFormatWallTime(const uint64_t wallNanoseconds, char* buffer, const size_t bufferSize);
+
+#endif
\ No newline at end of file
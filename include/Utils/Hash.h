@@ -4,6 +4,34 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/**
+ * @brief A function computing a 64 bit hash from a block of data, e.g. to pick the hash function of a dictionary.
+ */
+typedef uint64_t (*HashFunction)(const void* data, const size_t dataSize);
+
 uint64_t HashFNV1a64(const void* data, const size_t dataSize);
+uint64_t HashFast64(const void* data, const size_t dataSize);
+uint64_t HashInteger(const void* data, const size_t dataSize);
+uint64_t HashU64(const uint64_t key);
+
+#define HASH_FNV1A64_OFFSET 14695981039346656037ULL
+#define HASH_FNV1A64_PRIME 1099511628211ULL
+#define HASH_FNV1A64_LITERAL_MAX_LENGTH 64
+
+/**
+ * @brief Compute the FNV-1a hash of a string literal at compile time. The result equals HashFNV1a64(literal, sizeof(literal) - 1), but is folded into a constant by the compiler, even without optimizations, so it can initialize static tables and costs nothing at startup.
+ * Every character past the end of the literal hashes as a multiplication by 1, which leaves the hash unchanged. The hash is only referenced once per step, so the expansion grows linearly with the maximum length.
+ * C doesn't allow indexing a string literal in an integer constant expression, so the result can't be used as a case label or enum value.
+ * @param literal The string literal to hash. This can be at most HASH_FNV1A64_LITERAL_MAX_LENGTH characters long, or the compilation fails.
+ */
+#define HASH_FNV1A64_LITERAL(literal) \
+    (HASH_FNV1A64_STEP_64(HASH_FNV1A64_OFFSET, literal, 0) + 0 * sizeof(char[sizeof(literal) <= HASH_FNV1A64_LITERAL_MAX_LENGTH + 1 ? 1 : -1]))
+
+#define HASH_FNV1A64_CHAR(literal, i) ((uint64_t) (uint8_t) ((i) < sizeof(literal) - 1 ? (literal)[(i) < sizeof(literal) ? (i) : 0] : 0))
+#define HASH_FNV1A64_FACTOR(literal, i) ((i) < sizeof(literal) - 1 ? HASH_FNV1A64_PRIME : 1ULL)
+#define HASH_FNV1A64_STEP(hash, literal, i) (((hash) ^ HASH_FNV1A64_CHAR(literal, i)) * HASH_FNV1A64_FACTOR(literal, i))
+#define HASH_FNV1A64_STEP_4(hash, literal, i) HASH_FNV1A64_STEP(HASH_FNV1A64_STEP(HASH_FNV1A64_STEP(HASH_FNV1A64_STEP(hash, literal, i), literal, (i) + 1), literal, (i) + 2), literal, (i) + 3)
+#define HASH_FNV1A64_STEP_16(hash, literal, i) HASH_FNV1A64_STEP_4(HASH_FNV1A64_STEP_4(HASH_FNV1A64_STEP_4(HASH_FNV1A64_STEP_4(hash, literal, i), literal, (i) + 4), literal, (i) + 8), literal, (i) + 12)
+#define HASH_FNV1A64_STEP_64(hash, literal, i) HASH_FNV1A64_STEP_16(HASH_FNV1A64_STEP_16(HASH_FNV1A64_STEP_16(HASH_FNV1A64_STEP_16(hash, literal, i), literal, (i) + 16), literal, (i) + 32), literal, (i) + 48)
 
 #endif
\ No newline at end of file
@@ -0,0 +1,45 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief A zone that is being timed. It's kept by the code being profiled, and only recorded once the zone ends.
+ */
+typedef struct ProfilerZone
+{
+    const char* name;       // Has to outlive the profile, like a string literal.
+    uint64_t id;            // Shown after the name when not 0, like the ID of a system.
+    uint64_t startTicks;    // 0 when the profiler was not running as the zone began.
+} ProfilerZone;
+
+bool ProfilerStart(const uint32_t zonesPerThread);
+void ProfilerStop();
+bool ProfilerIsRunning();
+void ProfilerReset();
+uint64_t ProfilerNumZones();
+uint64_t ProfilerNumDropped();
+bool ProfilerExportChromeTrace(const char* filePath);
+
+ProfilerZone ProfilerZoneBegin(const char* name, const uint64_t id);
+void ProfilerZoneEnd(const ProfilerZone* zone, const uint64_t numEntities);
+
+#ifdef PROFILE
+#define PROFILE_ZONE_BEGIN(zone, name, id) ProfilerZone zone = ProfilerZoneBegin(name, id)
+#define PROFILE_ZONE_END(zone, numEntities) ProfilerZoneEnd(&(zone), numEntities)
+#else
+#define PROFILE_ZONE_BEGIN(zone, name, id)
+#define PROFILE_ZONE_END(zone, numEntities)
+#endif
+
+// Zones around small pieces of work, like a single batch of entities, are only profiled when PROFILE_BATCHES is defined as well, since they make up most of the recorded zones.
+#if defined(PROFILE) && defined(PROFILE_BATCHES)
+#define PROFILE_BATCH_ZONE_BEGIN(zone, name, id) PROFILE_ZONE_BEGIN(zone, name, id)
+#define PROFILE_BATCH_ZONE_END(zone, numEntities) PROFILE_ZONE_END(zone, numEntities)
+#else
+#define PROFILE_BATCH_ZONE_BEGIN(zone, name, id)
+#define PROFILE_BATCH_ZONE_END(zone, numEntities)
+#endif
+
+#endif
\ No newline at end of file
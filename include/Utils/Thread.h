@@ -0,0 +1,24 @@
+#ifndef THREAD_H
+#define THREAD_H
+
+#include <stdint.h>
+
+/**
+ * @brief A thread of execution, running a single function.
+ */
+typedef struct Thread Thread;
+
+/**
+ * @brief The function a thread runs.
+ * @param argument The argument the thread was created with.
+ */
+typedef void (*ThreadFunction)(void* argument);
+
+Thread* ThreadNew(ThreadFunction function, void* argument);
+void ThreadJoin(Thread* thread);
+
+void ThreadSleep(const uint32_t milliseconds);
+void ThreadYield();
+uint32_t ThreadGetID();
+
+#endif
\ No newline at end of file
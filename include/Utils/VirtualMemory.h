@@ -0,0 +1,17 @@
+#ifndef VIRTUAL_MEMORY_H
+#define VIRTUAL_MEMORY_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+size_t VirtualMemoryPageSize();
+size_t VirtualMemoryRoundToPageSize(const size_t size);
+void* VirtualMemoryReserve(const size_t size);
+bool VirtualMemoryCommit(void* address, const size_t size);
+void VirtualMemoryDecommit(void* address, const size_t size);
+void VirtualMemoryRelease(void* address, const size_t size);
+void VirtualMemoryAdviseHugePages(void* address, const size_t size);
+void* VirtualMemoryMapFile(const char* filePath, const size_t size);
+void VirtualMemoryUnmapFile(void* address, const size_t size);
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "Array.h"
 
 #include "Math/Math.h"
+#include "Utils/VirtualMemory.h"
 #include "Logger.h"
 
 #include <stdio.h>
@@ -17,15 +18,58 @@ static const int INITIAL_CAPACITY = 16;
  * @return Array* A pointer to the newly created array.
  */
 Array* ArrayNew(size_t elementSize)
+{
+    return ArrayNewWithAllocator(elementSize, NULL);
+}
+
+/**
+ * @brief Creates a new array, whose memory is managed by a given allocator, and initializes it.
+ * @param elementSize The memory footprint of 1 element.
+ * @param allocator The allocator to manage the array's memory with. NULL to use the default allocator. This should outlive the array.
+ * @return Array* A pointer to the newly created array.
+ */
+Array* ArrayNewWithAllocator(size_t elementSize, const Allocator* allocator)
+{
+    return ArrayNewAligned(elementSize, 0, allocator);
+}
+
+/**
+ * @brief Creates a new array, whose elements start at a given alignment, and initializes it. Use this for elements processed with aligned SIMD loads.
+ * @param elementSize The memory footprint of 1 element.
+ * @param alignment The alignment of the elements in bytes, e.g. 32 for AVX or 64 for a cache line. This has to be a power of 2. 0 for the allocator's default alignment.
+ * @param allocator The allocator to manage the array's memory with. NULL to use the default allocator. This should outlive the array.
+ * @return Array* A pointer to the newly created array.
+ */
+Array* ArrayNewAligned(size_t elementSize, const size_t alignment, const Allocator* allocator)
 {
     LogAssert(elementSize > 0);
 
-    Array* newArray = (Array*) malloc(sizeof(Array));
+    Array* newArray = (Array*) AllocatorAlloc(allocator, sizeof(Array));
 
+    LogAssert(newArray != NULL);
+
+    ArrayInit(newArray, elementSize, INITIAL_CAPACITY, alignment, allocator);
+
+    return newArray;
+}
+
+/**
+ * @brief Creates a new array in a reserved range of address space, and initializes it. Memory gets committed as the array grows, so the elements stay contiguous while pointers to them never become corrupt.
+ * @param elementSize The memory footprint of 1 element.
+ * @param maxCapacity The maximum number of elements the array will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the array with transparent huge pages.
+ * @return Array* A pointer to the newly created array.
+ */
+Array* ArrayNewReserved(size_t elementSize, const uint64_t maxCapacity, const bool useHugePages)
+{
     LogAssert(elementSize > 0);
+    LogAssert(maxCapacity > 0);
+
+    Array* newArray = (Array*) AllocatorAlloc(NULL, sizeof(Array));
+
     LogAssert(newArray != NULL);
 
-    ArrayInit(newArray, elementSize, INITIAL_CAPACITY);
+    ArrayInitReserved(newArray, elementSize, maxCapacity, useHugePages);
 
     return newArray;
 }
@@ -34,21 +78,16 @@ Array* ArrayNew(size_t elementSize)
  * @brief Add a new element to the back of the array. If this causes the array to resize, old pointers to elements might become corrupt.
  * @param array The array to add the element to.
  * @param newElement A pointer to the data to add.
- * @return void* A pointer to the new element in the array.
+ * @return void* A pointer to the new element in the array. NULL if the array could not grow.
  */
 void* ArrayAdd(Array* array, const void* newElement)
 {
     LogAssert(array != NULL);
     LogAssert(newElement != NULL);
 
-    if(array->capacity <= array->num)   // INCREASE CAPACITY
+    if(array->capacity <= array->num && !ArrayGrow(array))   // INCREASE CAPACITY
     {
-        int newCapacity = 1;
-        if(array->capacity > 0)
-        {
-            newCapacity = (int) round((float) array->capacity * GOLDEN_RATIO);
-        }
-        ArrayResize(array, newCapacity);
+        return NULL;
     }
 
     void* locationToSet = array->elements + ((size_t) array->num * array->elementSize);
@@ -59,6 +98,107 @@ void* ArrayAdd(Array* array, const void* newElement)
     return result;
 }
 
+/**
+ * @brief Add a range of elements to the back of the array, with a single capacity check and a single copy. If this causes the array to resize, old pointers to elements might become corrupt.
+ * @param array The array to add the elements to.
+ * @param newElements A pointer to the first of the contiguous elements to add.
+ * @param numElements The number of elements to add.
+ * @return void* A pointer to the first new element in the array. NULL if the array could not grow.
+ */
+void* ArrayAppend(Array* array, const void* newElements, const uint64_t numElements)
+{
+    LogAssert(array != NULL);
+    LogAssert(newElements != NULL || numElements == 0);
+
+    if(!ArrayReserve(array, array->num + numElements))
+    {
+        return NULL;
+    }
+
+    void* locationToSet = array->elements + ((size_t) array->num * array->elementSize);
+    memcpy(locationToSet, newElements, (size_t) numElements * array->elementSize);
+
+    array->num += numElements;
+
+    return locationToSet;
+}
+
+/**
+ * @brief Insert a range of elements at a given index. The elements from that index onwards get moved back in a single move. If this causes the array to resize, old pointers to elements might become corrupt.
+ * @param array The array to insert the elements into.
+ * @param index The index the first new element will end up at. This can be the number of elements, to add to the back.
+ * @param newElements A pointer to the first of the contiguous elements to insert.
+ * @param numElements The number of elements to insert.
+ * @return void* A pointer to the first inserted element in the array. NULL if the array could not grow.
+ */
+void* ArrayInsert(Array* array, const uint64_t index, const void* newElements, const uint64_t numElements)
+{
+    LogAssert(array != NULL);
+    LogAssert(newElements != NULL || numElements == 0);
+    LogAssert(index <= array->num);
+
+    if(!ArrayReserve(array, array->num + numElements))
+    {
+        return NULL;
+    }
+
+    void* locationToSet = array->elements + ((size_t) index * array->elementSize);
+    memmove(locationToSet + ((size_t) numElements * array->elementSize), locationToSet, (size_t) (array->num - index) * array->elementSize);
+    memcpy(locationToSet, newElements, (size_t) numElements * array->elementSize);
+
+    array->num += numElements;
+
+    return locationToSet;
+}
+
+/**
+ * @brief Remove a range of elements, keeping the order of the remaining elements. The elements after the range get moved forward in a single move.
+ * @param array The array to remove the elements from.
+ * @param index The index of the first element to remove.
+ * @param numElements The number of elements to remove.
+ */
+void ArrayErase(Array* array, const uint64_t index, const uint64_t numElements)
+{
+    LogAssert(array != NULL);
+    LogAssert(index + numElements <= array->num);
+
+    void* firstElement = array->elements + ((size_t) index * array->elementSize);
+    size_t numBytesToMove = (size_t) (array->num - index - numElements) * array->elementSize;
+    memmove(firstElement, firstElement + ((size_t) numElements * array->elementSize), numBytesToMove);
+    memset(firstElement + numBytesToMove, 0, (size_t) numElements * array->elementSize);
+
+    array->num -= numElements;
+}
+
+/**
+ * @brief Remove an element by moving the last element into its place. This doesn't keep the order of the elements, but only copies a single element.
+ * @param array The array to remove the element from.
+ * @param index The index of the element to remove.
+ * @param removedElement Pointer to retrieving data, to get a copy of the element that was removed. This can be left to NULL if no returned value is requested.
+ */
+void ArraySwapRemove(Array* array, const uint64_t index, void* removedElement)
+{
+    LogAssert(array != NULL);
+    LogAssert(index < array->num);
+
+    void* element = ArrayGetFast(array, index);
+    void* lastElement = ArrayGetFast(array, array->num - 1);
+
+    if(removedElement != NULL)
+    {
+        memcpy(removedElement, element, array->elementSize);
+    }
+
+    if(element != lastElement)
+    {
+        memcpy(element, lastElement, array->elementSize);
+    }
+
+    memset(lastElement, 0, array->elementSize);
+
+    array->num--;
+}
+
 /**
  * @brief Remove the last element of the array.
  * @param  array: The array to remove from.
@@ -69,7 +209,7 @@ void ArrayPopBack(Array* array, void* poppedElement)
     LogAssert(array != NULL);
     LogAssert(array->num > 0);
 
-    void* lastElement = ArrayGet(array, array->num - 1);
+    void* lastElement = ArrayGetFast(array, array->num - 1);
 
     if(poppedElement != NULL)
     {
@@ -93,30 +233,88 @@ void* ArrayGet(const Array* array, const uint64_t index)
     LogAssert(array != NULL);
     LogAssert(index < array->num);
 
-    return (void*) array->elements + ((index) * array->elementSize);
+    return ArrayGetFast(array, index);
 }
 
 /**
  * @brief Resize the array. If the new size is smaller than the previous size, the excess elements will be discarded. If the new size is bigger than the previous size, old pointers to elements might become corrupt.
  * @param array The array to resize.
  * @param newCapacity The new number of elements the array can occupy before having to allocate more memory.
+ * @return bool Wether or not the array was resized. If not, because its memory could not be allocated or committed, the array is left unchanged.
  */
-void ArrayResize(Array* array, const uint64_t newCapacity)
+bool ArrayResize(Array* array, const uint64_t newCapacity)
 {
     LogAssert(array != NULL);
 
     if(newCapacity == array->capacity)
     {
-        return;
+        return true;
+    }
+
+    if(array->maxCapacity > 0)
+    {
+        LogAssert(newCapacity <= array->maxCapacity, "Reserved array can't grow beyond %llu elements.", (unsigned long long) array->maxCapacity);
+
+        size_t committedSize = VirtualMemoryRoundToPageSize(array->elementSize * (size_t) array->capacity);
+        size_t newCommittedSize = VirtualMemoryRoundToPageSize(array->elementSize * (size_t) newCapacity);
+
+        if(newCommittedSize > committedSize)
+        {
+            if(!VirtualMemoryCommit(array->elements + committedSize, newCommittedSize - committedSize))
+            {
+                return false;
+            }
+        }
+        else if(newCommittedSize < committedSize)
+        {
+            VirtualMemoryDecommit(array->elements + newCommittedSize, committedSize - newCommittedSize);
+        }
+    }
+    else
+    {
+        void* newElements = AllocatorReallocAligned(array->allocator, array->elements, array->elementSize * (size_t) array->capacity, array->elementSize * (size_t) newCapacity, array->alignment);
+
+        if(newElements == NULL && newCapacity > 0)
+        {
+            return false;
+        }
+
+        array->elements = newElements;
     }
 
-    array->elements = realloc(array->elements, array->elementSize * (size_t) newCapacity);
     array->capacity = newCapacity;
     array->num = fmin(array->num, newCapacity);
+    return true;
+}
+
+/**
+ * @brief Make sure the array can hold a given number of elements without having to allocate more memory. The capacity grows by at least the golden ratio, so reserving a little more at a time stays amortized. Old pointers to elements might become corrupt.
+ * @param array The array to reserve memory for.
+ * @param minCapacity The number of elements the array should be able to hold.
+ * @return bool Wether or not the array can hold the given number of elements.
+ */
+bool ArrayReserve(Array* array, const uint64_t minCapacity)
+{
+    LogAssert(array != NULL);
+
+    if(minCapacity <= array->capacity)
+    {
+        return true;
+    }
+
+    uint64_t newCapacity = fmax(round((float) array->capacity * GOLDEN_RATIO), minCapacity);
+
+    if(array->maxCapacity > 0)
+    {
+        LogAssert(minCapacity <= array->maxCapacity, "Reserved array can't grow beyond %llu elements.", (unsigned long long) array->maxCapacity);
+        newCapacity = fmin(newCapacity, array->maxCapacity);
+    }
+
+    return ArrayResize(array, newCapacity);
 }
 
 /**
- * @brief Fill the whole array with values until its capacity is reached. This will override values already present in the array.
+ * @brief Fill the whole array with values until its capacity is reached. This will override values already present in the array. The filled part gets doubled with every copy, so this takes a logarithmic number of copies.
  * @param array The array to fill.
  * @param value The value to fill the array with.
  */
@@ -125,9 +323,20 @@ void ArrayFill(Array* array, void* value)
     LogAssert(array != NULL);
     LogAssert(value != NULL);
 
-    for(int i = 0; i < array->capacity; ++i)
+    if(array->capacity == 0)
     {
-        memcpy(array->elements + (i * array->elementSize), value, array->elementSize);
+        return;
+    }
+
+    size_t filledSize = array->elementSize;
+    size_t totalSize = (size_t) array->capacity * array->elementSize;
+    memcpy(array->elements, value, array->elementSize);
+
+    while(filledSize < totalSize)
+    {
+        size_t copySize = fmin(filledSize, totalSize - filledSize);
+        memcpy(array->elements + filledSize, array->elements, copySize);
+        filledSize += copySize;
     }
 
     array->num = array->capacity;
@@ -149,7 +358,7 @@ bool ArrayContains(Array* array, void* element)
 {
     for(int i = 0; i < ArrayNum(array); ++i)
     {
-        if(memcmp(ArrayGet(array, i), element, array->elementSize) == 0)
+        if(memcmp(ArrayGetFast(array, i), element, array->elementSize) == 0)
         {
             return true;
         }
@@ -166,8 +375,10 @@ void ArrayFree(Array* array)
 {
     LogAssert(array != NULL);
 
+    const Allocator* allocator = array->allocator;
+
     ArrayDeinit(array);
-    free(array);
+    AllocatorFree(allocator, array, sizeof(Array));
 }
 
 /**
@@ -199,8 +410,10 @@ uint64_t ArrayCapacity(const Array* array)
  * @param array The array to be initialized.
  * @param elementSize The memory footprint of 1 element.
  * @param initialCapacity The initial element capacity to reserve.
+ * @param alignment The alignment of the elements in bytes. This has to be a power of 2. 0 for the allocator's default alignment.
+ * @param allocator The allocator to manage the array's memory with. NULL to use the default allocator.
  */
-void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity)
+void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity, const size_t alignment, const Allocator* allocator)
 {
     LogAssert(array != NULL);
     LogAssert(elementSize > 0);
@@ -208,7 +421,53 @@ void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity)
     array->num = 0;
     array->capacity = initialCapacity;
     array->elementSize = elementSize;
-    array->elements = calloc(initialCapacity, elementSize);
+    array->elements = AllocatorAllocAligned(allocator, elementSize * (size_t) initialCapacity, alignment);
+    array->maxCapacity = 0;
+    array->alignment = alignment;
+    array->allocator = allocator;
+
+    memset(array->elements, 0, elementSize * (size_t) initialCapacity);
+}
+
+/**
+ * @brief Initialize an existing array in a reserved range of address space. Only used internally. When calling ArrayNewReserved, the array will already be initialized.
+ * @param array The array to be initialized.
+ * @param elementSize The memory footprint of 1 element.
+ * @param maxCapacity The maximum number of elements the array will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the array with transparent huge pages.
+ */
+void ArrayInitReserved(Array* array, size_t elementSize, const uint64_t maxCapacity, const bool useHugePages)
+{
+    LogAssert(array != NULL);
+    LogAssert(elementSize > 0);
+    LogAssert(maxCapacity > 0);
+
+    array->num = 0;
+    array->capacity = 0;
+    array->elementSize = elementSize;
+    array->elements = VirtualMemoryReserve(elementSize * (size_t) maxCapacity);
+    array->maxCapacity = maxCapacity;
+    array->alignment = VirtualMemoryPageSize();
+    array->allocator = NULL;
+
+    LogAssert(array->elements != NULL);
+
+    if(useHugePages)
+    {
+        VirtualMemoryAdviseHugePages(array->elements, elementSize * (size_t) maxCapacity);
+    }
+}
+
+/**
+ * @brief Increase the capacity of the array by the golden ratio, to make room for at least 1 more element. Old pointers to elements might become corrupt.
+ * @param array The array to grow.
+ * @return bool Wether or not the array grew.
+ */
+bool ArrayGrow(Array* array)
+{
+    LogAssert(array != NULL);
+
+    return ArrayReserve(array, array->capacity + 1);
 }
 
 /**
@@ -218,5 +477,12 @@ void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity)
 void ArrayDeinit(Array* array)
 {
     LogAssert(array != NULL);
-    free(array->elements);
+
+    if(array->maxCapacity > 0)
+    {
+        VirtualMemoryRelease(array->elements, array->elementSize * (size_t) array->maxCapacity);
+        return;
+    }
+
+    AllocatorFreeAligned(array->allocator, array->elements, array->elementSize * (size_t) array->capacity, array->alignment);
 }
\ No newline at end of file
@@ -3,18 +3,94 @@
 
 #include "../../include/Containers/Array.h"
 
+#include "Utils/Allocator.h"
+#include "Logger.h"
+
 /**
  * @brief A dynamic array, that dynamically expands its memory footprint when necessary.
  */
 struct Array
 {
-    uint64_t num;           // The number of occupied elements in the array.
-    uint64_t capacity;      // The maximum number of occupied elements before the array has to allocate more memory.
-    size_t elementSize;     // The memory footprint of 1 element.
-    void* elements;         // A pointer to the elements allocated in memory.
+    uint64_t num;                 // The number of occupied elements in the array.
+    uint64_t capacity;            // The maximum number of occupied elements before the array has to allocate more memory.
+    size_t elementSize;           // The memory footprint of 1 element.
+    void* elements;               // A pointer to the elements allocated in memory.
+    uint64_t maxCapacity;         // The number of elements the reserved address space can hold. 0 if the elements are heap allocated.
+    size_t alignment;             // The alignment of the elements in memory. 0 for the allocator's default alignment.
+    const Allocator* allocator;   // The allocator used for the elements. NULL for the default allocator.
 };
 
-void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity);
+void ArrayInit(Array* array, size_t elementSize, const uint64_t initialCapacity, const size_t alignment, const Allocator* allocator);
+void ArrayInitReserved(Array* array, size_t elementSize, const uint64_t maxCapacity, const bool useHugePages);
+bool ArrayGrow(Array* array);
 void ArrayDeinit(Array* array);
 
+/**
+ * @brief Retrieve an element at a specific index. Inlined fast path of ArrayGet, which is only checked in debug builds.
+ * @param array The array to retrieve the element from.
+ * @param index The index at which to find the element
+ * @return void* A pointer to the requested element.
+ */
+static inline void* ArrayGetFast(const Array* array, const uint64_t index)
+{
+    LogAssert(array != NULL);
+    LogAssert(index < array->num);
+
+    return (void*) array->elements + (index * array->elementSize);
+}
+
+/**
+ * @brief Declare an array specialized for element type T, named T##Array. The element size is a compile time constant, so elements are accessed with direct loads and stores instead of runtime multiplications and memcpy. The typed array wraps a generic array, so the generic functions still work on its base member.
+ * @param T The element type. This has to be a single identifier, so typedef pointer and qualified types first.
+ */
+#define DECLARE_ARRAY(T)                                                                                         \
+    typedef struct T##Array                                                                                      \
+    {                                                                                                            \
+        Array base;                                                                                              \
+    } T##Array;                                                                                                  \
+                                                                                                                 \
+    static inline void T##ArrayInit(T##Array* array, const uint64_t initialCapacity, const Allocator* allocator) \
+    {                                                                                                            \
+        ArrayInit(&(array->base), sizeof(T), initialCapacity, 0, allocator);                                     \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline void T##ArrayDeinit(T##Array* array)                                                           \
+    {                                                                                                            \
+        ArrayDeinit(&(array->base));                                                                             \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline T* T##ArrayAdd(T##Array* array, const T newElement)                                            \
+    {                                                                                                            \
+        if(array->base.capacity <= array->base.num && !ArrayGrow(&(array->base)))                                \
+        {                                                                                                        \
+            return NULL;                                                                                         \
+        }                                                                                                        \
+                                                                                                                 \
+        T* location = (T*) array->base.elements + array->base.num++;                                             \
+        *location = newElement;                                                                                  \
+        return location;                                                                                         \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline T T##ArrayPopBack(T##Array* array)                                                             \
+    {                                                                                                            \
+        LogAssert(array->base.num > 0);                                                                          \
+        return ((T*) array->base.elements)[--array->base.num];                                                   \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline T* T##ArrayGet(const T##Array* array, const uint64_t index)                                    \
+    {                                                                                                            \
+        LogAssert(index < array->base.num);                                                                      \
+        return (T*) array->base.elements + index;                                                                \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline T* T##ArrayData(const T##Array* array)                                                         \
+    {                                                                                                            \
+        return (T*) array->base.elements;                                                                        \
+    }                                                                                                            \
+                                                                                                                 \
+    static inline uint64_t T##ArrayNum(const T##Array* array)                                                    \
+    {                                                                                                            \
+        return array->base.num;                                                                                  \
+    }
+
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "BucketArray.h"
 
+#include "Math/Math.h"
+#include "Utils/VirtualMemory.h"
 #include "Logger.h"
 
 #include <assert.h>
@@ -8,6 +10,8 @@
 
 static void* BucketArrayAddBucket(BucketArray* bucketArray);
 static void BucketArrayPopBackBucket(BucketArray* bucketArray);
+static Index BucketArrayNumBucketsForCapacity(const BucketArray* bucketArray, const Index capacity);
+static bool BucketArrayCommitReserved(BucketArray* bucketArray, const Index newCapacity);
 
 /**
  * @brief Creates a new array, and initializes it.
@@ -15,18 +19,82 @@ static void BucketArrayPopBackBucket(BucketArray* bucketArray);
  * @param bucketCapacity The number of elements a bucket can hold.
  * @return Array* A pointer to the newly created bucketArray.
  */
-BucketArray* BucketArrayNew(const size_t elementSize, const uint64_t bucketCapacity)
+BucketArray* BucketArrayNew(const size_t elementSize, const Index bucketCapacity)
+{
+    return BucketArrayNewWithAllocator(elementSize, bucketCapacity, NULL);
+}
+
+/**
+ * @brief Creates a new array, whose memory is managed by a given allocator, and initializes it.
+ * @param elementSize The memory footprint of 1 element.
+ * @param bucketCapacity The number of elements a bucket can hold.
+ * @param allocator The allocator to manage the bucketArray's memory with. NULL to use the default allocator. This should outlive the bucketArray.
+ * @return Array* A pointer to the newly created bucketArray.
+ */
+BucketArray* BucketArrayNewWithAllocator(const size_t elementSize, const Index bucketCapacity, const Allocator* allocator)
+{
+    return BucketArrayNewAligned(elementSize, bucketCapacity, 0, allocator);
+}
+
+/**
+ * @brief Creates a new array, whose buckets start at a given alignment, and initializes it. Aligning to a cache line keeps writers on adjacent buckets from sharing a cache line.
+ * @param elementSize The memory footprint of 1 element.
+ * @param bucketCapacity The number of elements a bucket can hold.
+ * @param alignment The alignment of every bucket in bytes, e.g. 32 for AVX or 64 for a cache line. This has to be a power of 2. 0 for the allocator's default alignment.
+ * @param allocator The allocator to manage the bucketArray's memory with. NULL to use the default allocator. This should outlive the bucketArray.
+ * @return Array* A pointer to the newly created bucketArray.
+ */
+BucketArray* BucketArrayNewAligned(const size_t elementSize, const Index bucketCapacity, const size_t alignment, const Allocator* allocator)
 {
     LogAssert(elementSize > 0);
     LogAssert(bucketCapacity > 0);
 
-    BucketArray* newBucketArray = malloc(sizeof(BucketArray));
+    BucketArray* newBucketArray = AllocatorAlloc(allocator, sizeof(BucketArray));
 
     LogAssert(newBucketArray != NULL);
+
+    BucketArrayInit(newBucketArray, elementSize, bucketCapacity, alignment, allocator);
+
+    return newBucketArray;
+}
+
+/**
+ * @brief Creates a new array with a geometric layout, and initializes it. Every bucket holds twice as many elements as the previous one, so large arrays only need a few big buckets, while pointers to elements stay valid.
+ * @param elementSize The memory footprint of 1 element.
+ * @param firstBucketCapacity The number of elements the first bucket can hold. This gets rounded up to a power of 2.
+ * @return Array* A pointer to the newly created bucketArray.
+ */
+BucketArray* BucketArrayNewGeometric(const size_t elementSize, const Index firstBucketCapacity)
+{
     LogAssert(elementSize > 0);
-    LogAssert(bucketCapacity > 0);
+    LogAssert(firstBucketCapacity > 0);
+
+    BucketArray* newBucketArray = AllocatorAlloc(NULL, sizeof(BucketArray));
+
+    LogAssert(newBucketArray != NULL);
 
-    BucketArrayInit(newBucketArray, elementSize, bucketCapacity);
+    BucketArrayInitGeometric(newBucketArray, elementSize, firstBucketCapacity, 0, NULL);
+
+    return newBucketArray;
+}
+
+/**
+ * @brief Creates a new array in a reserved range of address space, and initializes it. The elements are stored contiguously in a single bucket, which gets committed as the array grows, so pointers to elements never become corrupt.
+ * @param elementSize The memory footprint of 1 element.
+ * @param maxCapacity The maximum number of elements the bucketArray will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the bucket with transparent huge pages.
+ * @return Array* A pointer to the newly created bucketArray.
+ */
+BucketArray* BucketArrayNewReserved(const size_t elementSize, const Index maxCapacity, const bool useHugePages)
+{
+    LogAssert(elementSize > 0);
+    LogAssert(maxCapacity > 0);
+
+    BucketArray* newBucketArray = AllocatorAlloc(NULL, sizeof(BucketArray));
+
+    LogAssert(newBucketArray != NULL);
+
+    BucketArrayInitReserved(newBucketArray, elementSize, maxCapacity, useHugePages, NULL);
 
     return newBucketArray;
 }
@@ -35,22 +103,24 @@ BucketArray* BucketArrayNew(const size_t elementSize, const uint64_t bucketCapac
  * @brief Add a new element to the back of the array. If the current bucket is full, a new bucket will be allocated.
  * @param bucketArray The bucketArray to add the element to.
  * @param newElement A pointer to the data to add.
- * @return void* A pointer to the new element in the array.
+ * @return void* A pointer to the new element in the array. NULL if no bucket could be added.
  */
 void* BucketArrayAdd(BucketArray* bucketArray, const void* newElement)
 {
     LogAssert(bucketArray != NULL);
     LogAssert(newElement != NULL);
 
-    if(bucketArray->num >= ArrayNum(&(bucketArray->bucketPtrs)) * bucketArray->bucketCapacity)
+    if(bucketArray->num >= BucketArrayCapacity(bucketArray) && BucketArrayAddBucket(bucketArray) == NULL)
     {
-        BucketArrayAddBucket(bucketArray);
+        return NULL;
     }
 
-    void* currentBucket = *(void**) ArrayGet(&(bucketArray->bucketPtrs), ArrayNum(&(bucketArray->bucketPtrs)) - 1);
+    Index bucketIndex;
+    Index indexInBucket;
+    BucketArrayLocate(bucketArray, bucketArray->num, &bucketIndex, &indexInBucket);
 
-    uint64_t currentBucketNum = bucketArray->num % bucketArray->bucketCapacity;
-    void* locationToSet = currentBucket + (currentBucketNum * bucketArray->elementSize);
+    void* currentBucket = *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), bucketIndex);
+    void* locationToSet = currentBucket + (indexInBucket * bucketArray->elementSize);
 
     void* result = memcpy(locationToSet, newElement, bucketArray->elementSize);
 
@@ -61,6 +131,81 @@ void* BucketArrayAdd(BucketArray* bucketArray, const void* newElement)
     return result;
 }
 
+/**
+ * @brief Add a range of elements to the back of the bucketArray. All needed buckets are allocated up front, after which the elements are copied with one copy per bucket they span.
+ * @param bucketArray The bucketArray to add the elements to.
+ * @param newElements A pointer to the first of the contiguous elements to add.
+ * @param numElements The number of elements to add.
+ * @return void* A pointer to the first new element in the bucketArray. The following elements are only contiguous up to the end of its bucket. NULL if the bucketArray could not grow.
+ */
+void* BucketArrayAppend(BucketArray* bucketArray, const void* newElements, const Index numElements)
+{
+    LogAssert(bucketArray != NULL);
+    LogAssert(newElements != NULL || numElements == 0);
+
+    if(numElements == 0)
+    {
+        return NULL;
+    }
+
+    if(!BucketArrayReserve(bucketArray, bucketArray->num + numElements))
+    {
+        return NULL;
+    }
+
+    void* firstNewElement = NULL;
+    const void* elementsToCopy = newElements;
+    Index numElementsLeft = numElements;
+
+    while(numElementsLeft > 0)
+    {
+        Index bucketIndex;
+        Index indexInBucket;
+        BucketArrayLocate(bucketArray, bucketArray->num, &bucketIndex, &indexInBucket);
+
+        Index spanNum = fmin(numElementsLeft, BucketArrayBucketSize(bucketArray, bucketIndex) - indexInBucket);
+        void* locationToSet = BucketArrayGetBucketFast(bucketArray, bucketIndex) + ((size_t) indexInBucket * bucketArray->elementSize);
+        memcpy(locationToSet, elementsToCopy, (size_t) spanNum * bucketArray->elementSize);
+
+        if(firstNewElement == NULL)
+        {
+            firstNewElement = locationToSet;
+        }
+
+        elementsToCopy += (size_t) spanNum * bucketArray->elementSize;
+        numElementsLeft -= spanNum;
+        bucketArray->num += spanNum;
+    }
+
+    return firstNewElement;
+}
+
+/**
+ * @brief Remove an element by moving the last element into its place. This doesn't keep the order of the elements, but only copies a single element.
+ * @param bucketArray The bucketArray to remove the element from.
+ * @param index The index of the element to remove.
+ * @param removedElement Pointer to retrieving data, to get a copy of the element that was removed. This can be left to NULL if no returned value is requested.
+ */
+void BucketArraySwapRemove(BucketArray* bucketArray, const Index index, void* removedElement)
+{
+    LogAssert(bucketArray != NULL);
+    LogAssert(index < bucketArray->num);
+
+    void* element = BucketArrayGetFast(bucketArray, index);
+
+    if(removedElement != NULL)
+    {
+        memcpy(removedElement, element, bucketArray->elementSize);
+    }
+
+    if(index != bucketArray->num - 1)
+    {
+        memcpy(element, BucketArrayGetFast(bucketArray, bucketArray->num - 1), bucketArray->elementSize);
+    }
+
+    BucketArrayPopBack(bucketArray, NULL);
+}
+
 /**
  * @brief Remove the last element of the array.
  * @param  bucketArray: The bucketArray to remove from.
@@ -71,7 +216,7 @@ void BucketArrayPopBack(BucketArray* bucketArray, void* poppedElement)
     LogAssert(bucketArray != NULL);
     LogAssert(bucketArray->num > 0);
 
-    void* lastElement = BucketArrayGet(bucketArray, bucketArray->num - 1);
+    void* lastElement = BucketArrayGetFast(bucketArray, bucketArray->num - 1);
 
     if(poppedElement != NULL)
     {
@@ -82,12 +227,12 @@ void BucketArrayPopBack(BucketArray* bucketArray, void* poppedElement)
 
     bucketArray->num--;
 
-    uint64_t currentBucketNum = bucketArray->num % bucketArray->bucketCapacity;
+    Index numBuckets = ArrayNum(&(bucketArray->bucketPtrs));
 
     /* TODO: Make the bucketArray preserve an extra bucket when removing elements.
         this prevents buckets from constantly being added and removed when adding and remove elements onto a full bucket.
     */
-    if(currentBucketNum == 0 && ArrayNum(&(bucketArray->bucketPtrs)) > 1)
+    if(numBuckets > 1 && bucketArray->num <= BucketArrayCapacityOfBuckets(bucketArray, numBuckets - 1))
     {
         BucketArrayPopBackBucket(bucketArray);
     }
@@ -99,36 +244,45 @@ void BucketArrayPopBack(BucketArray* bucketArray, void* poppedElement)
  * @param index The index at which to find the element
  * @return void* A pointer to the requested element.
  */
-void* BucketArrayGet(const BucketArray* bucketArray, const uint64_t index)
+void* BucketArrayGet(const BucketArray* bucketArray, const Index index)
 {
     LogAssert(bucketArray != NULL);
     LogAssert(index < bucketArray->num);
 
-    uint64_t bucketIndex = floor((float) index / (float) bucketArray->bucketCapacity);
-    uint64_t indexInBucket = index % bucketArray->bucketCapacity;
-
-    void* bucket = *(void**) ArrayGet(&(bucketArray->bucketPtrs), bucketIndex);
-
-    void* result = bucket + ((size_t) indexInBucket * bucketArray->elementSize);
-
-    return result;
+    return BucketArrayGetFast(bucketArray, index);
 }
 
 /**
  * @brief Resize the bucketArray. If the new size is smaller than the previous size, the excess elements will be discarded.
  * @param bucketArray The bucketArray to be resized.
  * @param newCapacity The new number of elements the bucketArray can occupy before having to allocate more memory.
+ * @return bool Wether or not the bucketArray was resized. If not, because its memory could not be allocated or committed, the bucketArray may have grown part of the way, but its elements are left unchanged.
  */
-void BucketArrayResize(BucketArray* bucketArray, const uint64_t newCapacity)
+bool BucketArrayResize(BucketArray* bucketArray, const Index newCapacity)
 {
     LogAssert(bucketArray != NULL);
 
     if(newCapacity == BucketArrayCapacity(bucketArray))
     {
-        return;
+        return true;
+    }
+
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED)
+    {
+        if(!BucketArrayCommitReserved(bucketArray, newCapacity))
+        {
+            return false;
+        }
+
+        void* bucket = BucketArrayGetBucketFast(bucketArray, 0);
+        Index numElementsToClear = bucketArray->bucketCapacity - fmin(newCapacity, bucketArray->bucketCapacity);
+        memset(bucket + ((size_t) (bucketArray->bucketCapacity - numElementsToClear) * bucketArray->elementSize), 0, (size_t) numElementsToClear * bucketArray->elementSize);
+
+        bucketArray->num = fmin(bucketArray->num, newCapacity);
+        return true;
     }
 
-    uint64_t numBuckets = ceil((float) newCapacity / (float) bucketArray->bucketCapacity);
+    Index numBuckets = BucketArrayNumBucketsForCapacity(bucketArray, newCapacity);
 
     int prevNumBucketsCurrentNumBucketsDiff = abs(bucketArray->bucketPtrs.num - numBuckets);
 
@@ -143,7 +297,10 @@ void BucketArrayResize(BucketArray* bucketArray, const uint64_t newCapacity)
     {
         for(int i = 0; i < prevNumBucketsCurrentNumBucketsDiff; ++i)
         {
-            BucketArrayAddBucket(bucketArray);
+            if(BucketArrayAddBucket(bucketArray) == NULL)
+            {
+                return false;
+            }
         }
     }
 
@@ -151,12 +308,57 @@ void BucketArrayResize(BucketArray* bucketArray, const uint64_t newCapacity)
 
     if(numBuckets > 0)
     {
-        uint64_t numElementsInLastBucket = newCapacity % bucketArray->bucketCapacity;
-        void* lastBucket = *(void**) ArrayGet(&(bucketArray->bucketPtrs), ArrayNum(&(bucketArray->bucketPtrs)) - 1);
-        memset(lastBucket + (numElementsInLastBucket * bucketArray->elementSize), 0, bucketArray->bucketCapacity - numElementsInLastBucket);
+        Index numElementsInLastBucket = newCapacity - BucketArrayCapacityOfBuckets(bucketArray, numBuckets - 1);
+        Index lastBucketSize = BucketArrayBucketSize(bucketArray, numBuckets - 1);
+
+        if(numElementsInLastBucket < lastBucketSize)
+        {
+            void* lastBucket = *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), numBuckets - 1);
+            memset(lastBucket + (numElementsInLastBucket * bucketArray->elementSize), 0, (lastBucketSize - numElementsInLastBucket) * bucketArray->elementSize);
+        }
     }
 
     bucketArray->num = fmin(bucketArray->num, newCapacity);
+    return true;
+}
+
+/**
+ * @brief Make sure the bucketArray can hold a given number of elements without having to allocate more memory. Existing elements never move, since only buckets get added.
+ * @param bucketArray The bucketArray to reserve memory for.
+ * @param minCapacity The number of elements the bucketArray should be able to hold.
+ * @return bool Wether or not the bucketArray can hold the given number of elements.
+ */
+bool BucketArrayReserve(BucketArray* bucketArray, const Index minCapacity)
+{
+    LogAssert(bucketArray != NULL);
+
+    if(minCapacity <= BucketArrayCapacity(bucketArray))
+    {
+        return true;
+    }
+
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED)
+    {
+        LogAssert(minCapacity <= bucketArray->maxCapacity, "Reserved bucketArray can't grow beyond %llu elements.", (unsigned long long) bucketArray->maxCapacity);
+
+        Index newCapacity = fmax(bucketArray->bucketCapacity * GOLDEN_RATIO, minCapacity);
+        return BucketArrayCommitReserved(bucketArray, fmin(newCapacity, bucketArray->maxCapacity));
+    }
+
+    if(!ArrayReserve(&(bucketArray->bucketPtrs), BucketArrayNumBucketsForCapacity(bucketArray, minCapacity)))
+    {
+        return false;
+    }
+
+    while(BucketArrayCapacity(bucketArray) < minCapacity)
+    {
+        if(BucketArrayAddBucket(bucketArray) == NULL)
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 void BucketArrayFill(BucketArray* bucketArray, void* value)
@@ -164,14 +366,18 @@ void BucketArrayFill(BucketArray* bucketArray, void* value)
     LogAssert(bucketArray != NULL);
     LogAssert(value != NULL);
 
-    uint64_t capacity = BucketArrayCapacity(bucketArray);
+    bucketArray->num = BucketArrayCapacity(bucketArray);
 
-    bucketArray->num = capacity;
+    BucketArrayIterator iterator = BucketArrayIterate(bucketArray);
+    void* span;
+    Index spanNum;
 
-    for(int i = 0; i < capacity; ++i)
+    while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
     {
-        void* locationToSet = BucketArrayGet(bucketArray, i);
-        memcpy(locationToSet, value, bucketArray->elementSize);
+        for(Index i = 0; i < spanNum; ++i)
+        {
+            memcpy(span + (i * bucketArray->elementSize), value, bucketArray->elementSize);
+        }
     }
 }
 
@@ -185,13 +391,49 @@ void BucketArrayClear(BucketArray* bucketArray)
 
     for(int i = 0; i < ArrayNum(&(bucketArray->bucketPtrs)); i++)
     {
-        void* bucket = *(void**) ArrayGet(&(bucketArray->bucketPtrs), i);
-        memset(bucket, 0, bucketArray->bucketCapacity);
+        void* bucket = *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), i);
+        memset(bucket, 0, BucketArrayBucketSize(bucketArray, i) * bucketArray->elementSize);
     }
 
     bucketArray->num = 0;
 }
 
+/**
+ * @brief Release trailing buckets that hold no elements, keeping at least 1 bucket. The work is bounded, so this can be called every frame to let the memory footprint follow the number of elements back down.
+ * @param bucketArray The bucketArray to shrink.
+ * @param maxBucketsToRelease The maximum number of buckets to release during this call.
+ * @return uint64_t The number of buckets that were released.
+ */
+uint64_t BucketArrayShrink(BucketArray* bucketArray, const uint64_t maxBucketsToRelease)
+{
+    LogAssert(bucketArray != NULL);
+
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED)
+    {
+        Index prevCapacity = bucketArray->bucketCapacity;
+
+        if(maxBucketsToRelease > 0)
+        {
+            BucketArrayCommitReserved(bucketArray, bucketArray->num);
+        }
+
+        return bucketArray->bucketCapacity < prevCapacity ? 1 : 0;
+    }
+
+    Index numBucketsInUse = BucketArrayNumBucketsForCapacity(bucketArray, bucketArray->num);
+    numBucketsInUse = fmax(numBucketsInUse, 1);
+
+    uint64_t numBucketsReleased = 0;
+
+    while(numBucketsReleased < maxBucketsToRelease && ArrayNum(&(bucketArray->bucketPtrs)) > numBucketsInUse)
+    {
+        BucketArrayPopBackBucket(bucketArray);
+        ++numBucketsReleased;
+    }
+
+    return numBucketsReleased;
+}
+
 /**
  * @brief Free the bucketArray.
  * @param bucketArray The bucketArray to free.
@@ -200,17 +442,93 @@ void BucketArrayFree(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
 
+    const Allocator* allocator = bucketArray->allocator;
+
     BucketArrayDeinit(bucketArray);
 
-    free(bucketArray);
+    AllocatorFree(allocator, bucketArray, sizeof(BucketArray));
+}
+
+/**
+ * @brief Start iterating over the elements of a bucketArray, from front to back, one contiguous span at a time.
+ * @param bucketArray The bucketArray to iterate over. Adding or removing elements invalidates the iterator.
+ * @return BucketArrayIterator An iterator, positioned before the first span.
+ */
+BucketArrayIterator BucketArrayIterate(const BucketArray* bucketArray)
+{
+    LogAssert(bucketArray != NULL);
+
+    BucketArrayIterator iterator = { bucketArray, 0, 0, false };
+    return iterator;
+}
+
+/**
+ * @brief Start iterating over the elements of a bucketArray, from back to front, one contiguous span at a time. The elements within a span are still laid out from front to back.
+ * @param bucketArray The bucketArray to iterate over. Adding or removing elements invalidates the iterator.
+ * @return BucketArrayIterator An iterator, positioned after the last span.
+ */
+BucketArrayIterator BucketArrayIterateReverse(const BucketArray* bucketArray)
+{
+    LogAssert(bucketArray != NULL);
+
+    BucketArrayIterator iterator = { bucketArray, 0, bucketArray->num, true };
+    return iterator;
+}
+
+/**
+ * @brief Advance the iterator to the next span of contiguous elements.
+ * @param iterator The iterator to advance.
+ * @param span Output, receiving a pointer to the first element of the span.
+ * @param spanNum Output, receiving the number of elements in the span.
+ * @return bool Wether or not there was a span left. If false, span and spanNum are left untouched.
+ */
+bool BucketArrayIteratorNext(BucketArrayIterator* iterator, void** span, Index* spanNum)
+{
+    LogAssert(iterator != NULL);
+    LogAssert(span != NULL);
+    LogAssert(spanNum != NULL);
+
+    const BucketArray* bucketArray = iterator->bucketArray;
+
+    if(iterator->isReversed)
+    {
+        if(iterator->elementIndex == 0)
+        {
+            return false;
+        }
+
+        Index bucketIndex;
+        Index indexInBucket;
+        BucketArrayLocate(bucketArray, iterator->elementIndex - 1, &bucketIndex, &indexInBucket);
+
+        *span = BucketArrayGetBucketFast(bucketArray, bucketIndex);
+        *spanNum = indexInBucket + 1;
+
+        iterator->elementIndex -= *spanNum;
+    }
+    else
+    {
+        if(iterator->elementIndex >= bucketArray->num)
+        {
+            return false;
+        }
+
+        *span = BucketArrayGetBucketFast(bucketArray, iterator->bucketIndex);
+        *spanNum = fmin(BucketArrayBucketSize(bucketArray, iterator->bucketIndex), bucketArray->num - iterator->elementIndex);
+
+        iterator->elementIndex += *spanNum;
+        iterator->bucketIndex++;
+    }
+
+    return true;
 }
 
 /**
  * @brief Get the number of elements present in the array.
  * @param bucketArray The bucketArray to get the number of elements from.
- * @return uint64_t The number of elements in the array.
+ * @return Index The number of elements in the array.
  */
-uint64_t BucketArrayNum(BucketArray* bucketArray)
+Index BucketArrayNum(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
     return bucketArray->num;
@@ -219,9 +537,9 @@ uint64_t BucketArrayNum(BucketArray* bucketArray)
 /**
  * @brief Get the number of buckets present in the array.
  * @param bucketArray The bucketArray to get the number of buckets from.
- * @return uint64_t The number of buckets in the array.
+ * @return Index The number of buckets in the array.
  */
-uint64_t BucketArrayNumBuckets(BucketArray* bucketArray)
+Index BucketArrayNumBuckets(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
     return ArrayNum(&(bucketArray->bucketPtrs));
@@ -230,20 +548,20 @@ uint64_t BucketArrayNumBuckets(BucketArray* bucketArray)
 /**
  * @brief Get the maximum number of elements the bucketArray can store, before having to allocate more memory.
  * @param bucketArray The bucketArray to get the capacity from.
- * @return uint64_t The capacity of the bucketArray.
+ * @return Index The capacity of the bucketArray.
  */
-uint64_t BucketArrayCapacity(BucketArray* bucketArray)
+Index BucketArrayCapacity(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
-    return bucketArray->bucketCapacity * ArrayNum(&(bucketArray->bucketPtrs));
+    return BucketArrayCapacityOfBuckets(bucketArray, ArrayNum(&(bucketArray->bucketPtrs)));
 }
 
 /**
- * @brief Get the maximum number of elements a single bucket from this bucketArray can store.
+ * @brief Get the maximum number of elements a single bucket from this bucketArray can store. For a geometric layout, this is the capacity of the first bucket.
  * @param bucketArray The bucketArray to get the bucket capacity from.
- * @return uint64_t The bucket capacity of the bucketArray.
+ * @return Index The bucket capacity of the bucketArray.
  */
-uint64_t BucketArrayBucketCapacity(BucketArray* bucketArray)
+Index BucketArrayBucketCapacity(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
     return bucketArray->bucketCapacity;
@@ -256,8 +574,10 @@ uint64_t BucketArrayBucketCapacity(BucketArray* bucketArray)
  * @param bucketArray The bucketArray to be initialized.
  * @param elementSize The memory footprint of 1 element.
  * @param bucketCapacity The number of elements a bucket can hold.
+ * @param alignment The alignment of every bucket in bytes. This has to be a power of 2. 0 for the allocator's default alignment.
+ * @param allocator The allocator to manage the bucketArray's memory with. NULL to use the default allocator.
  */
-void BucketArrayInit(BucketArray* bucketArray, const size_t elementSize, const uint64_t bucketCapacity)
+void BucketArrayInit(BucketArray* bucketArray, const size_t elementSize, const Index bucketCapacity, const size_t alignment, const Allocator* allocator)
 {
     LogAssert(bucketArray != NULL);
     LogAssert(elementSize > 0);
@@ -266,12 +586,89 @@ void BucketArrayInit(BucketArray* bucketArray, const size_t elementSize, const u
     bucketArray->elementSize = elementSize;
     bucketArray->num = 0;
     bucketArray->bucketCapacity = bucketCapacity;
+    bucketArray->maxCapacity = 0;
+    bucketArray->bucketCapacityShift = 0;
+    bucketArray->layout = BUCKET_ARRAY_LAYOUT_FIXED;
+    bucketArray->alignment = alignment;
+
+    bucketArray->allocator = allocator;
+
+    ArrayInit(&(bucketArray->bucketPtrs), sizeof(void*), 1, 0, allocator);
+
+    BucketArrayAddBucket(bucketArray);
+}
+
+/**
+ * @brief Initialize an existing bucketArray with a geometric layout. Only used internally. When calling BucketArrayNewGeometric, the array will already be initialized.
+ * @param bucketArray The bucketArray to be initialized.
+ * @param elementSize The memory footprint of 1 element.
+ * @param firstBucketCapacity The number of elements the first bucket can hold. This gets rounded up to a power of 2.
+ * @param alignment The alignment of every bucket in bytes. This has to be a power of 2. 0 for the allocator's default alignment.
+ * @param allocator The allocator to manage the bucketArray's memory with. NULL to use the default allocator.
+ */
+void BucketArrayInitGeometric(BucketArray* bucketArray, const size_t elementSize, const Index firstBucketCapacity, const size_t alignment, const Allocator* allocator)
+{
+    LogAssert(bucketArray != NULL);
+    LogAssert(elementSize > 0);
+    LogAssert(firstBucketCapacity > 0);
+
+    uint8_t shift = 0;
+    while(((Index) 1 << shift) < firstBucketCapacity)
+    {
+        ++shift;
+    }
+
+    bucketArray->elementSize = elementSize;
+    bucketArray->num = 0;
+    bucketArray->bucketCapacity = (Index) 1 << shift;
+    bucketArray->maxCapacity = 0;
+    bucketArray->bucketCapacityShift = shift;
+    bucketArray->layout = BUCKET_ARRAY_LAYOUT_GEOMETRIC;
+    bucketArray->alignment = alignment;
 
-    ArrayInit(&(bucketArray->bucketPtrs), sizeof(void*), 1);
+    bucketArray->allocator = allocator;
+
+    ArrayInit(&(bucketArray->bucketPtrs), sizeof(void*), 1, 0, allocator);
 
     BucketArrayAddBucket(bucketArray);
 }
 
+/**
+ * @brief Initialize an existing bucketArray with a reserved layout. Only used internally. When calling BucketArrayNewReserved, the array will already be initialized.
+ * @param bucketArray The bucketArray to be initialized.
+ * @param elementSize The memory footprint of 1 element.
+ * @param maxCapacity The maximum number of elements the bucketArray will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the bucket with transparent huge pages.
+ * @param allocator The allocator to manage the bookkeeping of the bucketArray with. The bucket itself lives in reserved address space. NULL to use the default allocator.
+ */
+void BucketArrayInitReserved(BucketArray* bucketArray, const size_t elementSize, const Index maxCapacity, const bool useHugePages, const Allocator* allocator)
+{
+    LogAssert(bucketArray != NULL);
+    LogAssert(elementSize > 0);
+    LogAssert(maxCapacity > 0);
+
+    bucketArray->elementSize = elementSize;
+    bucketArray->num = 0;
+    bucketArray->bucketCapacity = 0;
+    bucketArray->maxCapacity = maxCapacity;
+    bucketArray->bucketCapacityShift = 0;
+    bucketArray->layout = BUCKET_ARRAY_LAYOUT_RESERVED;
+    bucketArray->alignment = VirtualMemoryPageSize();
+
+    void* bucket = VirtualMemoryReserve(elementSize * (size_t) maxCapacity);
+    LogAssert(bucket != NULL);
+
+    if(useHugePages)
+    {
+        VirtualMemoryAdviseHugePages(bucket, elementSize * (size_t) maxCapacity);
+    }
+
+    bucketArray->allocator = allocator;
+
+    ArrayInit(&(bucketArray->bucketPtrs), sizeof(void*), 1, 0, allocator);
+    ArrayAdd(&(bucketArray->bucketPtrs), &bucket);
+}
+
 /**
  * @brief Deinitialize the bucketArray. This does not free the bucketArray pointer. Use this function instead of free if the bucketArray is stack allocated or allocated locally as a struct member.
  * @param bucketArray The bucketArray to deinitialize.
@@ -280,11 +677,18 @@ void BucketArrayDeinit(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
 
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED)
+    {
+        VirtualMemoryRelease(BucketArrayGetBucketFast(bucketArray, 0), bucketArray->elementSize * (size_t) bucketArray->maxCapacity);
+        ArrayDeinit(&(bucketArray->bucketPtrs));
+        return;
+    }
+
     for(int i = 0; i < ArrayNum(&(bucketArray->bucketPtrs)); i++)
     {
-        void* memoryToFree = *(void**) ArrayGet(&(bucketArray->bucketPtrs), i);
+        void* memoryToFree = *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), i);
         LogAssert(memoryToFree != NULL);
-        free(memoryToFree);
+        AllocatorFreeAligned(bucketArray->allocator, memoryToFree, (size_t) BucketArrayBucketSize(bucketArray, i) * bucketArray->elementSize, bucketArray->alignment);
     }
 
     ArrayDeinit(&(bucketArray->bucketPtrs));
@@ -296,12 +700,12 @@ void BucketArrayDeinit(BucketArray* bucketArray)
  * @param bucketIndex The index of the bucket.
  * @return void* A pointer to the bucket. This is a pointer to that sub-array.
  */
-void* BucketArrayGetBucket(BucketArray* bucketArray, const uint64_t bucketIndex)
+void* BucketArrayGetBucket(BucketArray* bucketArray, const Index bucketIndex)
 {
     LogAssert(bucketArray != NULL);
     LogAssert(bucketIndex < ArrayNum(&(bucketArray->bucketPtrs)));
 
-    return *(void**) ArrayGet(&(bucketArray->bucketPtrs), bucketIndex);
+    return *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), bucketIndex);
 }
 
 /* ----------------------------------------------------- Private ---------------------------------------------------- */
@@ -309,14 +713,43 @@ void* BucketArrayGetBucket(BucketArray* bucketArray, const uint64_t bucketIndex)
 /**
  * @brief Add a new bucket to the bucketArray.
  * @param bucketArray The bucketArray to add the bucket to.
- * @return void* A pointer to the newly added bucket.
+ * @return void* A pointer to the newly added bucket. NULL if its memory could not be allocated or committed.
  */
 static void* BucketArrayAddBucket(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
 
-    void* newBucket = calloc(bucketArray->bucketCapacity, bucketArray->elementSize);
-    ArrayAdd(&(bucketArray->bucketPtrs), &newBucket);
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED) // The single bucket grows in place instead.
+    {
+        LogAssert(bucketArray->bucketCapacity < bucketArray->maxCapacity, "Reserved bucketArray can't grow beyond %llu elements.", (unsigned long long) bucketArray->maxCapacity);
+
+        Index newCapacity = fmax(bucketArray->bucketCapacity * GOLDEN_RATIO, bucketArray->bucketCapacity + 1);
+
+        if(!BucketArrayCommitReserved(bucketArray, fmin(newCapacity, bucketArray->maxCapacity)))
+        {
+            return NULL;
+        }
+
+        return BucketArrayGetBucketFast(bucketArray, 0);
+    }
+
+    size_t newBucketSize = (size_t) BucketArrayBucketSize(bucketArray, ArrayNum(&(bucketArray->bucketPtrs))) * bucketArray->elementSize;
+
+    void* newBucket = AllocatorAllocAligned(bucketArray->allocator, newBucketSize, bucketArray->alignment);
+
+    if(newBucket == NULL)
+    {
+        return NULL;
+    }
+
+    memset(newBucket, 0, newBucketSize);
+
+    if(ArrayAdd(&(bucketArray->bucketPtrs), &newBucket) == NULL)
+    {
+        AllocatorFreeAligned(bucketArray->allocator, newBucket, newBucketSize, bucketArray->alignment);
+        return NULL;
+    }
+
     return newBucket;
 }
 
@@ -327,10 +760,62 @@ static void* BucketArrayAddBucket(BucketArray* bucketArray)
 static void BucketArrayPopBackBucket(BucketArray* bucketArray)
 {
     LogAssert(bucketArray != NULL);
-    LogAssert(bucketArray->num > 0);
+    LogAssert(ArrayNum(&(bucketArray->bucketPtrs)) > 0);
 
     void* bucket;
     ArrayPopBack(&(bucketArray->bucketPtrs), &bucket);
 
-    free(bucket);
+    AllocatorFreeAligned(bucketArray->allocator, bucket, (size_t) BucketArrayBucketSize(bucketArray, ArrayNum(&(bucketArray->bucketPtrs))) * bucketArray->elementSize, bucketArray->alignment);
+}
+
+/**
+ * @brief Get the number of buckets needed to hold a given number of elements.
+ * @param bucketArray The bucketArray to compute the number of buckets for.
+ * @param capacity The number of elements to hold.
+ * @return Index The number of buckets needed.
+ */
+static Index BucketArrayNumBucketsForCapacity(const BucketArray* bucketArray, const Index capacity)
+{
+    if(capacity == 0)
+    {
+        return 0;
+    }
+
+    Index bucketIndex;
+    Index indexInBucket;
+    BucketArrayLocate(bucketArray, capacity - 1, &bucketIndex, &indexInBucket);
+
+    return bucketIndex + 1;
+}
+
+/**
+ * @brief Commit or decommit the memory of a reserved bucketArray, so it covers a given number of elements. The committed capacity gets rounded up to whole pages, but never exceeds the reserved capacity.
+ * @param bucketArray The reserved bucketArray to commit memory for.
+ * @param newCapacity The number of elements that should be accessible.
+ * @return bool Wether or not the memory could be committed. If not, the capacity is left unchanged.
+ */
+static bool BucketArrayCommitReserved(BucketArray* bucketArray, const Index newCapacity)
+{
+    LogAssert(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED);
+    LogAssert(newCapacity <= bucketArray->maxCapacity);
+
+    void* bucket = BucketArrayGetBucketFast(bucketArray, 0);
+
+    size_t committedSize = VirtualMemoryRoundToPageSize((size_t) bucketArray->bucketCapacity * bucketArray->elementSize);
+    size_t newCommittedSize = VirtualMemoryRoundToPageSize((size_t) newCapacity * bucketArray->elementSize);
+
+    if(newCommittedSize > committedSize)
+    {
+        if(!VirtualMemoryCommit(bucket + committedSize, newCommittedSize - committedSize))
+        {
+            return false;
+        }
+    }
+    else if(newCommittedSize < committedSize)
+    {
+        VirtualMemoryDecommit(bucket + newCommittedSize, committedSize - newCommittedSize);
+    }
+
+    bucketArray->bucketCapacity = fmin(newCommittedSize / bucketArray->elementSize, bucketArray->maxCapacity);
+    return true;
 }
\ No newline at end of file
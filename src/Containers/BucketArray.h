@@ -9,15 +9,177 @@
  */
 struct BucketArray
 {
-    uint64_t num;               // The number of elements present in the bucketArray.
-    uint64_t bucketCapacity;    // The maximum number of elements per bucket.
-    size_t elementSize;         // The memory footprint of 1 element.
-    Array bucketPtrs;           // A collection of pointers to the different buckets.
+    Index num;                      // The number of elements present in the bucketArray.
+    Index bucketCapacity;           // The maximum number of elements per bucket. For a geometric layout, this is the capacity of the first bucket. For a reserved layout, this is the number of committed elements.
+    Index maxCapacity;              // The number of elements the reserved address space can hold. Only used by the reserved layout.
+    uint8_t bucketCapacityShift;    // The base 2 logarithm of the bucket capacity. Only used by the geometric layout.
+    BucketArrayLayout layout;       // The way the buckets are sized.
+    size_t elementSize;             // The memory footprint of 1 element.
+    Array bucketPtrs;               // A collection of pointers to the different buckets.
+    size_t alignment;               // The alignment of every bucket in memory. 0 for the allocator's default alignment.
+    const Allocator* allocator;     // The allocator used for the buckets. NULL for the default allocator.
 };
 
-void BucketArrayInit(BucketArray* bucketArray, const size_t elementSize, const uint64_t bucketCapacity);
+void BucketArrayInit(BucketArray* bucketArray, const size_t elementSize, const Index bucketCapacity, const size_t alignment, const Allocator* allocator);
+void BucketArrayInitGeometric(BucketArray* bucketArray, const size_t elementSize, const Index firstBucketCapacity, const size_t alignment, const Allocator* allocator);
+void BucketArrayInitReserved(BucketArray* bucketArray, const size_t elementSize, const Index maxCapacity, const bool useHugePages, const Allocator* allocator);
 void BucketArrayDeinit(BucketArray* bucketArray);
 
-void* BucketArrayGetBucket(BucketArray* bucketArray, const uint64_t bucketIndex);
+void* BucketArrayGetBucket(BucketArray* bucketArray, const Index bucketIndex);
+
+/**
+ * @brief Find the bucket an index lies in, and the index within that bucket.
+ * For a geometric layout, bucket i starts at index bucketCapacity * (2^i - 1). Offsetting the index by the first bucket's capacity makes the bucket follow from the position of the highest set bit, and the index within the bucket from masking that bit off.
+ * @param bucketArray The bucketArray the index belongs to.
+ * @param index The index to locate.
+ * @param bucketIndex Output, receiving the index of the bucket.
+ * @param indexInBucket Output, receiving the index within the bucket.
+ */
+static inline void BucketArrayLocate(const BucketArray* bucketArray, const Index index, Index* bucketIndex, Index* indexInBucket)
+{
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_GEOMETRIC)
+    {
+        uint64_t offsetIndex = (uint64_t) index + bucketArray->bucketCapacity;
+        int highestBit = 63 - __builtin_clzll(offsetIndex);
+
+        *bucketIndex = highestBit - bucketArray->bucketCapacityShift;
+        *indexInBucket = offsetIndex - ((uint64_t) 1 << highestBit);
+    }
+    else if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_RESERVED)
+    {
+        *bucketIndex = 0;
+        *indexInBucket = index;
+    }
+    else
+    {
+        *bucketIndex = index / bucketArray->bucketCapacity;
+        *indexInBucket = index % bucketArray->bucketCapacity;
+    }
+}
+
+/**
+ * @brief Get the number of elements a specific bucket can hold.
+ * @param bucketArray The bucketArray the bucket belongs to.
+ * @param bucketIndex The index of the bucket.
+ * @return Index The capacity of the bucket.
+ */
+static inline Index BucketArrayBucketSize(const BucketArray* bucketArray, const Index bucketIndex)
+{
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_GEOMETRIC)
+    {
+        return bucketArray->bucketCapacity << bucketIndex;
+    }
+
+    return bucketArray->bucketCapacity;
+}
+
+/**
+ * @brief Get the total number of elements the first numBuckets buckets can hold.
+ * @param bucketArray The bucketArray the buckets belong to.
+ * @param numBuckets The number of buckets, counted from the first one.
+ * @return Index The combined capacity of those buckets.
+ */
+static inline Index BucketArrayCapacityOfBuckets(const BucketArray* bucketArray, const Index numBuckets)
+{
+    if(bucketArray->layout == BUCKET_ARRAY_LAYOUT_GEOMETRIC)
+    {
+        return (bucketArray->bucketCapacity << numBuckets) - bucketArray->bucketCapacity;
+    }
+
+    return bucketArray->bucketCapacity * numBuckets;
+}
+
+/**
+ * @brief Retrieve a specific bucket from a bucket array. Inlined fast path of BucketArrayGetBucket, which is only checked in debug builds.
+ * @param bucketArray The bucket array to retrieve the bucket from.
+ * @param bucketIndex The index of the bucket.
+ * @return void* A pointer to the bucket. This is a pointer to that sub-array.
+ */
+static inline void* BucketArrayGetBucketFast(const BucketArray* bucketArray, const Index bucketIndex)
+{
+    return *(void**) ArrayGetFast(&(bucketArray->bucketPtrs), bucketIndex);
+}
+
+/**
+ * @brief Retrieve an element at a specific index. Inlined fast path of BucketArrayGet, which is only checked in debug builds.
+ * @param bucketArray The bucketArray to retrieve the element from.
+ * @param index The index at which to find the element
+ * @return void* A pointer to the requested element.
+ */
+static inline void* BucketArrayGetFast(const BucketArray* bucketArray, const Index index)
+{
+    LogAssert(bucketArray != NULL);
+    LogAssert(index < bucketArray->num);
+
+    Index bucketIndex;
+    Index indexInBucket;
+    BucketArrayLocate(bucketArray, index, &bucketIndex, &indexInBucket);
+
+    return BucketArrayGetBucketFast(bucketArray, bucketIndex) + ((size_t) indexInBucket * bucketArray->elementSize);
+}
+
+/**
+ * @brief Declare a bucketArray specialized for element type T, named T##BucketArray. The element size is a compile time constant, so elements are accessed with direct loads and stores instead of runtime multiplications and memcpy. The typed bucketArray wraps a generic bucketArray, so the generic functions still work on its base member.
+ * @param T The element type. This has to be a single identifier, so typedef pointer and qualified types first.
+ */
+#define DECLARE_BUCKET_ARRAY(T)                                                                                                              \
+    typedef struct T##BucketArray                                                                                                            \
+    {                                                                                                                                        \
+        BucketArray base;                                                                                                                    \
+    } T##BucketArray;                                                                                                                        \
+                                                                                                                                             \
+    static inline void T##BucketArrayInit(T##BucketArray* bucketArray, const Index bucketCapacity, const Allocator* allocator)               \
+    {                                                                                                                                        \
+        BucketArrayInit(&(bucketArray->base), sizeof(T), bucketCapacity, 0, allocator);                                                      \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline void T##BucketArrayInitGeometric(T##BucketArray* bucketArray, const Index firstBucketCapacity, const Allocator* allocator) \
+    {                                                                                                                                        \
+        BucketArrayInitGeometric(&(bucketArray->base), sizeof(T), firstBucketCapacity, 0, allocator);                                        \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline void T##BucketArrayDeinit(T##BucketArray* bucketArray)                                                                     \
+    {                                                                                                                                        \
+        BucketArrayDeinit(&(bucketArray->base));                                                                                             \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline T* T##BucketArrayAdd(T##BucketArray* bucketArray, const T newElement)                                                      \
+    {                                                                                                                                        \
+        if(bucketArray->base.num >= BucketArrayCapacityOfBuckets(&(bucketArray->base), bucketArray->base.bucketPtrs.num))                    \
+        {                                                                                                                                    \
+            return (T*) BucketArrayAdd(&(bucketArray->base), &newElement);                                                                   \
+        }                                                                                                                                    \
+                                                                                                                                             \
+        Index bucketIndex;                                                                                                                   \
+        Index indexInBucket;                                                                                                                 \
+        BucketArrayLocate(&(bucketArray->base), bucketArray->base.num++, &bucketIndex, &indexInBucket);                                      \
+                                                                                                                                             \
+        T* location = (T*) BucketArrayGetBucketFast(&(bucketArray->base), bucketIndex) + indexInBucket;                                      \
+        *location = newElement;                                                                                                              \
+        return location;                                                                                                                     \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline T T##BucketArrayPopBack(T##BucketArray* bucketArray)                                                                       \
+    {                                                                                                                                        \
+        T poppedElement;                                                                                                                     \
+        BucketArrayPopBack(&(bucketArray->base), &poppedElement);                                                                            \
+        return poppedElement;                                                                                                                \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline T* T##BucketArrayGet(const T##BucketArray* bucketArray, const Index index)                                                 \
+    {                                                                                                                                        \
+        LogAssert(index < bucketArray->base.num);                                                                                            \
+                                                                                                                                             \
+        Index bucketIndex;                                                                                                                   \
+        Index indexInBucket;                                                                                                                 \
+        BucketArrayLocate(&(bucketArray->base), index, &bucketIndex, &indexInBucket);                                                        \
+                                                                                                                                             \
+        return (T*) BucketArrayGetBucketFast(&(bucketArray->base), bucketIndex) + indexInBucket;                                             \
+    }                                                                                                                                        \
+                                                                                                                                             \
+    static inline Index T##BucketArrayNum(const T##BucketArray* bucketArray)                                                                 \
+    {                                                                                                                                        \
+        return bucketArray->base.num;                                                                                                        \
+    }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "BucketPool.h"
+
+#include "Utils/VirtualMemory.h"
+#include "Logger.h"
+
+#include <string.h>
+
+static BucketPoolSizeClass* BucketPoolGetSizeClass(BucketPool* bucketPool, const size_t bucketSize);
+static bool BucketPoolIsPageBacked(const size_t bucketSize);
+static void* BucketPoolAllocatorAlloc(void* userData, const size_t size);
+static void* BucketPoolAllocatorRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize);
+static void BucketPoolAllocatorFree(void* userData, void* memory, const size_t size);
+
+/**
+ * @brief Creates a new bucket pool, and initializes it.
+ * @param allocator The allocator to allocate small buckets and the pool's own bookkeeping with. NULL to use the default allocator.
+ * @param maxIdleSize The watermark, in bytes, above which idle buckets get returned to the OS.
+ * @return BucketPool* A pointer to the newly created bucket pool.
+ */
+BucketPool* BucketPoolNew(const Allocator* allocator, const size_t maxIdleSize)
+{
+    BucketPool* newBucketPool = AllocatorAlloc(allocator, sizeof(BucketPool));
+    LogAssert(newBucketPool != NULL);
+
+    BucketPoolInit(newBucketPool, allocator, maxIdleSize);
+
+    return newBucketPool;
+}
+
+/**
+ * @brief Get an allocator, which allocates from the bucket pool. Pass this to the containers that should share their buckets. Memory freed through it is kept for reuse by allocations of the exact same size.
+ * @param bucketPool The bucket pool to allocate from.
+ * @return const Allocator* A pointer to the allocator. This stays valid as long as the bucket pool.
+ */
+const Allocator* BucketPoolGetAllocator(BucketPool* bucketPool)
+{
+    LogAssert(bucketPool != NULL);
+    return &(bucketPool->poolAllocator);
+}
+
+/**
+ * @brief Return idle buckets to the OS, until the idle, committed memory of the pool no longer exceeds a given size. Buckets of at least a page keep their address space, so they can be recycled later. Smaller buckets are freed.
+ * @param bucketPool The bucket pool to trim.
+ * @param maxIdleSize The number of idle bytes the pool may keep committed.
+ */
+void BucketPoolTrim(BucketPool* bucketPool, const size_t maxIdleSize)
+{
+    LogAssert(bucketPool != NULL);
+
+    for(uint64_t i = ArrayNum(&(bucketPool->sizeClasses)); i > 0 && bucketPool->idleSize > maxIdleSize; --i)
+    {
+        BucketPoolSizeClass* sizeClass = ArrayGetFast(&(bucketPool->sizeClasses), i - 1);
+
+        while(ArrayNum(&(sizeClass->idleBuckets)) > 0 && bucketPool->idleSize > maxIdleSize)
+        {
+            void* bucket;
+            ArrayPopBack(&(sizeClass->idleBuckets), &bucket);
+            bucketPool->idleSize -= sizeClass->bucketSize;
+
+            if(BucketPoolIsPageBacked(sizeClass->bucketSize))
+            {
+                VirtualMemoryDecommit(bucket, sizeClass->bucketSize);
+                ArrayAdd(&(sizeClass->purgedBuckets), &bucket);
+            }
+            else
+            {
+                AllocatorFree(bucketPool->allocator, bucket, sizeClass->bucketSize);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Free the bucket pool, including all idle buckets. Containers allocating from the pool should be deinitialized first.
+ * @param bucketPool The bucket pool to free.
+ */
+void BucketPoolFree(BucketPool* bucketPool)
+{
+    LogAssert(bucketPool != NULL);
+
+    const Allocator* allocator = bucketPool->allocator;
+
+    BucketPoolDeinit(bucketPool);
+    AllocatorFree(allocator, bucketPool, sizeof(BucketPool));
+}
+
+/**
+ * @brief Get the combined memory footprint of all idle buckets, whose memory is still committed.
+ * @param bucketPool The bucket pool to get the idle size from.
+ * @return size_t The idle size in bytes.
+ */
+size_t BucketPoolIdleSize(const BucketPool* bucketPool)
+{
+    LogAssert(bucketPool != NULL);
+    return bucketPool->idleSize;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Initialize an existing bucket pool. Only used internally. When calling BucketPoolNew, the bucket pool will already be initialized.
+ * @param bucketPool The bucket pool to be initialized.
+ * @param allocator The allocator to allocate small buckets and the pool's own bookkeeping with. NULL to use the default allocator.
+ * @param maxIdleSize The watermark, in bytes, above which idle buckets get returned to the OS.
+ */
+void BucketPoolInit(BucketPool* bucketPool, const Allocator* allocator, const size_t maxIdleSize)
+{
+    LogAssert(bucketPool != NULL);
+
+    bucketPool->idleSize = 0;
+    bucketPool->maxIdleSize = maxIdleSize;
+    bucketPool->allocator = allocator;
+
+    bucketPool->poolAllocator.allocFunc = BucketPoolAllocatorAlloc;
+    bucketPool->poolAllocator.reallocFunc = BucketPoolAllocatorRealloc;
+    bucketPool->poolAllocator.freeFunc = BucketPoolAllocatorFree;
+    bucketPool->poolAllocator.userData = bucketPool;
+
+    ArrayInit(&(bucketPool->sizeClasses), sizeof(BucketPoolSizeClass), 4, 0, allocator);
+}
+
+/**
+ * @brief Deinitialize the bucket pool, releasing all idle buckets. This does not free the bucket pool pointer. Use this function instead of free if the bucket pool is stack allocated or allocated locally as a struct member.
+ * @param bucketPool The bucket pool to deinitialize.
+ */
+void BucketPoolDeinit(BucketPool* bucketPool)
+{
+    LogAssert(bucketPool != NULL);
+
+    BucketPoolTrim(bucketPool, 0);
+
+    for(uint64_t i = 0; i < ArrayNum(&(bucketPool->sizeClasses)); ++i)
+    {
+        BucketPoolSizeClass* sizeClass = ArrayGetFast(&(bucketPool->sizeClasses), i);
+
+        for(uint64_t b = 0; b < ArrayNum(&(sizeClass->purgedBuckets)); ++b)
+        {
+            VirtualMemoryRelease(*(void**) ArrayGetFast(&(sizeClass->purgedBuckets), b), sizeClass->bucketSize);
+        }
+
+        ArrayDeinit(&(sizeClass->idleBuckets));
+        ArrayDeinit(&(sizeClass->purgedBuckets));
+    }
+
+    ArrayDeinit(&(bucketPool->sizeClasses));
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Find the size class for a given bucket size, adding it if the pool hasn't seen this size before.
+ * @param bucketPool The bucket pool to search.
+ * @param bucketSize The memory footprint of 1 bucket.
+ * @return BucketPoolSizeClass* A pointer to the size class.
+ */
+static BucketPoolSizeClass* BucketPoolGetSizeClass(BucketPool* bucketPool, const size_t bucketSize)
+{
+    for(uint64_t i = 0; i < ArrayNum(&(bucketPool->sizeClasses)); ++i)
+    {
+        BucketPoolSizeClass* sizeClass = ArrayGetFast(&(bucketPool->sizeClasses), i);
+
+        if(sizeClass->bucketSize == bucketSize)
+        {
+            return sizeClass;
+        }
+    }
+
+    BucketPoolSizeClass newSizeClass;
+    newSizeClass.bucketSize = bucketSize;
+    ArrayInit(&(newSizeClass.idleBuckets), sizeof(void*), 4, 0, bucketPool->allocator);
+    ArrayInit(&(newSizeClass.purgedBuckets), sizeof(void*), 4, 0, bucketPool->allocator);
+
+    return ArrayAdd(&(bucketPool->sizeClasses), &newSizeClass);
+}
+
+/**
+ * @brief Get wether buckets of a given size get their own pages, so their memory can be returned to the OS while they sit idle.
+ * @param bucketSize The memory footprint of 1 bucket.
+ * @return bool Wether or not the buckets are page backed.
+ */
+static bool BucketPoolIsPageBacked(const size_t bucketSize)
+{
+    return bucketSize >= VirtualMemoryPageSize();
+}
+
+static void* BucketPoolAllocatorAlloc(void* userData, const size_t size)
+{
+    BucketPool* bucketPool = userData;
+    BucketPoolSizeClass* sizeClass = BucketPoolGetSizeClass(bucketPool, size);
+
+    void* bucket;
+
+    if(ArrayNum(&(sizeClass->idleBuckets)) > 0)
+    {
+        ArrayPopBack(&(sizeClass->idleBuckets), &bucket);
+        bucketPool->idleSize -= size;
+        return bucket;
+    }
+
+    if(ArrayNum(&(sizeClass->purgedBuckets)) > 0)
+    {
+        ArrayPopBack(&(sizeClass->purgedBuckets), &bucket);
+
+        if(VirtualMemoryCommit(bucket, size))
+        {
+            return bucket;
+        }
+
+        // The bucket stays purged, and a fresh one is tried instead.
+        ArrayAdd(&(sizeClass->purgedBuckets), &bucket);
+    }
+
+    if(!BucketPoolIsPageBacked(size))
+    {
+        return AllocatorAlloc(bucketPool->allocator, size);
+    }
+
+    bucket = VirtualMemoryReserve(size);
+
+    if(bucket == NULL)
+    {
+        return NULL;
+    }
+
+    if(!VirtualMemoryCommit(bucket, size))
+    {
+        VirtualMemoryRelease(bucket, size);
+        return NULL;
+    }
+
+    return bucket;
+}
+
+static void* BucketPoolAllocatorRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize)
+{
+    if(memory != NULL && prevSize == newSize)
+    {
+        return memory;
+    }
+
+    void* newMemory = BucketPoolAllocatorAlloc(userData, newSize);
+
+    if(newMemory == NULL)
+    {
+        return NULL;
+    }
+
+    if(memory != NULL)
+    {
+        memcpy(newMemory, memory, prevSize < newSize ? prevSize : newSize);
+        BucketPoolAllocatorFree(userData, memory, prevSize);
+    }
+
+    return newMemory;
+}
+
+static void BucketPoolAllocatorFree(void* userData, void* memory, const size_t size)
+{
+    BucketPool* bucketPool = userData;
+    BucketPoolSizeClass* sizeClass = BucketPoolGetSizeClass(bucketPool, size);
+
+    ArrayAdd(&(sizeClass->idleBuckets), &memory);
+    bucketPool->idleSize += size;
+
+    if(bucketPool->idleSize > bucketPool->maxIdleSize)
+    {
+        BucketPoolTrim(bucketPool, bucketPool->maxIdleSize);
+    }
+}
\ No newline at end of file
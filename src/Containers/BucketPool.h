@@ -0,0 +1,32 @@
+#ifndef BUCKETPOOL_I
+#define BUCKETPOOL_I
+
+#include "../../include/Containers/BucketPool.h"
+#include "Array.h"
+
+/**
+ * @brief The idle buckets of a single size.
+ */
+typedef struct BucketPoolSizeClass
+{
+    size_t bucketSize;      // The memory footprint of 1 bucket in this class.
+    Array idleBuckets;      // Pointers to idle buckets, whose memory is still committed.
+    Array purgedBuckets;    // Pointers to idle buckets, whose memory has been returned to the OS. Only used for buckets of at least a page.
+} BucketPoolSizeClass;
+
+/**
+ * @brief A cache of freed buckets, grouped by their exact size, so containers with the same bucket size can recycle each other's buckets instead of going back to the system allocator.
+ */
+struct BucketPool
+{
+    Array sizeClasses;              // The size classes the pool has seen so far.
+    size_t idleSize;                // The combined memory footprint of all idle, committed buckets.
+    size_t maxIdleSize;             // The watermark above which idle buckets get returned to the OS.
+    const Allocator* allocator;     // The allocator used for buckets smaller than a page, and for the pool itself. NULL for the default allocator.
+    Allocator poolAllocator;        // Allocator interface, allocating from this pool.
+};
+
+void BucketPoolInit(BucketPool* bucketPool, const Allocator* allocator, const size_t maxIdleSize);
+void BucketPoolDeinit(BucketPool* bucketPool);
+
+#endif
\ No newline at end of file
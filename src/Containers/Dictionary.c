@@ -3,6 +3,7 @@
 #include "Math/Math.h"
 #include "Logger.h"
 #include "Utils/Hash.h"
+#include "Utils/Arena.h"
 
 #include <stdint.h>
 #include <stdio.h>
@@ -33,16 +34,39 @@ static void ElementSet(Element* element, Element* nextElement, bool isOccupied,
  */
 Dictionary* DictionaryNew(size_t keySize, size_t valueSize)
 {
-    LogAssert(keySize > 0);
-    LogAssert(valueSize > 0);
+    return DictionaryNewWithAllocator(keySize, valueSize, NULL);
+}
 
-    Dictionary* newDictionary = malloc(sizeof(Dictionary));
+/**
+ * @brief  Creates a new dictionary, whose memory is managed by a given allocator, and initializes it.
+ * @param keySize The memory footprint of the key.
+ * @param valueSize The memory footprint of the value.
+ * @param allocator The allocator to manage the dictionary's memory with. NULL to use the default allocator. This should outlive the dictionary.
+ * @return Dictionary* A pointer to the newly created dictionary.
+ */
+Dictionary* DictionaryNewWithAllocator(size_t keySize, size_t valueSize, const Allocator* allocator)
+{
+    return DictionaryNewWithHash(keySize, valueSize, NULL, allocator);
+}
 
+/**
+ * @brief  Creates a new dictionary, whose keys are hashed with a given hash function, and initializes it.
+ * @param keySize The memory footprint of the key.
+ * @param valueSize The memory footprint of the value.
+ * @param hashFunction The function to hash the keys with, e.g. HashInteger for integer keys. NULL to use HashFast64.
+ * @param allocator The allocator to manage the dictionary's memory with. NULL to use the default allocator. This should outlive the dictionary.
+ * @return Dictionary* A pointer to the newly created dictionary.
+ */
+Dictionary* DictionaryNewWithHash(size_t keySize, size_t valueSize, const HashFunction hashFunction, const Allocator* allocator)
+{
     LogAssert(keySize > 0);
     LogAssert(valueSize > 0);
+
+    Dictionary* newDictionary = AllocatorAlloc(allocator, sizeof(Dictionary));
+
     LogAssert(newDictionary != NULL);
 
-    DictionaryInit(newDictionary, keySize, valueSize);
+    DictionaryInit(newDictionary, keySize, valueSize, hashFunction, allocator);
 
     return newDictionary;
 }
@@ -52,7 +76,7 @@ Dictionary* DictionaryNew(size_t keySize, size_t valueSize)
  * @param dict The dictionary to add the element to.
  * @param key The key of the element.
  * @param value The value of the element.
- * @return void* A pointer to the value associated with the given key, if added successfully. NULL if the given key was already present in the dictionary.
+ * @return void* A pointer to the value associated with the given key, if added successfully. NULL if the given key was already present in the dictionary, or the element could not be allocated.
  */
 void* DictionaryAdd(Dictionary* dict, const void* key, const void* value)
 {
@@ -66,10 +90,10 @@ void* DictionaryAdd(Dictionary* dict, const void* key, const void* value)
         DictionaryResize(dict, ArrayCapacity(&(dict->elements)) * GOLDEN_RATIO);
     }
 
-    uint64_t hash = HashFNV1a64(key, dict->keySize);
+    uint64_t hash = dict->hashFunction(key, dict->keySize);
     uint64_t index = hash % ArrayCapacity(&(dict->elements));
 
-    Element* newElement = (Element*) ArrayGet(&(dict->elements), index);
+    Element* newElement = (Element*) ArrayGetFast(&(dict->elements), index);
 
     if(ElementIsOccupied(newElement))
     {
@@ -111,10 +135,10 @@ void DictionaryRemove(Dictionary* dict, const void* key)
     LogAssert(dict != NULL);
     LogAssert(key != NULL);
 
-    uint64_t hash = HashFNV1a64(key, dict->keySize);
+    uint64_t hash = dict->hashFunction(key, dict->keySize);
     uint64_t index = hash % ArrayCapacity(&(dict->elements));
 
-    Element* elementToRemove = (Element*) ArrayGet(&(dict->elements), index);
+    Element* elementToRemove = (Element*) ArrayGetFast(&(dict->elements), index);
 
     if(ElementIsOccupied(elementToRemove))
     {
@@ -153,10 +177,10 @@ void* DictionaryGet(const Dictionary* dict, const void* key)
     LogAssert(dict != NULL);
     LogAssert(key != NULL);
 
-    uint64_t hash = HashFNV1a64(key, dict->keySize);
+    uint64_t hash = dict->hashFunction(key, dict->keySize);
     uint64_t index = hash % ArrayCapacity(&(dict->elements));
 
-    Element* elementLocation = (Element*) ArrayGet(&(dict->elements), index);
+    Element* elementLocation = (Element*) ArrayGetFast(&(dict->elements), index);
 
     if(ElementIsOccupied(elementLocation))
     {
@@ -191,24 +215,29 @@ void DictionaryResize(Dictionary* dict, const uint64_t newCapacity)
         return;
     }
 
-    char prevElements[ElementSize(dict) * DictionaryNum(dict)];
+    Arena* frameArena = ArenaGetFrame();
+    size_t frameArenaMark = ArenaMark(frameArena);
 
-    void* prevElement = &prevElements;
+    // Elements that don't fit in the frame arena are copied to the dictionary's allocator instead. Without either, the dictionary keeps its capacity.
+    size_t prevElementsSize = ElementSize(dict) * DictionaryNum(dict);
+    char* prevElements = ArenaAlloc(frameArena, prevElementsSize);
+    bool isPrevElementsInArena = prevElements != NULL;
 
-    for(int i = 0; i < ArrayCapacity(&(dict->elements)); i++)
+    if(!isPrevElementsInArena)
     {
-        Element* e = (Element*) ArrayGet(&(dict->elements), i);
+        prevElements = AllocatorAlloc(dict->allocator, prevElementsSize);
 
-        if(e != NULL && ElementIsOccupied(e))
+        if(prevElements == NULL)
         {
-            memcpy(prevElement, e, ElementSize(dict));
-            prevElement += ElementSize(dict);
+            return;
         }
     }
 
-    for(int i = 0; i < BucketArrayNum(&(dict->collisionElements)); i++)
+    void* prevElement = prevElements;
+
+    for(int i = 0; i < ArrayCapacity(&(dict->elements)); i++)
     {
-        Element* e = (Element*) BucketArrayGet(&(dict->collisionElements), i);
+        Element* e = (Element*) ArrayGetFast(&(dict->elements), i);
 
         if(e != NULL && ElementIsOccupied(e))
         {
@@ -217,6 +246,24 @@ void DictionaryResize(Dictionary* dict, const uint64_t newCapacity)
         }
     }
 
+    BucketArrayIterator iterator = BucketArrayIterate(&(dict->collisionElements));
+    void* span;
+    Index spanNum;
+
+    while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
+    {
+        for(Index i = 0; i < spanNum; i++)
+        {
+            Element* e = (Element*) (span + (i * ElementSize(dict)));
+
+            if(ElementIsOccupied(e))
+            {
+                memcpy(prevElement, e, ElementSize(dict));
+                prevElement += ElementSize(dict);
+            }
+        }
+    }
+
     ArrayClear(&(dict->elements));
     ArrayResize(&(dict->elements), newCapacity);
     Element emptyElement;
@@ -236,6 +283,13 @@ void DictionaryResize(Dictionary* dict, const uint64_t newCapacity)
     }
 
     dict->num = prevDictNum;
+
+    if(!isPrevElementsInArena)
+    {
+        AllocatorFree(dict->allocator, prevElements, prevElementsSize);
+    }
+
+    ArenaRewind(frameArena, frameArenaMark);
 }
 
 /**
@@ -246,8 +300,10 @@ void DictionaryFree(Dictionary* dict)
 {
     LogAssert(dict != NULL);
 
+    const Allocator* allocator = dict->allocator;
+
     DictionaryDeinit(dict);
-    free(dict);
+    AllocatorFree(allocator, dict, sizeof(Dictionary));
 }
 
 uint64_t DictionaryNum(const Dictionary* dict)
@@ -263,8 +319,10 @@ uint64_t DictionaryNum(const Dictionary* dict)
  * @param dict The dictionary to be initalized.
  * @param keySize The memory footprint of the key.
  * @param valueSize The memory footprint of the value.
+ * @param hashFunction The function to hash the keys with. NULL to use HashFast64.
+ * @param allocator The allocator to manage the dictionary's memory with. NULL to use the default allocator.
  */
-void DictionaryInit(Dictionary* dict, size_t keySize, size_t valueSize)
+void DictionaryInit(Dictionary* dict, size_t keySize, size_t valueSize, const HashFunction hashFunction, const Allocator* allocator)
 {
     LogAssert(dict != NULL);
     LogAssert(keySize > 0);
@@ -273,13 +331,15 @@ void DictionaryInit(Dictionary* dict, size_t keySize, size_t valueSize)
     dict->keySize = keySize;
     dict->valueSize = valueSize;
     dict->num = 0;
+    dict->hashFunction = hashFunction != NULL ? hashFunction : HashFast64;
+    dict->allocator = allocator;
 
-    ArrayInit(&(dict->elements), ElementSize(dict), (uint64_t) (INITIAL_CAPACITY));
-    Element* emptyElement = malloc(ElementSize(dict));
-    memset(emptyElement, 0, ElementSize(dict));
+    ArrayInit(&(dict->elements), ElementSize(dict), (uint64_t) (INITIAL_CAPACITY), 0, allocator);
+    Element* emptyElement = AllocatorCalloc(allocator, 1, ElementSize(dict));
     ArrayFill(&(dict->elements), emptyElement);
+    AllocatorFree(allocator, emptyElement, ElementSize(dict));
 
-    BucketArrayInit(&(dict->collisionElements), ElementSize(dict), ceil(INITIAL_CAPACITY * (1.0f - MAX_LOAD_FACTOR)));
+    BucketArrayInit(&(dict->collisionElements), ElementSize(dict), ceil(INITIAL_CAPACITY * (1.0f - MAX_LOAD_FACTOR)), 0, allocator);
 }
 
 /**
@@ -302,7 +362,7 @@ void DictionaryDeinit(Dictionary* dict)
  * @param prevElement The previous element to be added, most likely the element which the newly added element collided with.
  * @param key The key of the element to be added.
  * @param value The value of the element to be added.
- * @return Element* A pointer to the newly added element.
+ * @return Element* A pointer to the newly added element. NULL if the key is already present, or the element could not be allocated.
  */
 static Element* AddCollidingElement(Dictionary* dict, Element* prevElement, const void* key, const void* value)
 {
@@ -314,11 +374,37 @@ static Element* AddCollidingElement(Dictionary* dict, Element* prevElement, cons
     Element* nextElement = ElementNextElement(prevElement);
     if(nextElement == NULL)
     {
-        void* newElement = malloc(ElementSize(dict));
+        Arena* frameArena = ArenaGetFrame();
+        size_t frameArenaMark = ArenaMark(frameArena);
 
-        ElementSet(newElement, NULL, true, key, value, dict->keySize, dict->valueSize);
+        void* elementToAdd = ArenaAlloc(frameArena, ElementSize(dict));
+        bool isElementToAddInArena = elementToAdd != NULL;
 
-        newElement = BucketArrayAdd(&(dict->collisionElements), newElement);
+        if(!isElementToAddInArena)
+        {
+            elementToAdd = AllocatorAlloc(dict->allocator, ElementSize(dict));
+
+            if(elementToAdd == NULL)
+            {
+                return NULL;
+            }
+        }
+
+        ElementSet(elementToAdd, NULL, true, key, value, dict->keySize, dict->valueSize);
+
+        void* newElement = BucketArrayAdd(&(dict->collisionElements), elementToAdd);
+
+        if(!isElementToAddInArena)
+        {
+            AllocatorFree(dict->allocator, elementToAdd, ElementSize(dict));
+        }
+
+        ArenaRewind(frameArena, frameArenaMark);
+
+        if(newElement == NULL)
+        {
+            return NULL;
+        }
 
         prevElement->nextElement = newElement;
 
@@ -24,9 +24,11 @@ struct Dictionary
     size_t valueSize;                   // Memory footprint of the value data.
     BucketArray collisionElements;      // Array of elements that collided with other elements in the main array.
     Array elements;                     // The main array of elements.
+    HashFunction hashFunction;          // The function the keys are hashed with.
+    const Allocator* allocator;         // The allocator used for the elements. NULL for the default allocator.
 };
 
-void DictionaryInit(Dictionary* dict, size_t keySize, size_t valueSize);
+void DictionaryInit(Dictionary* dict, size_t keySize, size_t valueSize, const HashFunction hashFunction, const Allocator* allocator);
 void DictionaryDeinit(Dictionary* dict);
 
 size_t DictionaryGetSize(size_t keySize, size_t valueSize);
@@ -0,0 +1,6 @@
+#ifndef INDEX_I
+#define INDEX_I
+
+#include "../../include/Containers/Index.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,101 @@
+#ifndef INLINEARRAY_I
+#define INLINEARRAY_I
+
+#include "Utils/Allocator.h"
+#include "Logger.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/**
+ * @brief Declare a small-buffer-optimized array for element type T, named T##InlineArray. The first inlineCapacity elements are stored inside the struct itself, so tiny collections need no allocation and no pointer chase. Only when more elements are added, the elements move to the heap.
+ * The elements are found through the capacity instead of a pointer to the inline buffer, so the struct can be copied around with memcpy, like when it's a member of a struct stored in an Array.
+ * @param T The element type. This has to be a single identifier, so typedef pointer and qualified types first.
+ * @param inlineCapacity The number of elements stored inside the struct.
+ */
+#define DECLARE_INLINE_ARRAY(T, inlineCapacity)                                                                                                      \
+    typedef struct T##InlineArray                                                                                                                    \
+    {                                                                                                                                                \
+        uint32_t num;                                                                                                                                \
+        uint32_t capacity;                                                                                                                           \
+        union                                                                                                                                        \
+        {                                                                                                                                            \
+            T inlineElements[inlineCapacity];                                                                                                        \
+            T* heapElements;                                                                                                                         \
+        };                                                                                                                                           \
+        const Allocator* allocator;                                                                                                                  \
+    } T##InlineArray;                                                                                                                                \
+                                                                                                                                                     \
+    static inline void T##InlineArrayInit(T##InlineArray* array, const Allocator* allocator)                                                         \
+    {                                                                                                                                                \
+        array->num = 0;                                                                                                                              \
+        array->capacity = inlineCapacity;                                                                                                            \
+        array->allocator = allocator;                                                                                                                \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline void T##InlineArrayDeinit(T##InlineArray* array)                                                                                   \
+    {                                                                                                                                                \
+        if(array->capacity > inlineCapacity)                                                                                                         \
+        {                                                                                                                                            \
+            AllocatorFree(array->allocator, array->heapElements, array->capacity * sizeof(T));                                                       \
+        }                                                                                                                                            \
+                                                                                                                                                     \
+        array->num = 0;                                                                                                                              \
+        array->capacity = inlineCapacity;                                                                                                            \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline T* T##InlineArrayData(T##InlineArray* array)                                                                                       \
+    {                                                                                                                                                \
+        return array->capacity > inlineCapacity ? array->heapElements : array->inlineElements;                                                       \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline T* T##InlineArrayAdd(T##InlineArray* array, const T newElement)                                                                    \
+    {                                                                                                                                                \
+        if(array->num == array->capacity)                                                                                                            \
+        {                                                                                                                                            \
+            uint32_t newCapacity = array->capacity * 2;                                                                                              \
+                                                                                                                                                     \
+            if(array->capacity > inlineCapacity)                                                                                                     \
+            {                                                                                                                                        \
+                array->heapElements = AllocatorRealloc(array->allocator, array->heapElements, array->capacity * sizeof(T), newCapacity * sizeof(T)); \
+            }                                                                                                                                        \
+            else                                                                                                                                     \
+            {                                                                                                                                        \
+                T* heapElements = AllocatorAlloc(array->allocator, newCapacity * sizeof(T));                                                         \
+                memcpy(heapElements, array->inlineElements, array->num * sizeof(T));                                                                 \
+                array->heapElements = heapElements;                                                                                                  \
+            }                                                                                                                                        \
+                                                                                                                                                     \
+            LogAssert(array->heapElements != NULL);                                                                                                  \
+            array->capacity = newCapacity;                                                                                                           \
+        }                                                                                                                                            \
+                                                                                                                                                     \
+        T* location = T##InlineArrayData(array) + array->num++;                                                                                      \
+        *location = newElement;                                                                                                                      \
+        return location;                                                                                                                             \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline T T##InlineArrayPopBack(T##InlineArray* array)                                                                                     \
+    {                                                                                                                                                \
+        LogAssert(array->num > 0);                                                                                                                   \
+        return T##InlineArrayData(array)[--array->num];                                                                                              \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline T* T##InlineArrayGet(T##InlineArray* array, const uint32_t index)                                                                  \
+    {                                                                                                                                                \
+        LogAssert(index < array->num);                                                                                                               \
+        return T##InlineArrayData(array) + index;                                                                                                    \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline uint32_t T##InlineArrayNum(const T##InlineArray* array)                                                                            \
+    {                                                                                                                                                \
+        return array->num;                                                                                                                           \
+    }                                                                                                                                                \
+                                                                                                                                                     \
+    static inline bool T##InlineArrayIsInline(const T##InlineArray* array)                                                                           \
+    {                                                                                                                                                \
+        return array->capacity <= inlineCapacity;                                                                                                    \
+    }
+
+#endif
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "SortedArray.h"
+
+#include "Logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Without -mavx2, GCC and Clang still compile the AVX2 scan into a separate function, which is only called when the CPU supports AVX2.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__AVX2__) || defined(__GNUC__))
+#define SORTED_ARRAY_HAS_AVX2
+#include <immintrin.h>
+
+#ifdef __AVX2__
+#define SORTED_ARRAY_AVX2_FUNCTION
+#else
+#define SORTED_ARRAY_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+static const int INITIAL_CAPACITY = 16;
+
+static uint64_t SortedArraySearch(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool skipEqualKeys);
+static uint64_t SortedArrayCountBelow(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool countEqualKeys);
+#ifdef SORTED_ARRAY_HAS_AVX2
+static SORTED_ARRAY_AVX2_FUNCTION uint64_t SortedArrayCountBelowAVX2(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool countEqualKeys, uint64_t* count);
+#endif
+static int SortedArrayCompareKeys(const void* a, const void* b);
+
+/**
+ * @brief Creates a new sorted array, and initializes it.
+ * @return SortedArray* A pointer to the newly created sorted array.
+ */
+SortedArray* SortedArrayNew()
+{
+    return SortedArrayNewWithAllocator(NULL);
+}
+
+/**
+ * @brief Creates a new sorted array, whose memory is managed by a given allocator, and initializes it.
+ * @param allocator The allocator to manage the sorted array's memory with. NULL to use the default allocator. This should outlive the sorted array.
+ * @return SortedArray* A pointer to the newly created sorted array.
+ */
+SortedArray* SortedArrayNewWithAllocator(const Allocator* allocator)
+{
+    SortedArray* newSortedArray = AllocatorAlloc(allocator, sizeof(SortedArray));
+    LogAssert(newSortedArray != NULL);
+
+    SortedArrayInit(newSortedArray, allocator);
+
+    return newSortedArray;
+}
+
+/**
+ * @brief Insert a key at its sorted position. Keys equal to it stay in front of it. The keys after it get moved back in a single move.
+ * @param sortedArray The sorted array to insert the key into.
+ * @param key The key to insert.
+ * @return uint64_t The index the key ended up at.
+ */
+uint64_t SortedArrayInsert(SortedArray* sortedArray, const uint64_t key)
+{
+    LogAssert(sortedArray != NULL);
+
+    uint64_t index = SortedArrayUpperBound(sortedArray, key);
+    ArrayInsert(&(sortedArray->keys), index, &key, 1);
+
+    return index;
+}
+
+/**
+ * @brief Add many keys at once. The keys are appended in a single copy and sorted once afterwards, which is a lot cheaper than inserting them one by one.
+ * @param sortedArray The sorted array to add the keys to.
+ * @param keys The keys to add. These don't have to be sorted.
+ * @param numKeys The number of keys to add.
+ */
+void SortedArrayBuild(SortedArray* sortedArray, const uint64_t keys[], const uint64_t numKeys)
+{
+    LogAssert(sortedArray != NULL);
+    LogAssert(keys != NULL || numKeys == 0);
+
+    ArrayAppend(&(sortedArray->keys), keys, numKeys);
+    qsort(sortedArray->keys.elements, sortedArray->keys.num, sizeof(uint64_t), SortedArrayCompareKeys);
+}
+
+/**
+ * @brief Remove a single instance of a key, keeping the order of the remaining keys.
+ * @param sortedArray The sorted array to remove the key from.
+ * @param key The key to remove.
+ * @return bool Wether or not the key was present.
+ */
+bool SortedArrayRemove(SortedArray* sortedArray, const uint64_t key)
+{
+    LogAssert(sortedArray != NULL);
+
+    uint64_t index = SortedArrayLowerBound(sortedArray, key);
+
+    if(index >= sortedArray->keys.num || *(uint64_t*) ArrayGetFast(&(sortedArray->keys), index) != key)
+    {
+        return false;
+    }
+
+    ArrayErase(&(sortedArray->keys), index, 1);
+    return true;
+}
+
+/**
+ * @brief Check wether a key is present in the sorted array.
+ * @param sortedArray The sorted array to check.
+ * @param key The key to look for.
+ * @return bool Wether or not the key is present.
+ */
+bool SortedArrayContains(const SortedArray* sortedArray, const uint64_t key)
+{
+    LogAssert(sortedArray != NULL);
+
+    uint64_t index = SortedArrayLowerBound(sortedArray, key);
+
+    return index < sortedArray->keys.num && *(uint64_t*) ArrayGetFast(&(sortedArray->keys), index) == key;
+}
+
+/**
+ * @brief Find the first key that is not smaller than a given key.
+ * @param sortedArray The sorted array to search.
+ * @param key The key to search for.
+ * @return uint64_t The index of the first key that is equal to or bigger than the given key. The number of keys if there is none.
+ */
+uint64_t SortedArrayLowerBound(const SortedArray* sortedArray, const uint64_t key)
+{
+    LogAssert(sortedArray != NULL);
+
+    return SortedArraySearch(sortedArray->keys.elements, sortedArray->keys.num, key, false);
+}
+
+/**
+ * @brief Find the first key that is bigger than a given key.
+ * @param sortedArray The sorted array to search.
+ * @param key The key to search for.
+ * @return uint64_t The index of the first key that is bigger than the given key. The number of keys if there is none.
+ */
+uint64_t SortedArrayUpperBound(const SortedArray* sortedArray, const uint64_t key)
+{
+    LogAssert(sortedArray != NULL);
+
+    return SortedArraySearch(sortedArray->keys.elements, sortedArray->keys.num, key, true);
+}
+
+/**
+ * @brief Retrieve the key at a specific index.
+ * @param sortedArray The sorted array to retrieve the key from.
+ * @param index The index at which to find the key.
+ * @return uint64_t The key at that index.
+ */
+uint64_t SortedArrayGet(const SortedArray* sortedArray, const uint64_t index)
+{
+    LogAssert(sortedArray != NULL);
+    LogAssert(index < sortedArray->keys.num);
+
+    return *(uint64_t*) ArrayGetFast(&(sortedArray->keys), index);
+}
+
+/**
+ * @brief Remove all keys from the sorted array. Doesn't change its capacity.
+ * @param sortedArray The sorted array to be cleared.
+ */
+void SortedArrayClear(SortedArray* sortedArray)
+{
+    LogAssert(sortedArray != NULL);
+
+    ArrayClear(&(sortedArray->keys));
+}
+
+/**
+ * @brief Free the sorted array.
+ * @param sortedArray The sorted array to free.
+ */
+void SortedArrayFree(SortedArray* sortedArray)
+{
+    LogAssert(sortedArray != NULL);
+
+    const Allocator* allocator = sortedArray->keys.allocator;
+
+    SortedArrayDeinit(sortedArray);
+    AllocatorFree(allocator, sortedArray, sizeof(SortedArray));
+}
+
+/**
+ * @brief Get the number of keys present in the sorted array.
+ * @param sortedArray The sorted array to get the number of keys from.
+ * @return uint64_t The number of keys in the sorted array.
+ */
+uint64_t SortedArrayNum(const SortedArray* sortedArray)
+{
+    LogAssert(sortedArray != NULL);
+
+    return sortedArray->keys.num;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Initialize an existing sorted array. Only used internally. When calling SortedArrayNew, the sorted array will already be initialized.
+ * @param sortedArray The sorted array to be initialized.
+ * @param allocator The allocator to manage the sorted array's memory with. NULL to use the default allocator.
+ */
+void SortedArrayInit(SortedArray* sortedArray, const Allocator* allocator)
+{
+    LogAssert(sortedArray != NULL);
+
+    ArrayInit(&(sortedArray->keys), sizeof(uint64_t), INITIAL_CAPACITY, 0, allocator);
+}
+
+/**
+ * @brief Deinitialize the sorted array. This does not free the sorted array pointer. Use this function instead of free if the sorted array is stack allocated or allocated locally as a struct member.
+ * @param sortedArray The sorted array to deinitialize.
+ */
+void SortedArrayDeinit(SortedArray* sortedArray)
+{
+    LogAssert(sortedArray != NULL);
+
+    ArrayDeinit(&(sortedArray->keys));
+}
+
+/**
+ * @brief Check wether small sorted arrays are searched with AVX2. This needs a CPU with AVX2.
+ * @return bool Wether or not the linear scan compares 4 keys at a time.
+ */
+bool SortedArrayIsVectorized()
+{
+#ifdef SORTED_ARRAY_HAS_AVX2
+#ifdef __AVX2__
+    return true;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+#else
+    return false;
+#endif
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Find the number of keys that come before a given key, in a sorted list of keys.
+ * The binary search halves the remaining range every step, selecting the half with a conditional move instead of a branch, so it never mispredicts. Small ranges are counted linearly instead.
+ * @param keys The sorted keys to search.
+ * @param numKeys The number of keys.
+ * @param key The key to search for.
+ * @param skipEqualKeys Wether keys equal to the given key come before it (upper bound) or not (lower bound).
+ * @return uint64_t The index of the first key that comes after the given key.
+ */
+static uint64_t SortedArraySearch(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool skipEqualKeys)
+{
+    if(numKeys <= SORTED_ARRAY_LINEAR_SEARCH_MAX_NUM)
+    {
+        return SortedArrayCountBelow(keys, numKeys, key, skipEqualKeys);
+    }
+
+    const uint64_t* base = keys;
+    uint64_t numKeysLeft = numKeys;
+
+    while(numKeysLeft > 1)
+    {
+        uint64_t half = numKeysLeft / 2;
+        uint64_t lastKeyOfHalf = base[half - 1];
+        bool halfComesBefore = skipEqualKeys ? lastKeyOfHalf <= key : lastKeyOfHalf < key;
+
+        base += halfComesBefore ? half : 0;
+        numKeysLeft -= half;
+    }
+
+    bool lastKeyComesBefore = skipEqualKeys ? *base <= key : *base < key;
+
+    return (base - keys) + lastKeyComesBefore;
+}
+
+/**
+ * @brief Count the keys that are smaller than a given key, with a linear scan. For sorted keys, this is the index of the given key.
+ * @param keys The keys to count.
+ * @param numKeys The number of keys.
+ * @param key The key to compare against.
+ * @param countEqualKeys Wether or not keys equal to the given key are counted as well.
+ * @return uint64_t The number of keys smaller than (or equal to) the given key.
+ */
+static uint64_t SortedArrayCountBelow(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool countEqualKeys)
+{
+    uint64_t count = 0;
+    uint64_t i = 0;
+
+#ifdef SORTED_ARRAY_HAS_AVX2
+    if(SortedArrayIsVectorized())
+    {
+        i = SortedArrayCountBelowAVX2(keys, numKeys, key, countEqualKeys, &count);
+    }
+#endif
+
+    for(; i < numKeys; ++i)
+    {
+        count += countEqualKeys ? keys[i] <= key : keys[i] < key;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Compare 2 keys, for sorting them in ascending order.
+ * @param a A pointer to the first key.
+ * @param b A pointer to the second key.
+ * @return int Negative if the first key is smaller, positive if it's bigger, 0 if they are equal.
+ */
+static int SortedArrayCompareKeys(const void* a, const void* b)
+{
+    uint64_t keyA = *(const uint64_t*) a;
+    uint64_t keyB = *(const uint64_t*) b;
+
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+#ifdef SORTED_ARRAY_HAS_AVX2
+/**
+ * @brief The AVX2 part of SortedArrayCountBelow, comparing the keys 4 at a time. Only call this when SortedArrayIsVectorized.
+ * @param keys The keys to count.
+ * @param numKeys The number of keys.
+ * @param key The key to compare against.
+ * @param countEqualKeys Wether or not keys equal to the given key are counted as well.
+ * @param count The number of keys smaller than (or equal to) the given key, to which the compared keys are added.
+ * @return uint64_t The number of keys compared. The rest is left to the scalar loop.
+ */
+static SORTED_ARRAY_AVX2_FUNCTION uint64_t SortedArrayCountBelowAVX2(const uint64_t keys[], const uint64_t numKeys, const uint64_t key, const bool countEqualKeys, uint64_t* count)
+{
+    // AVX2 only compares signed 64 bit integers, so flipping the sign bits turns the unsigned order into the signed one.
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i keyVector = _mm256_xor_si256(_mm256_set1_epi64x(key), signBits);
+
+    uint64_t i = 0;
+
+    for(; i + 4 <= numKeys; i += 4)
+    {
+        __m256i keysVector = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*) (keys + i)), signBits);
+
+        if(countEqualKeys)
+        {
+            __m256i isAbove = _mm256_cmpgt_epi64(keysVector, keyVector);
+            *count += 4 - __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(isAbove)));
+        }
+        else
+        {
+            __m256i isBelow = _mm256_cmpgt_epi64(keyVector, keysVector);
+            *count += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(isBelow)));
+        }
+    }
+
+    return i;
+}
+#endif
\ No newline at end of file
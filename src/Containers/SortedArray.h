@@ -0,0 +1,24 @@
+#ifndef SORTEDARRAY_I
+#define SORTEDARRAY_I
+
+#include "../../include/Containers/SortedArray.h"
+#include "Array.h"
+
+/**
+ * @brief Up to this many keys, the bounds are found by counting the smaller keys with a linear (SIMD) scan, which beats the unpredictable memory accesses of a binary search.
+ */
+#define SORTED_ARRAY_LINEAR_SEARCH_MAX_NUM 32
+
+/**
+ * @brief An array of 64 bit keys, kept in ascending order, so keys can be found with a binary search instead of a linear scan. The same key can be present multiple times.
+ */
+struct SortedArray
+{
+    Array keys;     // The keys, in ascending order.
+};
+
+void SortedArrayInit(SortedArray* sortedArray, const Allocator* allocator);
+void SortedArrayDeinit(SortedArray* sortedArray);
+bool SortedArrayIsVectorized();
+
+#endif
\ No newline at end of file
@@ -6,6 +6,28 @@
 #include <string.h>
 #include <math.h>
 
+// The gathers need 64 bit indices. Without -mavx2, GCC and Clang still compile them into a separate function, which is only called when the CPU supports AVX2.
+#if !defined(INDEX_32) && (defined(__x86_64__) || defined(_M_X64)) && (defined(__AVX2__) || defined(__GNUC__))
+#define SPARSE_SET_HAS_AVX2
+#include <immintrin.h>
+
+#ifdef __AVX2__
+#define SPARSE_SET_AVX2_FUNCTION
+#else
+#define SPARSE_SET_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+static void SparseSetInitSparseData(SparseSet* sparseSet, const Index(*getIndexFromDataFunc)(const void*), const Allocator* allocator);
+static void SparseSetCoverSparseIndex(SparseSet* sparseSet, const Index index);
+static void SparseSetMarkChanged(SparseSet* sparseSet);
+static uint64_t SparseSetReleaseBuckets(SparseSet* sparseSet, const uint64_t maxSteps);
+static uint64_t SparseSetReorder(SparseSet* sparseSet, const uint64_t maxSteps);
+static uint64_t SparseSetFindCandidates(SparseSet* sparseSet, const Index indices[], const uint8_t numIndices, Index denseIndices[]);
+#ifdef SPARSE_SET_HAS_AVX2
+static SPARSE_SET_AVX2_FUNCTION uint8_t SparseSetFindCandidatesAVX2(const SparseSet* sparseSet, const Index indices[], const uint8_t numIndices, Index denseIndices[], uint64_t* candidates);
+#endif
+
 /**
  * @brief Creates a new Sparse set, and initializes it.
  * @param elementSize The memory footprint of 1 element.
@@ -14,15 +36,70 @@
  * @param bucketCapacity
  * @return SparseSet*
  */
-SparseSet* SparseSetNew(const size_t elementSize, const uint64_t(*getIndexFromDataFunc)(const void*), const uint64_t bucketCapacity)
+SparseSet* SparseSetNew(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index bucketCapacity)
+{
+    return SparseSetNewWithAllocator(elementSize, getIndexFromDataFunc, bucketCapacity, NULL);
+}
+
+/**
+ * @brief Creates a new Sparse set, whose memory is managed by a given allocator, and initializes it.
+ * @param elementSize The memory footprint of 1 element.
+ * @param getIndexFromDataFunc A function pointer to retreive an identifier or index from a given element.
+ * @param bucketCapacity The number of elements a bucket of the sparse and dense data can hold.
+ * @param allocator The allocator to manage the sparse set's memory with. NULL to use the default allocator. This should outlive the sparse set.
+ * @return SparseSet*
+ */
+SparseSet* SparseSetNewWithAllocator(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index bucketCapacity, const Allocator* allocator)
 {
     LogAssert(getIndexFromDataFunc != NULL);
     LogAssert(bucketCapacity > 0);
 
-    SparseSet* newSparseSet = malloc(sizeof(SparseSet));
+    SparseSet* newSparseSet = AllocatorAlloc(allocator, sizeof(SparseSet));
+    LogAssert(newSparseSet != NULL);
+
+    SparseSetInit(newSparseSet, elementSize, getIndexFromDataFunc, bucketCapacity, 0, allocator);
+
+    return newSparseSet;
+}
+
+/**
+ * @brief Creates a new Sparse set, whose sparse and dense data use a geometric bucket layout, and initializes it.
+ * @param elementSize The memory footprint of 1 element.
+ * @param getIndexFromDataFunc A function pointer to retreive an identifier or index from a given element.
+ * @param firstBucketCapacity The number of elements the first bucket can hold. This gets rounded up to a power of 2.
+ * @return SparseSet*
+ */
+SparseSet* SparseSetNewGeometric(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index firstBucketCapacity)
+{
+    LogAssert(getIndexFromDataFunc != NULL);
+    LogAssert(firstBucketCapacity > 0);
+
+    SparseSet* newSparseSet = AllocatorAlloc(NULL, sizeof(SparseSet));
+    LogAssert(newSparseSet != NULL);
+
+    SparseSetInitGeometric(newSparseSet, elementSize, getIndexFromDataFunc, firstBucketCapacity, 0, NULL);
+
+    return newSparseSet;
+}
+
+/**
+ * @brief Creates a new Sparse set, whose dense data is stored contiguously in a reserved range of address space, and initializes it.
+ * @param elementSize The memory footprint of 1 element.
+ * @param getIndexFromDataFunc A function pointer to retreive an identifier or index from a given element.
+ * @param firstBucketCapacity The number of indices the first bucket of the sparse data can hold. This gets rounded up to a power of 2.
+ * @param maxNumElements The maximum number of elements the sparse set will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the dense data with transparent huge pages.
+ * @return SparseSet*
+ */
+SparseSet* SparseSetNewReserved(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index firstBucketCapacity, const Index maxNumElements, const bool useHugePages)
+{
+    LogAssert(getIndexFromDataFunc != NULL);
+    LogAssert(firstBucketCapacity > 0);
+
+    SparseSet* newSparseSet = AllocatorAlloc(NULL, sizeof(SparseSet));
     LogAssert(newSparseSet != NULL);
 
-    SparseSetInit(newSparseSet, elementSize, getIndexFromDataFunc, bucketCapacity);
+    SparseSetInitReserved(newSparseSet, elementSize, getIndexFromDataFunc, firstBucketCapacity, maxNumElements, useHugePages, NULL);
 
     return newSparseSet;
 }
@@ -32,95 +109,222 @@ void SparseSetAdd(SparseSet* sparseSet, const void* newElement)
     LogAssert(sparseSet != NULL);
     LogAssert(newElement != NULL);
 
-    uint64_t index = sparseSet->getIndexFromDataFunc(newElement);
+    Index index = sparseSet->getIndexFromDataFunc(newElement);
 
-    if(index >= BucketArrayNum(&(sparseSet->sparseData)))
-    {
-        BucketArrayResize(&(sparseSet->sparseData), index);
-        uint64_t firstBucketIndexToSet = ceil(BucketArrayNum(&(sparseSet->sparseData)) / BucketArrayBucketCapacity(&(sparseSet->sparseData)));
+    SparseSetCoverSparseIndex(sparseSet, index);
 
-        for(int i = firstBucketIndexToSet; i < BucketArrayNumBuckets(&(sparseSet->sparseData)); i++)
-        {
-            void* bucket = BucketArrayGetBucket(&(sparseSet->sparseData), i);
-            memset(bucket, 0, BucketArrayBucketCapacity(&(sparseSet->sparseData)) * sizeof(uint64_t));
-        }
+    if(SparseSetContainsFast(sparseSet, index))
+    {
+        return;
     }
 
-    if(SparseSetContains(sparseSet, index))
+    SparseSetMarkChanged(sparseSet);
+
+    if(index < sparseSet->releaseCursor)
     {
-        return;
+        sparseSet->releaseCursor = 0;
     }
 
-    uint64_t elementIndexInDenseData = BucketArrayNum(&(sparseSet->denseData));
+    Index elementIndexInDenseData = BucketArrayNum(&(sparseSet->denseData));
 
     BucketArrayAdd(&(sparseSet->denseData), newElement);
 
-    uint64_t* elementInSparseData = (uint64_t*) BucketArrayGet(&(sparseSet->sparseData), index);
+    Index* elementInSparseData = (Index*) BucketArrayGetFast(&(sparseSet->sparseData), index);
     *elementInSparseData = elementIndexInDenseData;
 }
 
-void SparseSetRemove(SparseSet* sparseSet, const uint64_t index)
+/**
+ * @brief Add a range of elements to the sparse set. The sparse and dense data are grown once for the whole range, instead of once per element. Elements whose index is already present are skipped.
+ * @param sparseSet The sparse set to add the elements to.
+ * @param newElements A pointer to the first of the contiguous elements to add.
+ * @param numElements The number of elements to add.
+ */
+void SparseSetAddRange(SparseSet* sparseSet, const void* newElements, const Index numElements)
 {
     LogAssert(sparseSet != NULL);
+    LogAssert(newElements != NULL || numElements == 0);
 
-    uint64_t oldDenseIndex = *(uint64_t*) BucketArrayGet(&(sparseSet->sparseData), index);
-    LogAssert(oldDenseIndex < BucketArrayNum(&(sparseSet->denseData)));
-
-    if(!SparseSetContains(sparseSet, oldDenseIndex))
+    if(numElements == 0)
     {
         return;
     }
 
-    if(oldDenseIndex != BucketArrayNum(&(sparseSet->denseData)) - 1)
+    size_t elementSize = sparseSet->denseData.elementSize;
+    Index maxIndex = 0;
+
+    for(Index i = 0; i < numElements; ++i)
     {
-        void* oldDenseElement = BucketArrayGet(&(sparseSet->denseData), oldDenseIndex);
-        void* lastDenseElement = BucketArrayGet(&(sparseSet->denseData), BucketArrayNum(&(sparseSet->denseData)) - 1);
-        memcpy(oldDenseElement, lastDenseElement, sparseSet->denseData.elementSize);
+        maxIndex = fmax(maxIndex, sparseSet->getIndexFromDataFunc(newElements + ((size_t) i * elementSize)));
+    }
+
+    SparseSetCoverSparseIndex(sparseSet, maxIndex);
+    BucketArrayReserve(&(sparseSet->denseData), BucketArrayNum(&(sparseSet->denseData)) + numElements);
+
+    SparseSetMarkChanged(sparseSet);
+    sparseSet->releaseCursor = 0;
+
+    for(Index i = 0; i < numElements; ++i)
+    {
+        const void* newElement = newElements + ((size_t) i * elementSize);
+        Index index = sparseSet->getIndexFromDataFunc(newElement);
+
+        if(SparseSetContainsFast(sparseSet, index))
+        {
+            continue;
+        }
+
+        *(Index*) BucketArrayGetFast(&(sparseSet->sparseData), index) = BucketArrayNum(&(sparseSet->denseData));
+        BucketArrayAdd(&(sparseSet->denseData), newElement);
+    }
+}
 
-        uint64_t* lastDenseElementNewSparseIndex = (uint64_t*) BucketArrayGet(&(sparseSet->sparseData), sparseSet->getIndexFromDataFunc(lastDenseElement));
-        *lastDenseElementNewSparseIndex = oldDenseIndex;
+void SparseSetRemove(SparseSet* sparseSet, const Index index)
+{
+    LogAssert(sparseSet != NULL);
+
+    if(!SparseSetContainsFast(sparseSet, index))
+    {
+        return;
     }
 
-    BucketArrayPopBack(&(sparseSet->denseData), NULL);
+    Index oldDenseIndex = *(Index*) BucketArrayGetFast(&(sparseSet->sparseData), index);
+    LogAssert(oldDenseIndex < BucketArrayNum(&(sparseSet->denseData)));
+
+    SparseSetMarkChanged(sparseSet);
+
+    BucketArraySwapRemove(&(sparseSet->denseData), oldDenseIndex, NULL);
+
+    if(oldDenseIndex < BucketArrayNum(&(sparseSet->denseData)))
+    {
+        void* movedDenseElement = BucketArrayGetFast(&(sparseSet->denseData), oldDenseIndex);
+
+        Index* movedDenseElementNewSparseIndex = (Index*) BucketArrayGetFast(&(sparseSet->sparseData), sparseSet->getIndexFromDataFunc(movedDenseElement));
+        *movedDenseElementNewSparseIndex = oldDenseIndex;
+    }
 }
 
-void* SparseSetGet(SparseSet* sparseSet, const uint64_t index)
+void* SparseSetGet(SparseSet* sparseSet, const Index index)
 {
     LogAssert(sparseSet);
+    LogAssert(SparseSetContainsFast(sparseSet, index));
+
+    return SparseSetGetFast(sparseSet, index);
+}
+
+bool SparseSetContains(SparseSet* sparseSet, const Index index)
+{
+    LogAssert(sparseSet != NULL);
 
-    uint64_t denseIndex = *(uint64_t*) BucketArrayGet(&(sparseSet->sparseData), index);
-    return BucketArrayGet(&(sparseSet->denseData), denseIndex);
+    return SparseSetContainsFast(sparseSet, index);
 }
 
-bool SparseSetContains(SparseSet* sparseSet, const uint64_t index)
+/**
+ * @brief Check for a block of indices at once, which of them are present in the sparse set.
+ * @param sparseSet The sparse set to check.
+ * @param indices The indices to check.
+ * @param numIndices The number of indices to check. This can be at most SPARSE_SET_MAX_BATCH_SIZE.
+ * @return uint64_t A bitmask, in which bit i is set if indices[i] is present in the sparse set.
+ */
+uint64_t SparseSetContainsBatch(SparseSet* sparseSet, const Index indices[], const uint8_t numIndices)
 {
     LogAssert(sparseSet != NULL);
+    LogAssert(indices != NULL);
+    LogAssert(numIndices <= SPARSE_SET_MAX_BATCH_SIZE);
 
-    if(index >= BucketArrayNum(&(sparseSet->sparseData)))
+    Index denseIndices[SPARSE_SET_MAX_BATCH_SIZE];
+    uint64_t candidates = SparseSetFindCandidates(sparseSet, indices, numIndices, denseIndices);
+    uint64_t result = 0;
+
+    // A stale sparse slot can still point at a valid dense position, so every candidate is verified against the element stored there.
+    while(candidates != 0)
     {
-        return false;
+        int i = __builtin_ctzll(candidates);
+        candidates &= candidates - 1;
+
+        void* elementInDenseData = BucketArrayGetFast(&(sparseSet->denseData), denseIndices[i]);
+
+        if(sparseSet->getIndexFromDataFunc(elementInDenseData) == indices[i])
+        {
+            result |= (uint64_t) 1 << i;
+        }
     }
 
-    uint64_t indexInDenseData = *(uint64_t*) BucketArrayGet(&(sparseSet->sparseData), index);
+    return result;
+}
+
+/**
+ * @brief Check wether SparseSetContainsBatch looks the sparse slots up with AVX2 gathers. This needs a CPU with AVX2, 64 bit indices, and sparse buckets that are geometric or have a power of 2 capacity.
+ * @param sparseSet The sparse set to check.
+ * @return bool Wether or not batches are looked up 4 indices at a time.
+ */
+bool SparseSetBatchIsVectorized(const SparseSet* sparseSet)
+{
+    LogAssert(sparseSet != NULL);
 
-    if(indexInDenseData >= BucketArrayNum(&(sparseSet->denseData)))
+#ifdef SPARSE_SET_HAS_AVX2
+#ifndef __AVX2__
+    if(!__builtin_cpu_supports("avx2"))
     {
         return false;
     }
+#endif
 
-    void* elementInDenseData = BucketArrayGet(&(sparseSet->denseData), indexInDenseData);
+    const BucketArray* sparseData = &(sparseSet->sparseData);
+    const Index bucketCapacity = sparseData->bucketCapacity;
 
-    uint64_t indexInSparseData = sparseSet->getIndexFromDataFunc(elementInDenseData);
+    // The geometric path converts the offset index to a double to find its highest set bit, which is exact below 2^52.
+    if(sparseData->layout == BUCKET_ARRAY_LAYOUT_GEOMETRIC)
+    {
+        return sparseData->num + bucketCapacity < ((uint64_t) 1 << 52);
+    }
 
-    return index == indexInSparseData;
+    return (bucketCapacity & (bucketCapacity - 1)) == 0;
+#else
+    return false;
+#endif
 }
 
 void SparseSetFree(SparseSet* sparseSet)
 {
     LogAssert(sparseSet != NULL);
 
+    const Allocator* allocator = sparseSet->allocator;
+
     SparseSetDeinit(sparseSet);
-    free(sparseSet);
+    AllocatorFree(allocator, sparseSet, sizeof(SparseSet));
+}
+
+/**
+ * @brief Incrementally compact the sparse set. Each call performs a bounded amount of work, so this can be called every frame without causing a stop-the-world pause.
+ * Trailing sparse buckets that no longer reference any element are released first, followed by trailing dense buckets. A large sparse bucket is scanned over multiple calls if needed. If requested, the dense elements are then reordered by their sparse index, to improve the locality of iteration.
+ * @param sparseSet The sparse set to compact.
+ * @param maxSteps The maximum amount of work to perform, expressed in inspected sparse slots and released buckets.
+ * @param reorderDenseData Wether or not the dense elements should be reordered by their sparse index.
+ * @param isCompact Set to wether or not the sparse set is fully compacted after this call. NULL if not needed.
+ * @return uint64_t The amount of work performed.
+ */
+uint64_t SparseSetCompact(SparseSet* sparseSet, const uint64_t maxSteps, const bool reorderDenseData, bool* isCompact)
+{
+    LogAssert(sparseSet != NULL);
+
+    uint64_t steps = 0;
+
+    if(!sparseSet->isCompact)
+    {
+        steps += SparseSetReleaseBuckets(sparseSet, maxSteps);
+    }
+
+    if(reorderDenseData && sparseSet->isCompact && !sparseSet->isReordered)
+    {
+        steps += SparseSetReorder(sparseSet, maxSteps - steps);
+    }
+
+    if(isCompact != NULL)
+    {
+        *isCompact = sparseSet->isCompact && (!reorderDenseData || sparseSet->isReordered);
+    }
+
+    return steps;
 }
 
 BucketArray* SparseSetGetDenseData(SparseSet* sparseSet)
@@ -129,18 +333,47 @@ BucketArray* SparseSetGetDenseData(SparseSet* sparseSet)
     return &(sparseSet->denseData);
 }
 
-void SparseSetInit(SparseSet* sparseSet, const size_t elementSize, const uint64_t(*getIndexFromDataFunc)(const void*), uint64_t bucketCapacity)
+void SparseSetInit(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index bucketCapacity, const size_t alignment, const Allocator* allocator)
 {
     LogAssert(sparseSet != NULL);
     LogAssert(bucketCapacity > 0);
 
-    BucketArrayInit(&(sparseSet->denseData), elementSize, bucketCapacity);
-    BucketArrayInit(&(sparseSet->sparseData), sizeof(uint64_t), bucketCapacity);
+    BucketArrayInit(&(sparseSet->denseData), elementSize, bucketCapacity, alignment, allocator);
+    BucketArrayInit(&(sparseSet->sparseData), sizeof(Index), bucketCapacity, 0, allocator);
 
-    uint64_t emptyIndex = 0;
-    BucketArrayFill(&(sparseSet->sparseData), &emptyIndex);
+    SparseSetInitSparseData(sparseSet, getIndexFromDataFunc, allocator);
+}
 
-    sparseSet->getIndexFromDataFunc = getIndexFromDataFunc;
+void SparseSetInitGeometric(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index firstBucketCapacity, const size_t alignment, const Allocator* allocator)
+{
+    LogAssert(sparseSet != NULL);
+    LogAssert(firstBucketCapacity > 0);
+
+    BucketArrayInitGeometric(&(sparseSet->denseData), elementSize, firstBucketCapacity, alignment, allocator);
+    BucketArrayInitGeometric(&(sparseSet->sparseData), sizeof(Index), firstBucketCapacity, 0, allocator);
+
+    SparseSetInitSparseData(sparseSet, getIndexFromDataFunc, allocator);
+}
+
+/**
+ * @brief Initialize an existing sparse set, whose dense data is stored contiguously in a reserved range of address space. The sparse data uses a geometric bucket layout.
+ * @param sparseSet The sparse set to be initialized.
+ * @param elementSize The memory footprint of 1 element.
+ * @param getIndexFromDataFunc A function pointer to retreive an identifier or index from a given element.
+ * @param firstBucketCapacity The number of indices the first bucket of the sparse data can hold. This gets rounded up to a power of 2.
+ * @param maxNumElements The maximum number of elements the sparse set will ever hold.
+ * @param useHugePages Wether or not to hint the OS to back the dense data with transparent huge pages.
+ * @param allocator The allocator to manage the sparse data with. NULL to use the default allocator.
+ */
+void SparseSetInitReserved(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index firstBucketCapacity, const Index maxNumElements, const bool useHugePages, const Allocator* allocator)
+{
+    LogAssert(sparseSet != NULL);
+    LogAssert(firstBucketCapacity > 0);
+
+    BucketArrayInitReserved(&(sparseSet->denseData), elementSize, maxNumElements, useHugePages, allocator);
+    BucketArrayInitGeometric(&(sparseSet->sparseData), sizeof(Index), firstBucketCapacity, 0, allocator);
+
+    SparseSetInitSparseData(sparseSet, getIndexFromDataFunc, allocator);
 }
 
 void SparseSetDeinit(SparseSet* sparseSet)
@@ -151,3 +384,280 @@ void SparseSetDeinit(SparseSet* sparseSet)
     BucketArrayDeinit(&(sparseSet->sparseData));
 }
 
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Initialize the sparse data and bookkeeping of a sparse set, whose sparse and dense bucketArrays have already been initialized.
+ * @param sparseSet The sparse set to be initialized.
+ * @param getIndexFromDataFunc A function pointer to retreive an identifier or index from a given element.
+ * @param allocator The allocator the sparse and dense data were initialized with.
+ */
+static void SparseSetInitSparseData(SparseSet* sparseSet, const Index(*getIndexFromDataFunc)(const void*), const Allocator* allocator)
+{
+    Index emptyIndex = 0;
+    BucketArrayFill(&(sparseSet->sparseData), &emptyIndex);
+
+    sparseSet->getIndexFromDataFunc = getIndexFromDataFunc;
+    sparseSet->releaseCursor = 0;
+    sparseSet->reorderCursor = 0;
+    sparseSet->numReordered = 0;
+    sparseSet->isCompact = true;
+    sparseSet->isReordered = true;
+    sparseSet->allocator = allocator;
+}
+
+/**
+ * @brief Note that elements were added or removed, so the sparse set has to be compacted again, and any reordering in progress starts over.
+ * @param sparseSet The sparse set that changed.
+ */
+static void SparseSetMarkChanged(SparseSet* sparseSet)
+{
+    sparseSet->isCompact = false;
+    sparseSet->isReordered = false;
+    sparseSet->reorderCursor = 0;
+    sparseSet->numReordered = 0;
+}
+
+/**
+ * @brief Release trailing sparse buckets that reference no element, followed by trailing dense buckets. The slots of the last sparse bucket are scanned from the release cursor on, so a bucket larger than maxSteps is scanned over multiple calls.
+ * @param sparseSet The sparse set whose buckets to release.
+ * @param maxSteps The maximum number of sparse slots to inspect and buckets to release.
+ * @return uint64_t The amount of work performed.
+ */
+static uint64_t SparseSetReleaseBuckets(SparseSet* sparseSet, const uint64_t maxSteps)
+{
+    uint64_t steps = 0;
+    BucketArray* sparseData = &(sparseSet->sparseData);
+    BucketArray* denseData = &(sparseSet->denseData);
+
+    while(BucketArrayNumBuckets(sparseData) > 1)
+    {
+        Index lastBucketIndex = BucketArrayNumBuckets(sparseData) - 1;
+        Index firstIndexInBucket = BucketArrayCapacityOfBuckets(sparseData, lastBucketIndex);
+        Index endIndexInBucket = firstIndexInBucket + BucketArrayBucketSize(sparseData, lastBucketIndex);
+
+        // A cursor at the end of the bucket means the whole bucket was found unused by the previous call.
+        if(sparseSet->releaseCursor < firstIndexInBucket || sparseSet->releaseCursor > endIndexInBucket)
+        {
+            sparseSet->releaseCursor = firstIndexInBucket;
+        }
+
+        while(sparseSet->releaseCursor < endIndexInBucket && steps < maxSteps && !SparseSetContainsFast(sparseSet, sparseSet->releaseCursor))
+        {
+            ++sparseSet->releaseCursor;
+            ++steps;
+        }
+
+        if(sparseSet->releaseCursor < endIndexInBucket && steps < maxSteps) // The bucket is still in use.
+        {
+            break;
+        }
+
+        if(steps == maxSteps)
+        {
+            return steps;
+        }
+
+        BucketArrayResize(sparseData, firstIndexInBucket);
+        ++steps;
+    }
+
+    // Release trailing dense buckets.
+    if(steps < maxSteps)
+    {
+        uint64_t maxBucketsToRelease = maxSteps - steps;
+        uint64_t numBucketsReleased = BucketArrayShrink(denseData, maxBucketsToRelease);
+
+        steps += numBucketsReleased;
+        sparseSet->isCompact = numBucketsReleased < maxBucketsToRelease;
+    }
+
+    return steps;
+}
+
+/**
+ * @brief Order the dense elements by their sparse index, resuming where the previous call stopped. The sparse data is walked in ascending order once, and every element found is swapped to the next position at the front of the dense data, so a full reorder takes time linear in the size of the sparse data.
+ * @param sparseSet The sparse set whose dense elements to reorder.
+ * @param maxSteps The maximum number of sparse slots to inspect.
+ * @return uint64_t The amount of work performed.
+ */
+static uint64_t SparseSetReorder(SparseSet* sparseSet, const uint64_t maxSteps)
+{
+    uint64_t steps = 0;
+    BucketArray* sparseData = &(sparseSet->sparseData);
+    BucketArray* denseData = &(sparseSet->denseData);
+
+    while(steps < maxSteps && sparseSet->numReordered < BucketArrayNum(denseData))
+    {
+        Index index = sparseSet->reorderCursor++;
+        ++steps;
+
+        if(!SparseSetContainsFast(sparseSet, index))
+        {
+            continue;
+        }
+
+        Index* denseIndex = (Index*) BucketArrayGetFast(sparseData, index);
+        Index targetDenseIndex = sparseSet->numReordered++;
+
+        if(*denseIndex != targetDenseIndex)
+        {
+            void* element = BucketArrayGetFast(denseData, *denseIndex);
+            void* targetElement = BucketArrayGetFast(denseData, targetDenseIndex);
+
+            char tempElement[denseData->elementSize];
+            memcpy(tempElement, targetElement, denseData->elementSize);
+            memcpy(targetElement, element, denseData->elementSize);
+            memcpy(element, tempElement, denseData->elementSize);
+
+            *(Index*) BucketArrayGetFast(sparseData, sparseSet->getIndexFromDataFunc(element)) = *denseIndex;
+            *denseIndex = targetDenseIndex;
+        }
+    }
+
+    sparseSet->isReordered = sparseSet->numReordered == BucketArrayNum(denseData);
+    return steps;
+}
+
+/**
+ * @brief Grow the sparse data so it covers a given index. Newly added buckets are zeroed, since the sparse data always spans its whole capacity.
+ * @param sparseSet The sparse set whose sparse data to grow.
+ * @param index The index the sparse data should cover.
+ */
+static void SparseSetCoverSparseIndex(SparseSet* sparseSet, const Index index)
+{
+    if(index < BucketArrayNum(&(sparseSet->sparseData)))
+    {
+        return;
+    }
+
+    Index firstBucketIndexToSet = BucketArrayNumBuckets(&(sparseSet->sparseData));
+
+    BucketArrayResize(&(sparseSet->sparseData), index + 1);
+
+    for(int i = firstBucketIndexToSet; i < BucketArrayNumBuckets(&(sparseSet->sparseData)); i++)
+    {
+        void* bucket = BucketArrayGetBucketFast(&(sparseSet->sparseData), i);
+        memset(bucket, 0, BucketArrayBucketSize(&(sparseSet->sparseData), i) * sizeof(Index));
+    }
+
+    sparseSet->sparseData.num = BucketArrayCapacity(&(sparseSet->sparseData));
+}
+
+/**
+ * @brief Look up the dense index of every given index, and check wether it lies within the sparse and dense data.
+ * When the CPU supports AVX2 and the sparse buckets are geometric or have a power of 2 capacity, the sparse slots are fetched 4 at a time with gathers.
+ * @param sparseSet The sparse set to look the indices up in.
+ * @param indices The indices to look up.
+ * @param numIndices The number of indices to look up.
+ * @param denseIndices Output array, receiving the dense index of every index. Only valid for the candidates.
+ * @return uint64_t A bitmask of candidates, in which bit i is set if indices[i] refers to a valid dense position.
+ */
+static uint64_t SparseSetFindCandidates(SparseSet* sparseSet, const Index indices[], const uint8_t numIndices, Index denseIndices[])
+{
+    const BucketArray* sparseData = &(sparseSet->sparseData);
+    Index* const* sparseBuckets = (Index* const*) sparseData->bucketPtrs.elements;
+    const Index sparseNum = sparseData->num;
+    const Index denseNum = sparseSet->denseData.num;
+
+    uint64_t candidates = 0;
+    uint8_t i = 0;
+
+#ifdef SPARSE_SET_HAS_AVX2
+    if(SparseSetBatchIsVectorized(sparseSet))
+    {
+        i = SparseSetFindCandidatesAVX2(sparseSet, indices, numIndices, denseIndices, &candidates);
+    }
+#endif
+
+    for(; i < numIndices; ++i)
+    {
+        Index index = indices[i];
+
+        if(index < sparseNum)
+        {
+            Index bucketIndex;
+            Index indexInBucket;
+            BucketArrayLocate(sparseData, index, &bucketIndex, &indexInBucket);
+
+            denseIndices[i] = sparseBuckets[bucketIndex][indexInBucket];
+            candidates |= (uint64_t) (denseIndices[i] < denseNum) << i;
+        }
+    }
+
+    return candidates;
+}
+
+
+
+#ifdef SPARSE_SET_HAS_AVX2
+/**
+ * @brief The AVX2 part of SparseSetFindCandidates, looking up the indices 4 at a time. Only call this when SparseSetBatchIsVectorized.
+ * @param sparseSet The sparse set to look the indices up in.
+ * @param indices The indices to look up.
+ * @param numIndices The number of indices to look up.
+ * @param denseIndices Output array, receiving the dense index of every index. Only valid for the candidates.
+ * @param candidates The bitmask of candidates, to which the looked up indices are added.
+ * @return uint8_t The number of indices looked up. The rest is left to the scalar loop.
+ */
+static SPARSE_SET_AVX2_FUNCTION uint8_t SparseSetFindCandidatesAVX2(const SparseSet* sparseSet, const Index indices[], const uint8_t numIndices, Index denseIndices[], uint64_t* candidates)
+{
+    const BucketArray* sparseData = &(sparseSet->sparseData);
+    Index* const* sparseBuckets = (Index* const*) sparseData->bucketPtrs.elements;
+    const Index bucketCapacity = sparseData->bucketCapacity;
+    const bool isGeometric = sparseData->layout == BUCKET_ARRAY_LAYOUT_GEOMETRIC;
+
+    const __m128i shift = _mm_cvtsi32_si128(__builtin_ctzll(bucketCapacity));
+    const __m256i bucketCapacityVector = _mm256_set1_epi64x(bucketCapacity);
+    const __m256i offsetMask = _mm256_set1_epi64x(bucketCapacity - 1);
+    // AVX2 only compares signed 64 bit integers, so flipping the sign bits turns the unsigned order into the signed one.
+    const __m256i signBits = _mm256_set1_epi64x(INT64_MIN);
+    const __m256i sparseNumVector = _mm256_xor_si256(_mm256_set1_epi64x(sparseData->num), signBits);
+    const __m256i denseNumVector = _mm256_xor_si256(_mm256_set1_epi64x(sparseSet->denseData.num), signBits);
+    const __m256i doubleMagic = _mm256_set1_epi64x(0x4330000000000000);   // The bit pattern of 2^52.
+    const __m256i doubleExponentBias = _mm256_set1_epi64x(1023);
+    const __m256i bucketCapacityShiftVector = _mm256_set1_epi64x(sparseData->bucketCapacityShift);
+    const __m256i one = _mm256_set1_epi64x(1);
+
+    uint8_t i = 0;
+
+    for(; i + 4 <= numIndices; i += 4)
+    {
+        __m256i indexVector = _mm256_loadu_si256((const __m256i*) (indices + i));
+
+        // Lanes outside of the sparse data are masked off, so they are never loaded.
+        __m256i inSparseData = _mm256_cmpgt_epi64(sparseNumVector, _mm256_xor_si256(indexVector, signBits));
+
+        __m256i bucketIndices;
+        __m256i indicesInBucket;
+
+        if(isGeometric)
+        {
+            __m256i offsetIndices = _mm256_add_epi64(indexVector, bucketCapacityVector);
+            __m256d offsetIndicesAsDouble = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(offsetIndices, doubleMagic)), _mm256_castsi256_pd(doubleMagic));
+            __m256i highestBits = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(offsetIndicesAsDouble), 52), doubleExponentBias);
+
+            bucketIndices = _mm256_sub_epi64(highestBits, bucketCapacityShiftVector);
+            indicesInBucket = _mm256_sub_epi64(offsetIndices, _mm256_sllv_epi64(one, highestBits));
+        }
+        else
+        {
+            bucketIndices = _mm256_srl_epi64(indexVector, shift);
+            indicesInBucket = _mm256_and_si256(indexVector, offsetMask);
+        }
+
+        __m256i bucketPtrs = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), (const long long*) sparseBuckets, bucketIndices, inSparseData, sizeof(Index*));
+
+        __m256i slotOffsets = _mm256_slli_epi64(indicesInBucket, 3);
+        __m256i slotPtrs = _mm256_add_epi64(bucketPtrs, slotOffsets);
+        __m256i denseIndexVector = _mm256_mask_i64gather_epi64(_mm256_setzero_si256(), NULL, slotPtrs, inSparseData, 1);
+
+        __m256i inDenseData = _mm256_and_si256(inSparseData, _mm256_cmpgt_epi64(denseNumVector, _mm256_xor_si256(denseIndexVector, signBits)));
+
+        _mm256_storeu_si256((__m256i*) (denseIndices + i), denseIndexVector);
+        *candidates |= (uint64_t) _mm256_movemask_pd(_mm256_castsi256_pd(inDenseData)) << i;
+    }
+
+    return i;
+}
+#endif
\ No newline at end of file
@@ -2,26 +2,135 @@
 #define SPARSE_SET_I
 
 #include "BucketArray.h"
+#include "Index.h"
 
 #include <stdbool.h>
 
+#define SPARSE_SET_MAX_BATCH_SIZE 64
+
 typedef struct SparseSet
 {
     BucketArray sparseData;
     BucketArray denseData;
-    uint64_t(*getIndexFromDataFunc)(const void*);
+    Index(*getIndexFromDataFunc)(const void*);
+    Index releaseCursor;        // The sparse index at which the scan of the last sparse bucket resumes. The slots of that bucket before it are known to be unused.
+    Index reorderCursor;        // The sparse index at which the incremental reordering resumes.
+    Index numReordered;         // The number of dense elements at the front that are already ordered by sparse index.
+    bool isCompact;             // Wether or not the unused buckets have been released since the last change.
+    bool isReordered;           // Wether or not the dense elements have been ordered by sparse index since the last change.
+    const Allocator* allocator; // The allocator used for the sparse and dense data. NULL for the default allocator.
 }SparseSet;
 
-SparseSet* SparseSetNew(const size_t elementSize, const uint64_t(*getIndexFromDataFunc)(const void*), const uint64_t bucketCapacity);
+SparseSet* SparseSetNew(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index bucketCapacity);
+SparseSet* SparseSetNewWithAllocator(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index bucketCapacity, const Allocator* allocator);
+SparseSet* SparseSetNewGeometric(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index firstBucketCapacity);
+SparseSet* SparseSetNewReserved(const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), const Index firstBucketCapacity, const Index maxNumElements, const bool useHugePages);
 void SparseSetAdd(SparseSet* sparseSet, const void* newElement);
-void SparseSetRemove(SparseSet* sparseSet, const uint64_t index);
-void* SparseSetGet(SparseSet* sparseSet, const uint64_t index);
-bool SparseSetContains(SparseSet* sparseSet, const uint64_t index);
+void SparseSetAddRange(SparseSet* sparseSet, const void* newElements, const Index numElements);
+void SparseSetRemove(SparseSet* sparseSet, const Index index);
+void* SparseSetGet(SparseSet* sparseSet, const Index index);
+bool SparseSetContains(SparseSet* sparseSet, const Index index);
+uint64_t SparseSetContainsBatch(SparseSet* sparseSet, const Index indices[], const uint8_t numIndices);
+bool SparseSetBatchIsVectorized(const SparseSet* sparseSet);
+uint64_t SparseSetCompact(SparseSet* sparseSet, const uint64_t maxSteps, const bool reorderDenseData, bool* isCompact);
 void SparseSetFree(SparseSet* sparseSet);
 
 BucketArray* SparseSetGetDenseData(SparseSet* sparseSet);
 
-void SparseSetInit(SparseSet* sparseSet, const size_t elementSize, const uint64_t(*getIndexFromDataFunc)(const void*), uint64_t bucketCapacity);
+void SparseSetInit(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index bucketCapacity, const size_t alignment, const Allocator* allocator);
+void SparseSetInitGeometric(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index firstBucketCapacity, const size_t alignment, const Allocator* allocator);
+void SparseSetInitReserved(SparseSet* sparseSet, const size_t elementSize, const Index(*getIndexFromDataFunc)(const void*), Index firstBucketCapacity, const Index maxNumElements, const bool useHugePages, const Allocator* allocator);
 void SparseSetDeinit(SparseSet* sparseSet);
 
+/**
+ * @brief Retrieve the element stored at a given index. Inlined fast path of SparseSetGet, which is only checked in debug builds.
+ * @param sparseSet The sparse set to retrieve the element from.
+ * @param index The index of the element. The element must be present in the sparse set.
+ * @return void* A pointer to the element in the dense data.
+ */
+static inline void* SparseSetGetFast(const SparseSet* sparseSet, const Index index)
+{
+    LogAssert(sparseSet != NULL);
+
+    Index denseIndex = *(Index*) BucketArrayGetFast(&(sparseSet->sparseData), index);
+    return BucketArrayGetFast(&(sparseSet->denseData), denseIndex);
+}
+
+/**
+ * @brief Check wether an element is present at a given index. Inlined fast path of SparseSetContains.
+ * @param sparseSet The sparse set to check.
+ * @param index The index to check.
+ * @return bool Wether or not an element is present at the given index.
+ */
+static inline bool SparseSetContainsFast(const SparseSet* sparseSet, const Index index)
+{
+    LogAssert(sparseSet != NULL);
+
+    if(index >= sparseSet->sparseData.num)
+    {
+        return false;
+    }
+
+    Index indexInDenseData = *(Index*) BucketArrayGetFast(&(sparseSet->sparseData), index);
+
+    if(indexInDenseData >= sparseSet->denseData.num)
+    {
+        return false;
+    }
+
+    return sparseSet->getIndexFromDataFunc(BucketArrayGetFast(&(sparseSet->denseData), indexInDenseData)) == index;
+}
+
+/**
+ * @brief Declare a sparse set specialized for element type T, named T##SparseSet. Its dense data uses a geometric bucket layout. The element size is a compile time constant, so retrieving elements compiles to direct loads instead of runtime multiplications. The typed sparse set wraps a generic sparse set, so the generic functions still work on its base member.
+ * @param T The element type. This has to be a single identifier, so typedef pointer and qualified types first.
+ */
+#define DECLARE_SPARSE_SET(T)                                                                                                                                                  \
+    typedef struct T##SparseSet                                                                                                                                                \
+    {                                                                                                                                                                          \
+        SparseSet base;                                                                                                                                                        \
+    } T##SparseSet;                                                                                                                                                            \
+                                                                                                                                                                               \
+    static inline void T##SparseSetInit(T##SparseSet* sparseSet, const Index(*getIndexFromDataFunc)(const void*), const Index firstBucketCapacity, const Allocator* allocator) \
+    {                                                                                                                                                                          \
+        SparseSetInitGeometric(&(sparseSet->base), sizeof(T), getIndexFromDataFunc, firstBucketCapacity, 0, allocator);                                                        \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline void T##SparseSetDeinit(T##SparseSet* sparseSet)                                                                                                             \
+    {                                                                                                                                                                          \
+        SparseSetDeinit(&(sparseSet->base));                                                                                                                                   \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline void T##SparseSetAdd(T##SparseSet* sparseSet, const T newElement)                                                                                            \
+    {                                                                                                                                                                          \
+        SparseSetAdd(&(sparseSet->base), &newElement);                                                                                                                         \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline void T##SparseSetRemove(T##SparseSet* sparseSet, const Index index)                                                                                          \
+    {                                                                                                                                                                          \
+        SparseSetRemove(&(sparseSet->base), index);                                                                                                                            \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline T* T##SparseSetGet(const T##SparseSet* sparseSet, const Index index)                                                                                         \
+    {                                                                                                                                                                          \
+        Index denseIndex = *(Index*) BucketArrayGetFast(&(sparseSet->base.sparseData), index);                                                                                 \
+        LogAssert(denseIndex < sparseSet->base.denseData.num);                                                                                                                 \
+                                                                                                                                                                               \
+        Index bucketIndex;                                                                                                                                                     \
+        Index indexInBucket;                                                                                                                                                   \
+        BucketArrayLocate(&(sparseSet->base.denseData), denseIndex, &bucketIndex, &indexInBucket);                                                                             \
+                                                                                                                                                                               \
+        return (T*) BucketArrayGetBucketFast(&(sparseSet->base.denseData), bucketIndex) + indexInBucket;                                                                       \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline bool T##SparseSetContains(const T##SparseSet* sparseSet, const Index index)                                                                                  \
+    {                                                                                                                                                                          \
+        return SparseSetContainsFast(&(sparseSet->base), index);                                                                                                               \
+    }                                                                                                                                                                          \
+                                                                                                                                                                               \
+    static inline Index T##SparseSetNum(const T##SparseSet* sparseSet)                                                                                                         \
+    {                                                                                                                                                                          \
+        return sparseSet->base.denseData.num;                                                                                                                                  \
+    }
+
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "Component.h"
 
-uint64_t ComponentGetID(const void* component)
+Index ComponentGetID(const void* component)
 {
     // return *(ComponentID*) componentID;
     Component* c = (Component*) component;
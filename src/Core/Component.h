@@ -4,6 +4,7 @@
 #include "../include/Core/Component.h"
 
 #include "Entity.h"
+#include "Containers/InlineArray.h"
 
 #include <stdint.h>
 
@@ -14,6 +15,26 @@ struct Component
     Entity entity;
 };
 
-uint64_t ComponentGetID(const void* componentID);
+/**
+ * @brief The dense index of a registered component type, counting up from 0 in registration order. Per-scene component stores are indexed by it, while the ComponentTypeID stays the stable external name.
+ */
+typedef uint32_t ComponentTypeIndex;
+
+#define COMPONENT_TYPE_INDEX_INVALID UINT32_MAX
+
+/**
+ * @brief What the ECS knows about a registered component type.
+ */
+typedef struct ComponentTypeInfo
+{
+    ComponentTypeID id;     // The stable, hashed name of the component type.
+    size_t size;            // The memory footprint of 1 component.
+    size_t alignment;       // The alignment of the components in memory. 0 for the allocator's default alignment.
+} ComponentTypeInfo;
+
+Index ComponentGetID(const void* componentID);
+
+DECLARE_INLINE_ARRAY(ComponentTypeID, 4)    // Systems rarely update more than 4 component types, so their lists stay inline.
+DECLARE_INLINE_ARRAY(ComponentTypeIndex, 4)
 
 #endif
\ No newline at end of file
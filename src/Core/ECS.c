@@ -1,12 +1,26 @@
+#define LOG_MODULE LOG_MODULE_ECS
+
 #include "ECS.h"
 
 #include "Logger.h"
 #include "Utils/Hash.h"
+#include "Utils/Arena.h"
+#include "Utils/Profiler.h"
+
+// The updated components are logged per component, so they are rate limited to keep debug builds usable under real load.
+#define ECS_MAX_COMPONENT_LOGS_PER_SECOND 10
+
+static void ECSUpdateEntityBlock(System* system, SparseSet* componentSetsToUpdate[], const int numComponentsToUpdate, const SparseSet* smallestSetOfComponents, const Entity entitiesToUpdate[], const uint8_t numEntitiesToUpdate, void* componentsToUpdate[]);
 
 ECS* ECSNew()
 {
-    ECS* newECS = malloc(sizeof(ECS));
-    ECSInit(newECS);
+    return ECSNewWithAllocator(NULL);
+}
+
+ECS* ECSNewWithAllocator(const Allocator* allocator)
+{
+    ECS* newECS = AllocatorAlloc(allocator, sizeof(ECS));
+    ECSInit(newECS, allocator);
 
     return newECS;
 }
@@ -15,25 +29,43 @@ void ECSFree(ECS* ecs)
 {
     LogAssert(ecs);
 
-    free(ecs);
+    const Allocator* allocator = ecs->allocator;
+
+    ECSDeinit(ecs);
+    AllocatorFree(allocator, ecs, sizeof(ECS));
 }
 
 ComponentTypeID ECSRegisterComponent(ECS* ecs, char* componentName, size_t componentNameSize, size_t componentSize)
+{
+    return ECSRegisterComponentAligned(ecs, componentName, componentNameSize, componentSize, 0);
+}
+
+ComponentTypeID ECSRegisterComponentAligned(ECS* ecs, char* componentName, size_t componentNameSize, size_t componentSize, size_t componentAlignment)
 {
     LogAssert(ecs);
     LogAssert(componentNameSize > 0);
 
-    ComponentTypeID componentTypeID = HashFNV1a64(componentName, componentNameSize);
-    ArrayAdd(&(ecs->ComponentTypeIDs), &componentTypeID);
+    return ECSRegisterComponentWithID(ecs, HashFNV1a64(componentName, componentNameSize), componentSize, componentAlignment);
+}
 
-    for(int i = 0; i < ArrayNum(&(ecs->Scenes)); ++i)
-    {
-        Scene* scene = ArrayGet(&(ecs->Scenes), i);
+ComponentTypeID ECSRegisterComponentWithID(ECS* ecs, ComponentTypeID componentTypeID, size_t componentSize, size_t componentAlignment)
+{
+    LogAssert(ecs);
+    LogAssert(componentSize > 0);
 
-        SparseSet* componentSparseSet = SparseSetNew(componentSize, ComponentGetID, 16); //TODO: hardcoded bucketsize 16
-        DictionaryAdd(&(scene->components), &componentTypeID, componentSparseSet);
+    if(SortedArrayContains(&(ecs->ComponentTypeIDs), componentTypeID))
+    {
+        return componentTypeID;
     }
 
+    ComponentTypeIndex componentTypeIndex = ArrayNum(&(ecs->componentTypes));
+    ComponentTypeInfo componentType = { componentTypeID, componentSize, componentAlignment };
+    ArrayAdd(&(ecs->componentTypes), &componentType);
+
+    // The scenes create their store for this type once they get their first component of it.
+    uint64_t sortedPosition = SortedArrayInsert(&(ecs->ComponentTypeIDs), componentTypeID);
+    ArrayInsert(&(ecs->componentTypeIndices), sortedPosition, &componentTypeIndex, 1);
+
     return componentTypeID;
 }
 
@@ -44,13 +76,24 @@ ComponentInstanceID ECSAddComponent(ECS* ecs, ComponentTypeID componentTypeID, v
     LogAssert(componentTypeID);
     LogAssert(entity);
 
+    ComponentTypeIndex componentTypeIndex = ECSGetComponentTypeIndex(ecs, componentTypeID);
+
+    if(componentTypeIndex == COMPONENT_TYPE_INDEX_INVALID)
+    {
+        LogWarning("Component type %llu was not registered, so the component was not added.", (unsigned long long) componentTypeID);
+        return 0;
+    }
+
+    LogAssert(nextComponentID < INDEX_MAX);
     ++nextComponentID;
 
     Component* c = component;
     c->componentInstanceID = nextComponentID;
     c->entity = entity;
 
-    SparseSet* componentSparseSet = DictionaryGet(&(scene->components), &componentTypeID);
+    const ComponentTypeInfo* componentType = ArrayGetFast(&(ecs->componentTypes), componentTypeIndex);
+
+    SparseSet* componentSparseSet = SceneGetOrAddComponentStore(scene, componentTypeIndex, componentType->size, componentType->alignment);
     SparseSetAdd(componentSparseSet, component);
 
     BucketArray* entities = SparseSetGetDenseData(&(scene->entities));
@@ -59,22 +102,47 @@ ComponentInstanceID ECSAddComponent(ECS* ecs, ComponentTypeID componentTypeID, v
     {
         for(int e = 0; e < BucketArrayNum(entities); ++e)
         {
-            System* system = ArrayGet(&(ecs->systems), i);
+            System* system = ArrayGetFast(&(ecs->systems), i);
 
-            SparseSetAdd(&(system->compatibleEntities), BucketArrayGet(entities, e));
+            SparseSetAdd(&(system->compatibleEntities), BucketArrayGetFast(entities, e));
         }
     }
 
     return nextComponentID; // TODO: return the specific component's ID.
 }
 
-void ECSRegisterSystem(ECS* ecs, System* system)
+/**
+ * @brief Register a system, so it gets updated by ECSUpdate. All component types the system updates have to be registered first.
+ * @param ecs The ECS to register the system to.
+ * @param system The system to register.
+ * @return bool Wether or not the system was registered. It fails when one of its component types was not registered.
+ */
+bool ECSRegisterSystem(ECS* ecs, System* system)
 {
     LogAssert(ecs);
     LogAssert(system);
 
+    // The component types are resolved to their dense indices once, so updating the system only takes array lookups.
+    const ComponentTypeID* componentTypeIDsToUpdate = ComponentTypeIDInlineArrayData(&(system->componentsToUpdate));
+    const int numComponentsToUpdate = ComponentTypeIDInlineArrayNum(&(system->componentsToUpdate));
+
+    for(int c = 0; c < numComponentsToUpdate; ++c)
+    {
+        if(ECSGetComponentTypeIndex(ecs, componentTypeIDsToUpdate[c]) == COMPONENT_TYPE_INDEX_INVALID)
+        {
+            LogWarning("System %llu updates component type %llu, which was not registered.", (unsigned long long) system->id, (unsigned long long) componentTypeIDsToUpdate[c]);
+            return false;
+        }
+    }
+
+    for(int c = 0; c < numComponentsToUpdate; ++c)
+    {
+        ComponentTypeIndexInlineArrayAdd(&(system->componentTypeIndicesToUpdate), ECSGetComponentTypeIndex(ecs, componentTypeIDsToUpdate[c]));
+    }
+
     // DictionaryAdd(&(ecs->systems), &(system->id), system);
     ArrayAdd(&(ecs->systems), system);
+    return true;
 }
 
 Entity ECSAddEntity(ECS* ecs, Scene* sceneToAddEntityTo)
@@ -82,6 +150,7 @@ Entity ECSAddEntity(ECS* ecs, Scene* sceneToAddEntityTo)
     LogAssert(ecs);
     LogAssert(sceneToAddEntityTo);
 
+    LogAssert(nextEntityID < INDEX_MAX);
     ++nextEntityID;
 
     Entity newEntity = nextEntityID;
@@ -90,103 +159,240 @@ Entity ECSAddEntity(ECS* ecs, Scene* sceneToAddEntityTo)
     return newEntity;
 }
 
+void ECSAddEntities(ECS* ecs, Scene* sceneToAddEntitiesTo, Entity newEntities[], const Index numEntities)
+{
+    LogAssert(ecs);
+    LogAssert(sceneToAddEntitiesTo);
+    LogAssert(newEntities != NULL || numEntities == 0);
+
+    LogAssert(numEntities < INDEX_MAX - nextEntityID);
+
+    for(Index i = 0; i < numEntities; ++i)
+    {
+        newEntities[i] = ++nextEntityID;
+    }
+
+    SparseSetAddRange(&(sceneToAddEntitiesTo->entities), newEntities, numEntities);
+}
+
 void ECSUpdate(ECS* ecs, Scene* scene)//TODO: remove scene argument
 {
+    // Scratch memory of this update, including what the systems allocate from the frame arena, is released when the update ends.
+    Arena* frameArena = ArenaGetFrame();
+    size_t frameArenaMark = ArenaMark(frameArena);
+
+    PROFILE_ZONE_BEGIN(updateZone, "ECSUpdate", 0);
+
     for(int s = 0; s < ArrayNum(&(ecs->systems)); ++s)
     {
-        System* system = ArrayGet(&(ecs->systems), s);
+        System* system = ArrayGetFast(&(ecs->systems), s);
+        const ComponentTypeIndex* componentTypeIndicesToUpdate = ComponentTypeIndexInlineArrayData(&(system->componentTypeIndicesToUpdate));
 
-        if(ArrayNum(&(system->componentsToUpdate)) == 1)
+        PROFILE_ZONE_BEGIN(systemZone, "System", system->id);
+
+        if(ComponentTypeIndexInlineArrayNum(&(system->componentTypeIndicesToUpdate)) == 1)
         {
             LogAssert(BucketArrayNum(SparseSetGetDenseData(&(system->compatibleEntities))) == 0, "CompatibleEntities for system (ID %d) was not empty. This should be empty because this system only has 1 component type to update.", system->id);
 
-            ComponentTypeID* componentTypeIDToUpdate = ArrayGet(&(system->componentsToUpdate), 0);
+            SparseSet* sparseComponents = SceneGetComponentStore(scene, componentTypeIndicesToUpdate[0]);
+
+            if(sparseComponents == NULL) // The scene has no components of this type.
+            {
+                PROFILE_ZONE_END(systemZone, 0);
+                continue;
+            }
 
-            SparseSet* sparseComponents = DictionaryGet(&(scene->components), componentTypeIDToUpdate);
             BucketArray* denseComponents = SparseSetGetDenseData(sparseComponents);
 
-            for(int c = 0; c < BucketArrayNum(denseComponents); ++c)
+            BucketArrayIterator iterator = BucketArrayIterate(denseComponents);
+            void* span;
+            Index spanNum;
+
+            while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
             {
-                void* component = BucketArrayGet(denseComponents, c);
-                system->updateFunction(1, component);
+                for(Index c = 0; c < spanNum; ++c)
+                {
+                    void* component = span + (c * denseComponents->elementSize);
+                    system->updateFunction(1, component);
 
-                LogInfo("%p", component);
+                    LogInfoRateLimited(ECS_MAX_COMPONENT_LOGS_PER_SECOND, "%p", component);
+                }
             }
+
+            PROFILE_ZONE_END(systemZone, denseComponents->num);
         }
         else
         {
-            int  numComponentsToUpdate = ArrayNum(&(system->componentsToUpdate));
-            SparseSet* componentSetsToUpdate[numComponentsToUpdate];
+            int  numComponentsToUpdate = ComponentTypeIndexInlineArrayNum(&(system->componentTypeIndicesToUpdate));
+
+            // The component sets and the components of an entity share one block, which falls back to the ECS's allocator when the frame arena is full.
+            size_t scratchSize = numComponentsToUpdate * (sizeof(SparseSet*) + sizeof(void*));
+            void* scratch = ArenaAlloc(frameArena, scratchSize);
+            bool isScratchInArena = scratch != NULL;
+
+            if(!isScratchInArena && (scratch = AllocatorAlloc(ecs->allocator, scratchSize)) == NULL)
+            {
+                LogWarning("System %llu was skipped, because its scratch memory could not be allocated.", (unsigned long long) system->id);
+                PROFILE_ZONE_END(systemZone, 0);
+                continue;
+            }
+
+            SparseSet** componentSetsToUpdate = scratch;
+            void** componentsToUpdate = (void**) (componentSetsToUpdate + numComponentsToUpdate);
             SparseSet* smallestSetOfComponents = NULL;
             BucketArray* smallestDenseComponents = NULL;
 
-            for(int sc = 0; sc < ArrayNum(&(system->componentsToUpdate)); ++sc)
+            for(int sc = 0; sc < numComponentsToUpdate; ++sc)
             {
-                ComponentTypeID* componentTypeID = ArrayGet(&(system->componentsToUpdate), sc);
-                SparseSet* sparseComponents = DictionaryGet(&(scene->components), componentTypeID);
+                SparseSet* sparseComponents = SceneGetComponentStore(scene, componentTypeIndicesToUpdate[sc]);
+
+                if(sparseComponents == NULL) // The scene has no components of this type, so no entity can match the system.
+                {
+                    smallestDenseComponents = NULL;
+                    break;
+                }
+
                 BucketArray* denseComponents = SparseSetGetDenseData(sparseComponents);
 
                 componentSetsToUpdate[sc] = sparseComponents;
 
-                if(smallestDenseComponents == NULL || BucketArrayNum(denseComponents) < BucketArrayNum(smallestDenseComponents))
+                if(smallestDenseComponents == NULL || denseComponents->num < smallestDenseComponents->num)
                 {
                     smallestDenseComponents = denseComponents;
                     smallestSetOfComponents = sparseComponents;
                 }
             }
 
-            for(int c = 0; c < BucketArrayNum(smallestDenseComponents); ++c)
+            if(smallestDenseComponents == NULL)
             {
-                bool entityHasAllComponents = true;
-                Component* componentFromSmallestSetToUpdate = BucketArrayGet(smallestDenseComponents, c);
-                Entity entityToUpdate = componentFromSmallestSetToUpdate->entity;
+                if(!isScratchInArena)
+                {
+                    AllocatorFree(ecs->allocator, scratch, scratchSize);
+                }
+
+                PROFILE_ZONE_END(systemZone, 0);
+                continue;
+            }
 
-                void* componentsToUpdate[numComponentsToUpdate];
+            // The entities of the smallest set are filtered in blocks, testing a whole block against each other set at once.
+            Entity entitiesToUpdate[SPARSE_SET_MAX_BATCH_SIZE];
+            uint8_t numEntitiesToUpdate = 0;
 
-                for(int b = 0; b < numComponentsToUpdate; ++b)
-                {
-                    SparseSet* componentSet = componentSetsToUpdate[b];
+            BucketArrayIterator iterator = BucketArrayIterate(smallestDenseComponents);
+            void* span;
+            Index spanNum;
 
-                    if(componentSet == smallestSetOfComponents)
-                    {
-                        componentsToUpdate[b] = SparseSetGet(componentSet, entityToUpdate);
-                        LogInfo("%p", componentsToUpdate[b]);
-                        continue;
-                    }
+            while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
+            {
+                for(Index c = 0; c < spanNum; ++c)
+                {
+                    Component* componentFromSmallestSetToUpdate = span + (c * smallestDenseComponents->elementSize);
+                    entitiesToUpdate[numEntitiesToUpdate++] = componentFromSmallestSetToUpdate->entity;
 
-                    if(!SparseSetContains(componentSet, entityToUpdate))
+                    if(numEntitiesToUpdate == SPARSE_SET_MAX_BATCH_SIZE)
                     {
-                        entityHasAllComponents = false;
-                        break;
+                        ECSUpdateEntityBlock(system, componentSetsToUpdate, numComponentsToUpdate, smallestSetOfComponents, entitiesToUpdate, numEntitiesToUpdate, componentsToUpdate);
+                        numEntitiesToUpdate = 0;
                     }
-
-                    componentsToUpdate[b] = SparseSetGet(componentSet, entityToUpdate);
-                    LogInfo("%p", componentsToUpdate[b]);
                 }
+            }
 
-                if(!entityHasAllComponents)
-                {
-                    continue;
-                }
-                else
-                {
-                    system->updateFunction(numComponentsToUpdate, componentsToUpdate);
-                }
+            if(numEntitiesToUpdate > 0)
+            {
+                ECSUpdateEntityBlock(system, componentSetsToUpdate, numComponentsToUpdate, smallestSetOfComponents, entitiesToUpdate, numEntitiesToUpdate, componentsToUpdate);
             }
+
+            if(!isScratchInArena)
+            {
+                AllocatorFree(ecs->allocator, scratch, scratchSize);
+            }
+
+            // The entities of the smallest set are the ones the system went through, even if not all of them had every component.
+            PROFILE_ZONE_END(systemZone, smallestDenseComponents->num);
+        }
+    }
+
+    PROFILE_ZONE_END(updateZone, BucketArrayNum(SparseSetGetDenseData(&(scene->entities))));
+
+    ArenaRewind(frameArena, frameArenaMark);
+}
+
+uint64_t ECSCompact(ECS* ecs, Scene* scene, const uint64_t maxSteps, const bool reorderComponents, bool* isCompact) //TODO: remove scene argument
+{
+    LogAssert(ecs);
+    LogAssert(scene);
+
+    bool isSetCompact;
+    uint64_t steps = SparseSetCompact(&(scene->entities), maxSteps, false, &isSetCompact);
+    bool isSceneCompact = isSetCompact;
+
+    ComponentTypeIndex i = 0;
+
+    for(; i < ArrayNum(&(scene->componentStores)) && steps < maxSteps; ++i)
+    {
+        SparseSet* sparseComponents = SceneGetComponentStore(scene, i);
+
+        if(sparseComponents != NULL)
+        {
+            steps += SparseSetCompact(sparseComponents, maxSteps - steps, reorderComponents, &isSetCompact);
+            isSceneCompact = isSceneCompact && isSetCompact;
         }
     }
+
+    if(isCompact != NULL)
+    {
+        // Stores the budget didn't reach may still need work.
+        *isCompact = isSceneCompact && i == ArrayNum(&(scene->componentStores));
+    }
+
+    return steps;
 }
 
 /* ---------------------------------------------------- INTERNAL ---------------------------------------------------- */
 
-void ECSInit(ECS* ecs)
+void ECSInit(ECS* ecs, const Allocator* allocator)
 {
     LogAssert(ecs);
 
+    ecs->allocator = allocator;
+
     // DictionaryInit(&(ecs->systems), sizeof(char*), sizeof(System));
-    ArrayInit(&(ecs->systems), sizeof(System), 1);
-    ArrayInit(&(ecs->Scenes), sizeof(Scene), 1);
-    ArrayInit(&(ecs->ComponentTypeIDs), sizeof(ComponentTypeID), 1);
+    ArrayInit(&(ecs->systems), sizeof(System), 1, 0, allocator);
+    ArrayInit(&(ecs->Scenes), sizeof(Scene), 1, 0, allocator);
+    SortedArrayInit(&(ecs->ComponentTypeIDs), allocator);
+    ArrayInit(&(ecs->componentTypeIndices), sizeof(ComponentTypeIndex), 1, 0, allocator);
+    ArrayInit(&(ecs->componentTypes), sizeof(ComponentTypeInfo), 1, 0, allocator);
+}
+
+void ECSDeinit(ECS* ecs)
+{
+    LogAssert(ecs);
+
+    ArrayDeinit(&(ecs->systems));
+    ArrayDeinit(&(ecs->Scenes));
+    SortedArrayDeinit(&(ecs->ComponentTypeIDs));
+    ArrayDeinit(&(ecs->componentTypeIndices));
+    ArrayDeinit(&(ecs->componentTypes));
+}
+
+/**
+ * @brief Find the dense index of a registered component type, with a binary search over the registered types.
+ * @param ecs The ECS the component type was registered to.
+ * @param componentTypeID The ID of the component type.
+ * @return ComponentTypeIndex The dense index of the component type. COMPONENT_TYPE_INDEX_INVALID if it was not registered.
+ */
+ComponentTypeIndex ECSGetComponentTypeIndex(const ECS* ecs, const ComponentTypeID componentTypeID)
+{
+    LogAssert(ecs);
+
+    uint64_t sortedPosition = SortedArrayLowerBound(&(ecs->ComponentTypeIDs), componentTypeID);
+
+    if(sortedPosition >= SortedArrayNum(&(ecs->ComponentTypeIDs)) || SortedArrayGet(&(ecs->ComponentTypeIDs), sortedPosition) != componentTypeID)
+    {
+        return COMPONENT_TYPE_INDEX_INVALID;
+    }
+
+    return *(ComponentTypeIndex*) ArrayGetFast(&(ecs->componentTypeIndices), sortedPosition);
 }
 
 /* ----------------------------------------------------- PRIVATE ---------------------------------------------------- */
@@ -195,9 +401,9 @@ void ECSRegisterEntityToSystems(ECS* ecs, Entity entity, Scene* scene) //TODO: r
 {
     for(int s = 0; s < ArrayNum(&(ecs->systems)); ++s)
     {
-        System* system = ArrayGet(&(ecs->systems), s);
+        System* system = ArrayGetFast(&(ecs->systems), s);
 
-        int numComponentsToUpdate = ArrayNum(&(system->componentsToUpdate));
+        int numComponentsToUpdate = ComponentTypeIndexInlineArrayNum(&(system->componentTypeIndicesToUpdate));
         LogAssert(numComponentsToUpdate > 0);
 
         if(numComponentsToUpdate == 1)
@@ -207,12 +413,12 @@ void ECSRegisterEntityToSystems(ECS* ecs, Entity entity, Scene* scene) //TODO: r
 
         bool entityShouldBeUpdatedBySystem = true;
 
-        for(int c = 0; c < ArrayNum(&(system->componentsToUpdate)); ++c)
-        {
-            ComponentTypeID* componentTypeIDToUpdate = ArrayGet(&(system->componentsToUpdate), c);
+        const ComponentTypeIndex* componentTypeIndicesToUpdate = ComponentTypeIndexInlineArrayData(&(system->componentTypeIndicesToUpdate));
 
-            SparseSet* sparseComponents = DictionaryGet(&(scene->components), componentTypeIDToUpdate);
-            if(!SparseSetContains(sparseComponents, entity))
+        for(int c = 0; c < numComponentsToUpdate; ++c)
+        {
+            SparseSet* sparseComponents = SceneGetComponentStore(scene, componentTypeIndicesToUpdate[c]);
+            if(sparseComponents == NULL || !SparseSetContainsFast(sparseComponents, entity))
             {
                 entityShouldBeUpdatedBySystem = false;
                 break;
@@ -226,6 +432,39 @@ void ECSRegisterEntityToSystems(ECS* ecs, Entity entity, Scene* scene) //TODO: r
     }
 }
 
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+static void ECSUpdateEntityBlock(System* system, SparseSet* componentSetsToUpdate[], const int numComponentsToUpdate, const SparseSet* smallestSetOfComponents, const Entity entitiesToUpdate[], const uint8_t numEntitiesToUpdate, void* componentsToUpdate[])
+{
+    PROFILE_BATCH_ZONE_BEGIN(batchZone, "SystemBatch", system->id);
+
+    uint64_t entitiesWithAllComponents = (numEntitiesToUpdate == 64) ? UINT64_MAX : (((uint64_t) 1 << numEntitiesToUpdate) - 1);
+
+    for(int b = 0; b < numComponentsToUpdate && entitiesWithAllComponents != 0; ++b)
+    {
+        if(componentSetsToUpdate[b] != smallestSetOfComponents)
+        {
+            entitiesWithAllComponents &= SparseSetContainsBatch(componentSetsToUpdate[b], entitiesToUpdate, numEntitiesToUpdate);
+        }
+    }
+
+    while(entitiesWithAllComponents != 0)
+    {
+        int e = __builtin_ctzll(entitiesWithAllComponents);
+        entitiesWithAllComponents &= entitiesWithAllComponents - 1;
+
+        for(int b = 0; b < numComponentsToUpdate; ++b)
+        {
+            componentsToUpdate[b] = SparseSetGetFast(componentSetsToUpdate[b], entitiesToUpdate[e]);
+            LogInfoRateLimited(ECS_MAX_COMPONENT_LOGS_PER_SECOND, "%p", componentsToUpdate[b]);
+        }
+
+        system->updateFunction(numComponentsToUpdate, componentsToUpdate);
+    }
+
+    PROFILE_BATCH_ZONE_END(batchZone, numEntitiesToUpdate);
+}
+
 /* void ECSAddEntity(Entity* e)
 {
     LogAssert(e != NULL);
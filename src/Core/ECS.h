@@ -4,6 +4,7 @@
 #include "../include/Core/ECS.h"
 
 #include "Containers/Dictionary.h"
+#include "Containers/SortedArray.h"
 #include "Scene.h"
 
 static const uint8_t MAX_COMPONENT_TYPES = 64;
@@ -17,10 +18,15 @@ struct ECS
 {
     Array systems;
     Array Scenes;
-    Array ComponentTypeIDs;
+    SortedArray ComponentTypeIDs;   // The registered component types, sorted so they can be found with a binary search.
+    Array componentTypeIndices;     // The ComponentTypeIndex of every entry of ComponentTypeIDs, in the same order.
+    Array componentTypes;           // The ComponentTypeInfo of every registered component type, indexed by ComponentTypeIndex.
+    const Allocator* allocator;
 };
 
-void ECSInit(ECS* ecs);
+void ECSInit(ECS* ecs, const Allocator* allocator);
 void ECSDeinit(ECS* ecs);
 
+ComponentTypeIndex ECSGetComponentTypeIndex(const ECS* ecs, const ComponentTypeID componentTypeID);
+
 #endif
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "Entity.h"
 
-uint64_t EntityGetID(const void* entity)
+Index EntityGetID(const void* entity)
 {
     return *(Entity*) entity;
 }
\ No newline at end of file
@@ -6,8 +6,13 @@
 
 Scene* SceneNew()
 {
-    Scene* newScene = (Scene*) malloc(sizeof(Scene));
-    SceneInit(newScene);
+    return SceneNewWithAllocator(NULL);
+}
+
+Scene* SceneNewWithAllocator(const Allocator* allocator)
+{
+    Scene* newScene = (Scene*) AllocatorAlloc(allocator, sizeof(Scene));
+    SceneInit(newScene, allocator);
     return newScene;
 }
 
@@ -15,8 +20,10 @@ void SceneFree(Scene* scene)
 {
     LogAssert(scene != NULL);
 
+    const Allocator* allocator = scene->allocator;
+
     SceneDeinit(scene);
-    free(scene);
+    AllocatorFree(allocator, scene, sizeof(Scene));
 }
 
 Entity SceneAddEntity(Scene* scene)
@@ -26,17 +33,40 @@ Entity SceneAddEntity(Scene* scene)
     return nextEntityID;
 }
 
-void SceneRegisterComponent(Scene* scene, char* componentName, size_t componentNameSize, size_t componentSize)
+/**
+ * @brief Retrieve the store of a component type, creating it if the scene doesn't have one yet. Stores are only created once a scene gets a component of their type, so component types a scene never uses cost it no more than a pointer.
+ * @param scene The scene to retrieve the store from.
+ * @param componentTypeIndex The dense index of the component type.
+ * @param componentSize The memory footprint of 1 component of this type.
+ * @param componentAlignment The alignment of the components in memory. 0 for the allocator's default alignment.
+ * @return SparseSet* The sparse set holding the scene's components of that type.
+ */
+SparseSet* SceneGetOrAddComponentStore(Scene* scene, const ComponentTypeIndex componentTypeIndex, size_t componentSize, size_t componentAlignment)
 {
-    ComponentTypeID componentTypeID = (ComponentTypeID) HashFNV1a64(componentName, componentNameSize);
+    LogAssert(scene != NULL);
+
+    SparseSet* componentStore = SceneGetComponentStore(scene, componentTypeIndex);
+
+    if(componentStore != NULL)
+    {
+        return componentStore;
+    }
+
+    SparseSet* missingComponentStore = NULL;
+    ArrayReserve(&(scene->componentStores), componentTypeIndex + 1);
 
-    if(DictionaryGet(&(scene->components), &componentTypeID) != NULL)
+    while(ArrayNum(&(scene->componentStores)) <= componentTypeIndex)
     {
-        return;
+        ArrayAdd(&(scene->componentStores), &missingComponentStore);
     }
 
-    SparseSet* newSparseSet = SparseSetNew(componentSize, &ComponentGetID, 16);
-    DictionaryAdd(&(scene->components), &componentTypeID, newSparseSet);
+    componentStore = AllocatorAlloc(scene->allocator, sizeof(SparseSet));
+    LogAssert(componentStore != NULL);
+
+    SparseSetInitGeometric(componentStore, componentSize, &ComponentGetID, STORE_FIRST_BUCKET_CAPACITY, componentAlignment, BucketPoolGetAllocator(scene->componentBucketPool));
+    *(SparseSet**) ArrayGetFast(&(scene->componentStores), componentTypeIndex) = componentStore;
+
+    return componentStore;
 }
 
 // ComponentID SceneAddComponent(Scene* scene, ComponentTypeID componentTypeID, void* component, Entity entity)
@@ -48,21 +78,34 @@ void SceneRegisterComponent(Scene* scene, char* componentName, size_t componentN
 
 /* ---------------------------------------------------- INTERNAL ---------------------------------------------------- */
 
-void SceneInit(Scene* scene)
+void SceneInit(Scene* scene, const Allocator* allocator)
 {
     LogAssert(scene != NULL);
 
     nextEntityID = 0;
+    scene->allocator = allocator;
+    scene->componentBucketPool = BucketPoolNew(allocator, SCENE_BUCKET_POOL_MAX_IDLE_SIZE);
 
-    DictionaryInit(&(scene->components), sizeof(ComponentTypeID), sizeof(SparseSet));
-    // DictionaryInit(&(scene->components), sizeof(ComponentTypeID), sizeof(Array));
-    SparseSetInit(&(scene->entities), sizeof(Entity), EntityGetID, 16);
+    ArrayInit(&(scene->componentStores), sizeof(SparseSet*), 1, 0, allocator);
+    SparseSetInitGeometric(&(scene->entities), sizeof(Entity), EntityGetID, STORE_FIRST_BUCKET_CAPACITY, 0, allocator);
 }
 
 void SceneDeinit(Scene* scene)
 {
     LogAssert(scene != NULL);
 
-    DictionaryDeinit(&(scene->components));
+    for(ComponentTypeIndex i = 0; i < ArrayNum(&(scene->componentStores)); ++i)
+    {
+        SparseSet* componentStore = SceneGetComponentStore(scene, i);
+
+        if(componentStore != NULL)
+        {
+            SparseSetDeinit(componentStore);
+            AllocatorFree(scene->allocator, componentStore, sizeof(SparseSet));
+        }
+    }
+
+    ArrayDeinit(&(scene->componentStores));
     SparseSetDeinit(&(scene->entities));
+    BucketPoolFree(scene->componentBucketPool);
 }
\ No newline at end of file
@@ -3,26 +3,46 @@
 
 #include "../../include/core/Scene.h"
 
-#include "Containers/Dictionary.h"
 #include "Containers/SparseSet.h"
+#include "Containers/BucketPool.h"
 #include "Entity.h"
 #include "Component.h"
 #include "System.h"
 
 Entity nextEntityID;
 
+static const size_t SCENE_BUCKET_POOL_MAX_IDLE_SIZE = 4 * 1024 * 1024;
+
 typedef struct Scene
 {
-    Dictionary components;  // Dictionary<ComponentTypeID, SparseSet<ComponentID>>
+    Array componentStores;  // SparseSet<Component>* per component type, indexed by ComponentTypeIndex. NULL until the scene gets its first component of that type.
     SparseSet entities;
+    BucketPool* componentBucketPool;    // Shared by the component stores, so they recycle each other's buckets.
+    const Allocator* allocator;
 } Scene;
 
 Entity SceneAddEntity(Scene* scene);
-void SceneRegisterComponent(Scene* scene, char* componentName, size_t componentNameSize, size_t componentSize);
+SparseSet* SceneGetOrAddComponentStore(Scene* scene, const ComponentTypeIndex componentTypeIndex, size_t componentSize, size_t componentAlignment);
 ComponentInstanceID SceneAddComponent(Scene* scene, ComponentTypeID componentTypeID, void* component, Entity entity);
 
-void SceneInit(Scene* scene);
+void SceneInit(Scene* scene, const Allocator* allocator);
 void SceneDeinit(Scene* scene);
 
+/**
+ * @brief Retrieve the store of a component type, with a single array lookup.
+ * @param scene The scene to retrieve the store from.
+ * @param componentTypeIndex The dense index of the component type.
+ * @return SparseSet* The sparse set holding the scene's components of that type. NULL if the scene never had a component of that type.
+ */
+static inline SparseSet* SceneGetComponentStore(const Scene* scene, const ComponentTypeIndex componentTypeIndex)
+{
+    if(componentTypeIndex >= scene->componentStores.num)
+    {
+        return NULL;
+    }
+
+    return *(SparseSet**) ArrayGetFast(&(scene->componentStores), componentTypeIndex);
+}
+
 
 #endif
\ No newline at end of file
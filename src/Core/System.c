@@ -5,14 +5,25 @@
 #include "Entity.h"
 
 System* SystemNew(const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []))
+{
+    return SystemNewWithAllocator(systemName, systemNameLength, componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction, NULL);
+}
+
+System* SystemNewWithAllocator(const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator)
 {
     LogAssert(systemName);
     LogAssert(systemNameLength > 0);
+
+    return SystemNewWithID(HashFNV1a64(systemName, systemNameLength), componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction, allocator);
+}
+
+System* SystemNewWithID(const SystemTypeID systemID, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator)
+{
     LogAssert(numComponentsToUpdate > 0);
     LogAssert(updateFunction);
 
-    System* newSystem = malloc(sizeof(System));
-    SystemInit(newSystem, systemName, systemNameLength, componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction);
+    System* newSystem = AllocatorAlloc(allocator, sizeof(System));
+    SystemInit(newSystem, systemID, componentsToUpdate, numComponentsToUpdate, updateOrder, updateFunction, allocator);
 
     return newSystem;
 }
@@ -21,27 +32,31 @@ void SystemFree(System* system)
 {
     LogAssert(system);
 
+    const Allocator* allocator = system->allocator;
+
     SystemDeinit(system);
-    free(system);
+    AllocatorFree(allocator, system, sizeof(System));
 }
 
 /* ---------------------------------------------------- INTERNAL ---------------------------------------------------- */
 
-void SystemInit(System* system, const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []))
+void SystemInit(System* system, const SystemTypeID systemID, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator)
 {
     LogAssert(system);
     LogAssert(numComponentsToUpdate > 0);
 
-    system->id = HashFNV1a64(systemName, systemNameLength);
+    system->id = systemID;
     system->updateOrder = updateOrder;
     system->updateFunction = updateFunction;
+    system->allocator = allocator;
 
-    SparseSetInit(&(system->compatibleEntities), sizeof(Entity), EntityGetID, 16); //TODO: hardcoded value!
-    ArrayInit(&(system->componentsToUpdate), sizeof(ComponentTypeID), numComponentsToUpdate);
+    SparseSetInitGeometric(&(system->compatibleEntities), sizeof(Entity), EntityGetID, STORE_FIRST_BUCKET_CAPACITY, 0, allocator);
+    ComponentTypeIDInlineArrayInit(&(system->componentsToUpdate), allocator);
+    ComponentTypeIndexInlineArrayInit(&(system->componentTypeIndicesToUpdate), allocator);
 
     for(int i = 0; i < numComponentsToUpdate; ++i)
     {
-        ArrayAdd(&(system->componentsToUpdate), &componentsToUpdate[i]);
+        ComponentTypeIDInlineArrayAdd(&(system->componentsToUpdate), componentsToUpdate[i]);
     }
 }
 
@@ -49,6 +64,7 @@ void SystemDeinit(System* system)
 {
     LogAssert(system);
 
-    ArrayDeinit(&(system->componentsToUpdate));
+    ComponentTypeIDInlineArrayDeinit(&(system->componentsToUpdate));
+    ComponentTypeIndexInlineArrayDeinit(&(system->componentTypeIndicesToUpdate));
     SparseSetDeinit(&(system->compatibleEntities));
 }
\ No newline at end of file
@@ -3,23 +3,23 @@
 
 #include "../include/core/System.h"
 
-#include "Containers/Array.h"
 #include "Containers/SparseSet.h"
+#include "Component.h"
 
 #include <stdint.h>
 
-typedef uint64_t SystemTypeID;
-
 typedef struct System
 {
     SystemTypeID id;
-    Array componentsToUpdate;
+    ComponentTypeIDInlineArray componentsToUpdate;
+    ComponentTypeIndexInlineArray componentTypeIndicesToUpdate;  // The dense indices of componentsToUpdate, resolved when the system gets registered.
     uint64_t updateOrder;
     void (*updateFunction)(int, void* []);
     SparseSet compatibleEntities;
+    const Allocator* allocator;
 } System;
 
-void SystemInit(System* system, const char* systemName, const size_t systemNameLength, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []));
+void SystemInit(System* system, const SystemTypeID systemID, const ComponentTypeID componentsToUpdate[], const uint8_t numComponentsToUpdate, uint64_t updateOrder, void (*updateFunction)(int, void* []), const Allocator* allocator);
 void SystemDeinit(System* system);
 
 #endif
\ No newline at end of file
@@ -1,15 +1,15 @@
 #include "Logger.h"
 
+#include "Utils/Clock.h"
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdarg.h>
-#include <time.h>
+
+LogLevel _logModuleLevels[LOG_NUM_MODULES] = { LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO, LOG_LEVEL_INFO };
 
 static void PrintHeader();
-static void PrintAssertTag();
-static void PrintErrorTag();
-static void PrintWarningTag();
-static void PrintInfoTag();
+static void LogWrite(LogSite* site, const LogLevel level, const char* file, const int line, const char* message, va_list argp);
 
 /**
  * @brief Print an error to the console if the assertion failed.
@@ -23,8 +23,19 @@ void _LogAssert(const char* file, const int line, const bool expression, const c
 {
     if(!expression)
     {
+        // The ring gets the assert first, since its file survives whatever happens next.
+        va_list ringArgp;
+        va_start(ringArgp, expressionString);
+        const char* ringMessage = va_arg(ringArgp, const char*);
+        LoggerRingWrite(LOG_LEVEL_ASSERT, file, line, expressionString, ringMessage, ringArgp);
+        va_end(ringArgp);
+
+        // The messages still waiting in the binary and async loggers are written first, so they aren't lost when the program exits.
+        LoggerBinaryFlushFatal();
+        LoggerAsyncFlushFatal();
+
         PrintHeader();
-        PrintAssertTag();
+        printf("%s", LogLevelGetTag(LOG_LEVEL_ASSERT, true));
 
         printf("%s:%d | %s", file, line, expressionString);
 
@@ -52,8 +63,16 @@ void _LogAssert(const char* file, const int line, const bool expression, const c
  */
 void _LogError(const char* file, const int line, const char* message, ...)
 {
+    va_list ringArgp;
+    va_start(ringArgp, message);
+    LoggerRingWrite(LOG_LEVEL_ERROR, file, line, NULL, message, ringArgp);
+    va_end(ringArgp);
+
+    LoggerBinaryFlushFatal();
+    LoggerAsyncFlushFatal();
+
     PrintHeader();
-    PrintErrorTag();
+    printf("%s", LogLevelGetTag(LOG_LEVEL_ERROR, true));
 
     printf("%s:%d | ", file, line);
 
@@ -68,96 +87,154 @@ void _LogError(const char* file, const int line, const char* message, ...)
 
 /**
  * @brief Print a warning to the console.
+ * @param site The static state of the call site, used by the binary logger. NULL if the call site has none.
  * @param file The file where the warning was called from.
  * @param line The line where the warning was called from.
  * @param message The warning to be printed.
  */
-void _LogWarning(const char* file, const int line, const char* message, ...)
+void _LogWarning(LogSite* site, const char* file, const int line, const char* message, ...)
 {
-    PrintHeader();
-    PrintWarningTag();
-
-    printf("%s:%d | ", file, line);
-
     va_list argp;
     va_start(argp, message);
-    vprintf(message, argp);
+    LogWrite(site, LOG_LEVEL_WARNING, file, line, message, argp);
     va_end(argp);
-    printf("\n");
 }
 
 /**
  * @brief Print info to the console.
+ * @param site The static state of the call site, used by the binary logger. NULL if the call site has none.
  * @param file The file where the info was called from.
  * @param line The line where the info was called from.
  * @param message The info to be printed.
  */
-void _LogInfo(const char* file, const int line, const char* message, ...)
+void _LogInfo(LogSite* site, const char* file, const int line, const char* message, ...)
 {
-    PrintHeader();
-    PrintInfoTag();
-
-    printf("%s:%d | ", file, line);
-
     va_list argp;
     va_start(argp, message);
-    vprintf(message, argp);
+    LogWrite(site, LOG_LEVEL_INFO, file, line, message, argp);
     va_end(argp);
-    printf("\n");
 }
 
-/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+/**
+ * @brief Set the minimum level of the messages logged by a module. This can't enable messages compiled out by LOG_MIN_LEVEL. Errors and asserts are logged regardless.
+ * @param module The module to set the level of.
+ * @param minLevel The lowest level still logged. LOG_LEVEL_NONE to silence the module's info and warnings.
+ */
+void LoggerSetModuleLevel(const LogModule module, const LogLevel minLevel)
+{
+    LogAssert(module < LOG_NUM_MODULES);
+    LogAssert(minLevel <= LOG_LEVEL_NONE);
+
+    _logModuleLevels[module] = minLevel;
+}
 
 /**
- * @brief Print the header of any message. This contains the current timestamp.
+ * @brief Set the minimum level of the messages logged by every module.
+ * @param minLevel The lowest level still logged. LOG_LEVEL_NONE to silence all info and warnings.
  */
-static void PrintHeader()
+void LoggerSetLevel(const LogLevel minLevel)
 {
-    char timeBuffer[32];
-    time_t t = time(NULL);
-    struct tm tm = { 0 };
-    localtime_s(&tm, &t);
+    for(int m = 0; m < LOG_NUM_MODULES; ++m)
+    {
+        LoggerSetModuleLevel(m, minLevel);
+    }
+}
 
-    strftime(timeBuffer, 32, "%d-%m-%y %H:%M:%S", &tm);
+/**
+ * @brief Get the minimum level of the messages logged by a module.
+ * @param module The module to get the level of.
+ * @return LogLevel The lowest level still logged.
+ */
+LogLevel LoggerGetModuleLevel(const LogModule module)
+{
+    LogAssert(module < LOG_NUM_MODULES);
 
-    printf("%s ", timeBuffer);
+    return _logModuleLevels[module];
 }
 
 /**
- * @brief Print an assert tag.
+ * @brief Count a message against the rate limit of its call site.
+ * @param rateLimit The state of the call site's rate limit.
+ * @param maxPerSecond The maximum number of messages the call site logs per second.
+ * @return bool Wether or not the message should be logged.
  */
-static void PrintAssertTag()
+bool _LogRateLimitAllows(LogRateLimit* rateLimit, const uint32_t maxPerSecond)
 {
-    printf("\033[1;31m");
-    printf("[ASSERT] ");
-    printf("\033[0m");
+    uint64_t second = (uint32_t) (ClockMonotonicNanoseconds() / 1000000000);
+    uint64_t state = atomic_load_explicit(rateLimit, memory_order_relaxed);
+    uint64_t newState;
+
+    do
+    {
+        if((state >> 32) != second)
+        {
+            newState = (second << 32) | 1;
+        }
+        else if((state & UINT32_MAX) < maxPerSecond)
+        {
+            newState = state + 1;
+        }
+        else
+        {
+            return false;
+        }
+    } while(!atomic_compare_exchange_weak_explicit(rateLimit, &state, newState, memory_order_relaxed, memory_order_relaxed));
+
+    return maxPerSecond > 0;
 }
 
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
 /**
- * @brief Print an error tag.
+ * @brief Get the tag messages of a level are printed with.
+ * @param level The level of the messages.
+ * @param isColored Wether or not the tag should include the escape codes coloring it on a console.
+ * @return const char* The tag, including its trailing space.
  */
-static void PrintErrorTag()
+const char* LogLevelGetTag(const LogLevel level, const bool isColored)
 {
-    printf("\033[1;31m");
-    printf("[ERROR] ");
-    printf("\033[0m");
+    static const char* const coloredTags[] = { "\033[0m[INFO] ", "\033[1;33m[WARNING] \033[0m", "\033[1;31m[ERROR] \033[0m", "\033[1;31m[ASSERT] \033[0m" };
+    static const char* const tags[] = { "[INFO] ", "[WARNING] ", "[ERROR] ", "[ASSERT] " };
+
+    return isColored ? coloredTags[level] : tags[level];
 }
 
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
 /**
- * @brief Print a warning tag.
+ * @brief Log a message, through the binary or async logger if one of them is running, or directly to the console otherwise. The ring logger gets a copy either way.
+ * @param site The static state of the call site. NULL if the call site has none.
+ * @param level The level of the message.
+ * @param file The file where the message was logged from.
+ * @param line The line where the message was logged from.
+ * @param message The format string of the message.
+ * @param argp The arguments of the format string.
  */
-static void PrintWarningTag()
+static void LogWrite(LogSite* site, const LogLevel level, const char* file, const int line, const char* message, va_list argp)
 {
-    printf("\033[1;33m");
-    printf("[WARNING] ");
-    printf("\033[0m");
+    // The ring keeps a copy of every message, next to where it's logged otherwise. It formats the message even when the binary logger stores it raw.
+    va_list ringArgp;
+    va_copy(ringArgp, argp);
+    LoggerRingWrite(level, file, line, NULL, message, ringArgp);
+    va_end(ringArgp);
+
+    if(LoggerBinaryWrite(site, level, file, line, message, argp) || LoggerAsyncWrite(level, file, line, message, argp))
+    {
+        return;
+    }
+
+    PrintHeader();
+    printf("%s", LogLevelGetTag(level, true));
+
+    printf("%s:%d | ", file, line);
+    vprintf(message, argp);
+    printf("\n");
 }
 
 /**
- * @brief Print an info tag.
+ * @brief Print the header of any message. This contains the current timestamp.
  */
-static void PrintInfoTag()
+static void PrintHeader()
 {
-    printf("\033[0m");
-    printf("[INFO] ");
+    printf("%s ", ClockWallString());
 }
\ No newline at end of file
@@ -3,4 +3,14 @@
 
 #include "../include/logger.h"
 
+#include <stdarg.h>
+
+const char* LogLevelGetTag(const LogLevel level, const bool isColored);
+
+void LoggerRingWrite(const LogLevel level, const char* file, const int line, const char* prefix, const char* message, va_list argp);
+bool LoggerBinaryWrite(LogSite* site, const LogLevel level, const char* file, const int line, const char* message, va_list argp);
+void LoggerBinaryFlushFatal();
+bool LoggerAsyncWrite(const LogLevel level, const char* file, const int line, const char* message, va_list argp);
+void LoggerAsyncFlushFatal();
+
 #endif
\ No newline at end of file
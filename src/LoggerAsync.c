@@ -0,0 +1,465 @@
+#include "Logger.h"
+
+#include "Utils/Allocator.h"
+#include "Utils/Clock.h"
+#include "Utils/Thread.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define LOG_RECORD_SIZE 256
+#define LOG_RECORD_MESSAGE_CAPACITY (LOG_RECORD_SIZE - 24)
+#define LOG_CACHE_LINE_SIZE 64
+
+static const size_t LOG_FLUSH_BUFFER_SIZE = 64 * 1024;
+static const uint32_t LOG_DEFAULT_RING_CAPACITY = 1024;
+static const uint32_t LOG_DEFAULT_FLUSH_INTERVAL_MILLISECONDS = 10;
+
+/**
+ * @brief A message waiting to be written. The message is formatted when it's logged, since its arguments can't outlive the call. Everything else is formatted by the flush thread.
+ */
+typedef struct LogRecord
+{
+    const char* file;
+    uint64_t ticks;     // The time the message was logged at, as read with ClockTicks.
+    int32_t line;
+    uint16_t messageLength;
+    uint8_t level;
+    char message[LOG_RECORD_MESSAGE_CAPACITY];
+} LogRecord;
+
+_Static_assert(sizeof(LogRecord) == LOG_RECORD_SIZE, "LogRecord should fill exactly LOG_RECORD_SIZE bytes.");
+
+/**
+ * @brief A single producer, single consumer ring of records. Each logging thread writes to its own ring, so logging never takes a lock, and the flush thread is the only one reading from them.
+ * The indices only ever increase, and are wrapped when accessing the records. The producer and consumer indices live on separate cache lines, so the threads don't keep stealing the line from each other.
+ */
+typedef struct LogRing
+{
+    _Alignas(LOG_CACHE_LINE_SIZE) atomic_uint_fast64_t writeIndex;     // Only written by the owning thread.
+    atomic_uint_fast64_t numDropped;                                    // Only written by the owning thread.
+    _Alignas(LOG_CACHE_LINE_SIZE) atomic_uint_fast64_t readIndex;      // Only written by the flush thread.
+    uint64_t numDroppedReported;                                        // Only accessed by the flush thread.
+    uint64_t indexMask;
+    struct LogRing* next;
+    LogRecord* records;
+} LogRing;
+
+/**
+ * @brief The state shared by the logging threads and the flush thread.
+ */
+typedef struct LoggerAsync
+{
+    _Atomic(LogRing*) rings;            // Every ring ever handed out since the logger started, pushed to the front.
+    atomic_bool isRunning;
+    atomic_bool shouldStop;
+    atomic_uint_fast64_t generation;    // Increased every start, so threads know their ring is from a previous run.
+    LoggerAsyncSettings settings;
+    FILE* output;
+    bool isOutputColored;
+    Thread* flushThread;
+    char* flushBuffer;                  // Only accessed by the flush thread, while it runs.
+    size_t flushBufferNum;              // Only accessed by the flush thread, while it runs.
+} LoggerAsync;
+
+static LoggerAsync logger = { 0 };
+
+static THREAD_LOCAL LogRing* threadRing = NULL;
+static THREAD_LOCAL uint64_t threadRingGeneration = 0;
+static THREAD_LOCAL bool isFlushThread = false;
+
+static LogRing* LoggerAsyncGetThreadRing();
+static void LoggerAsyncFlushThread(void* argument);
+static bool LoggerAsyncFlushRings(char* buffer, size_t* bufferNum);
+static void LoggerAsyncWriteRecord(const LogRecord* record, char* buffer, size_t* bufferNum);
+static void LoggerAsyncWriteBuffer(char* buffer, size_t* bufferNum);
+
+/**
+ * @brief Get the settings the async logger uses when no others are given.
+ * @return LoggerAsyncSettings The default settings, writing to stdout and dropping messages when a ring is full.
+ */
+LoggerAsyncSettings LoggerAsyncDefaultSettings()
+{
+    LoggerAsyncSettings settings;
+    settings.filePath = NULL;
+    settings.ringCapacity = LOG_DEFAULT_RING_CAPACITY;
+    settings.fullPolicy = LOG_FULL_POLICY_DROP;
+    settings.flushIntervalMilliseconds = LOG_DEFAULT_FLUSH_INTERVAL_MILLISECONDS;
+    return settings;
+}
+
+/**
+ * @brief Start writing info and warning messages asynchronously. Logging a message then only copies it to a ring buffer of the calling thread, and a background thread writes the messages in batches.
+ * Errors and failed asserts stay synchronous, and first flush the async logger, so the messages before them are written first.
+ * @param settings The settings of the logger. NULL for the default settings.
+ * @return bool Wether or not the logger was started. It fails when it's already running, or the output file, flush buffer or thread can't be created.
+ */
+bool LoggerAsyncStart(const LoggerAsyncSettings* settings)
+{
+    if(atomic_load(&(logger.isRunning)))
+    {
+        return false;
+    }
+
+    logger.settings = settings != NULL ? *settings : LoggerAsyncDefaultSettings();
+    LogAssert(logger.settings.ringCapacity > 0);
+    LogAssert(logger.settings.ringCapacity <= (UINT32_MAX / 2) + 1);
+
+    uint32_t ringCapacity = 1;
+    while(ringCapacity < logger.settings.ringCapacity)
+    {
+        ringCapacity *= 2;
+    }
+    logger.settings.ringCapacity = ringCapacity;
+
+    logger.output = logger.settings.filePath != NULL ? fopen(logger.settings.filePath, "a") : stdout;
+    logger.isOutputColored = logger.settings.filePath == NULL;
+
+    if(logger.output == NULL)
+    {
+        return false;
+    }
+
+    // The buffer is kept in the logger instead of on the flush thread's stack, so a failed assert on that thread can still write it out.
+    logger.flushBuffer = malloc(LOG_FLUSH_BUFFER_SIZE);
+    logger.flushBufferNum = 0;
+
+    if(logger.flushBuffer == NULL)
+    {
+        if(logger.output != stdout)
+        {
+            fclose(logger.output);
+        }
+
+        return false;
+    }
+
+    atomic_store(&(logger.rings), NULL);
+    atomic_store(&(logger.shouldStop), false);
+    atomic_fetch_add(&(logger.generation), 1);
+
+    // Messages logged before this start are printed directly, so stdout has to be flushed before the flush thread writes to it.
+    fflush(stdout);
+
+    logger.flushThread = ThreadNew(&LoggerAsyncFlushThread, NULL);
+
+    if(logger.flushThread == NULL)
+    {
+        if(logger.output != stdout)
+        {
+            fclose(logger.output);
+        }
+
+        free(logger.flushBuffer);
+        logger.flushBuffer = NULL;
+        return false;
+    }
+
+    atomic_store(&(logger.isRunning), true);
+    return true;
+}
+
+/**
+ * @brief Stop the async logger, after writing all messages still waiting in the rings. Messages logged afterwards are printed directly again.
+ * Other threads must not be logging while the logger stops, since their rings get freed.
+ */
+void LoggerAsyncStop()
+{
+    if(!atomic_exchange(&(logger.isRunning), false))
+    {
+        return;
+    }
+
+    atomic_store(&(logger.shouldStop), true);
+    ThreadJoin(logger.flushThread);
+    logger.flushThread = NULL;
+
+    free(logger.flushBuffer);
+    logger.flushBuffer = NULL;
+
+    if(logger.output != stdout)
+    {
+        fclose(logger.output);
+    }
+    else
+    {
+        fflush(stdout);
+    }
+
+    LogRing* ring = atomic_exchange(&(logger.rings), NULL);
+
+    while(ring != NULL)
+    {
+        LogRing* nextRing = ring->next;
+        free(ring->records);
+        AllocatorFreeAligned(NULL, ring, sizeof(LogRing), LOG_CACHE_LINE_SIZE);
+        ring = nextRing;
+    }
+}
+
+/**
+ * @brief Check wether the async logger is running.
+ * @return bool Wether or not messages are currently logged asynchronously.
+ */
+bool LoggerAsyncIsRunning()
+{
+    return atomic_load_explicit(&(logger.isRunning), memory_order_relaxed);
+}
+
+/**
+ * @brief Get the number of messages dropped because a ring was full, since the async logger started.
+ * @return uint64_t The number of dropped messages, over all threads.
+ */
+uint64_t LoggerAsyncNumDropped()
+{
+    uint64_t numDropped = 0;
+
+    for(LogRing* ring = atomic_load(&(logger.rings)); ring != NULL; ring = ring->next)
+    {
+        numDropped += atomic_load_explicit(&(ring->numDropped), memory_order_relaxed);
+    }
+
+    return numDropped;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Copy a message to the ring of the calling thread, if the async logger is running.
+ * @param level The level of the message.
+ * @param file The file where the message was logged from.
+ * @param line The line where the message was logged from.
+ * @param message The format string of the message.
+ * @param argp The arguments of the format string.
+ * @return bool Wether or not the async logger took care of the message. If not, the caller should print it itself.
+ */
+bool LoggerAsyncWrite(const LogLevel level, const char* file, const int line, const char* message, va_list argp)
+{
+    if(!atomic_load_explicit(&(logger.isRunning), memory_order_acquire))
+    {
+        return false;
+    }
+
+    LogRing* ring = LoggerAsyncGetThreadRing();
+
+    if(ring == NULL)
+    {
+        return false;
+    }
+
+    uint64_t writeIndex = atomic_load_explicit(&(ring->writeIndex), memory_order_relaxed);
+
+    while(writeIndex - atomic_load_explicit(&(ring->readIndex), memory_order_acquire) > ring->indexMask)
+    {
+        if(logger.settings.fullPolicy == LOG_FULL_POLICY_DROP)
+        {
+            atomic_store_explicit(&(ring->numDropped), atomic_load_explicit(&(ring->numDropped), memory_order_relaxed) + 1, memory_order_relaxed);
+            return true;
+        }
+
+        ThreadYield();
+    }
+
+    LogRecord* record = ring->records + (writeIndex & ring->indexMask);
+    record->file = file;
+    record->line = line;
+    record->level = level;
+    record->ticks = ClockTicks();
+
+    int messageLength = vsnprintf(record->message, LOG_RECORD_MESSAGE_CAPACITY, message, argp);
+    record->messageLength = messageLength < 0 ? 0 : (messageLength < LOG_RECORD_MESSAGE_CAPACITY ? messageLength : LOG_RECORD_MESSAGE_CAPACITY - 1);
+
+    atomic_store_explicit(&(ring->writeIndex), writeIndex + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Write all messages still waiting in the rings, before an error or failed assert exits the program. Unlike LoggerAsyncStop, the rings are not freed, since other threads might still be logging to them.
+ * When it's called from the flush thread itself, the rings are emptied right here, instead of waiting for the thread to finish.
+ */
+void LoggerAsyncFlushFatal()
+{
+    if(!atomic_exchange(&(logger.isRunning), false))
+    {
+        return;
+    }
+
+    if(!isFlushThread)
+    {
+        atomic_store(&(logger.shouldStop), true);
+        ThreadJoin(logger.flushThread);
+        logger.flushThread = NULL;
+    }
+    else
+    {
+        // The records the flush thread formatted before it failed go out first, so the output stays in order.
+        LoggerAsyncWriteBuffer(logger.flushBuffer, &(logger.flushBufferNum));
+        while(LoggerAsyncFlushRings(logger.flushBuffer, &(logger.flushBufferNum)));
+    }
+
+    fflush(logger.output);
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Get the ring of the calling thread, creating it on the thread's first message since the logger started.
+ * @return LogRing* The ring of the calling thread. NULL if it could not be allocated.
+ */
+static LogRing* LoggerAsyncGetThreadRing()
+{
+    uint64_t generation = atomic_load_explicit(&(logger.generation), memory_order_relaxed);
+
+    if(threadRing != NULL && threadRingGeneration == generation)
+    {
+        return threadRing;
+    }
+
+    LogRing* newRing = AllocatorAllocAligned(NULL, sizeof(LogRing), LOG_CACHE_LINE_SIZE);
+    LogRecord* records = malloc((size_t) logger.settings.ringCapacity * sizeof(LogRecord));
+
+    if(newRing == NULL || records == NULL)
+    {
+        if(newRing != NULL)
+        {
+            AllocatorFreeAligned(NULL, newRing, sizeof(LogRing), LOG_CACHE_LINE_SIZE);
+        }
+
+        free(records);
+        return NULL;
+    }
+
+    atomic_init(&(newRing->writeIndex), 0);
+    atomic_init(&(newRing->numDropped), 0);
+    atomic_init(&(newRing->readIndex), 0);
+    newRing->numDroppedReported = 0;
+    newRing->indexMask = logger.settings.ringCapacity - 1;
+    newRing->records = records;
+
+    newRing->next = atomic_load_explicit(&(logger.rings), memory_order_relaxed);
+    while(!atomic_compare_exchange_weak_explicit(&(logger.rings), &(newRing->next), newRing, memory_order_release, memory_order_relaxed));
+
+    threadRing = newRing;
+    threadRingGeneration = generation;
+    return newRing;
+}
+
+/**
+ * @brief The function of the flush thread. It keeps emptying the rings until the logger stops, and then empties them one last time.
+ * @param argument Unused.
+ */
+static void LoggerAsyncFlushThread(void* argument)
+{
+    isFlushThread = true;
+
+    char* buffer = logger.flushBuffer;
+    size_t* bufferNum = &(logger.flushBufferNum);
+
+    while(!atomic_load_explicit(&(logger.shouldStop), memory_order_acquire))
+    {
+        if(LoggerAsyncFlushRings(buffer, bufferNum))
+        {
+            continue;
+        }
+
+        // Wait in short steps, so stopping the logger doesn't have to wait for the whole interval.
+        for(uint32_t waited = 0; waited < logger.settings.flushIntervalMilliseconds && !atomic_load_explicit(&(logger.shouldStop), memory_order_relaxed); ++waited)
+        {
+            ThreadSleep(1);
+        }
+    }
+
+    while(LoggerAsyncFlushRings(buffer, bufferNum));
+}
+
+/**
+ * @brief Write all records waiting in the rings, and report the messages dropped since the last flush.
+ * @param buffer The buffer to batch the output in.
+ * @param bufferNum The number of bytes in the buffer.
+ * @return bool Wether or not any records were written.
+ */
+static bool LoggerAsyncFlushRings(char* buffer, size_t* bufferNum)
+{
+    bool hasWritten = false;
+
+    for(LogRing* ring = atomic_load_explicit(&(logger.rings), memory_order_acquire); ring != NULL; ring = ring->next)
+    {
+        uint64_t readIndex = atomic_load_explicit(&(ring->readIndex), memory_order_relaxed);
+        uint64_t writeIndex = atomic_load_explicit(&(ring->writeIndex), memory_order_acquire);
+
+        for(; readIndex < writeIndex; ++readIndex)
+        {
+            LoggerAsyncWriteRecord(ring->records + (readIndex & ring->indexMask), buffer, bufferNum);
+            hasWritten = true;
+        }
+
+        atomic_store_explicit(&(ring->readIndex), readIndex, memory_order_release);
+
+        uint64_t numDropped = atomic_load_explicit(&(ring->numDropped), memory_order_relaxed);
+
+        if(numDropped != ring->numDroppedReported)
+        {
+            LogRecord droppedRecord = { __FILE__, ClockTicks(), __LINE__, 0, LOG_LEVEL_WARNING, { 0 } };
+            droppedRecord.messageLength = snprintf(droppedRecord.message, LOG_RECORD_MESSAGE_CAPACITY, "Dropped %llu messages, because the ring of the logging thread was full.", (unsigned long long) (numDropped - ring->numDroppedReported));
+            LoggerAsyncWriteRecord(&droppedRecord, buffer, bufferNum);
+
+            ring->numDroppedReported = numDropped;
+            hasWritten = true;
+        }
+    }
+
+    if(hasWritten)
+    {
+        LoggerAsyncWriteBuffer(buffer, bufferNum);
+        fflush(logger.output);
+    }
+
+    return hasWritten;
+}
+
+/**
+ * @brief Format a record into the output buffer, writing the buffer out first if the record might not fit.
+ * @param record The record to format.
+ * @param buffer The buffer to batch the output in.
+ * @param bufferNum The number of bytes in the buffer.
+ */
+static void LoggerAsyncWriteRecord(const LogRecord* record, char* buffer, size_t* bufferNum)
+{
+    static uint64_t cachedSecond = UINT64_MAX;
+    static char cachedTimeString[CLOCK_WALL_STRING_SIZE];
+
+    // Formatting the timestamp is by far the most expensive part, and it only changes once per second.
+    uint64_t wallNanoseconds = ClockTicksToWallNanoseconds(record->ticks);
+
+    if(wallNanoseconds / 1000000000 != cachedSecond)
+    {
+        ClockFormatWallTime(wallNanoseconds, cachedTimeString, CLOCK_WALL_STRING_SIZE);
+        cachedSecond = wallNanoseconds / 1000000000;
+    }
+
+    if(LOG_FLUSH_BUFFER_SIZE - *bufferNum < LOG_RECORD_SIZE + 512)
+    {
+        LoggerAsyncWriteBuffer(buffer, bufferNum);
+    }
+
+    int headerLength = snprintf(buffer + *bufferNum, 512, "%s %s%s:%d | ", cachedTimeString, LogLevelGetTag(record->level, logger.isOutputColored), record->file, record->line);
+    *bufferNum += headerLength < 512 ? headerLength : 511;
+
+    memcpy(buffer + *bufferNum, record->message, record->messageLength);
+    *bufferNum += record->messageLength;
+    buffer[(*bufferNum)++] = '\n';
+}
+
+/**
+ * @brief Write the output buffer to the logger's output, and empty it.
+ * @param buffer The buffer to write.
+ * @param bufferNum The number of bytes in the buffer.
+ */
+static void LoggerAsyncWriteBuffer(char* buffer, size_t* bufferNum)
+{
+    fwrite(buffer, 1, *bufferNum, logger.output);
+    *bufferNum = 0;
+}
\ No newline at end of file
@@ -0,0 +1,918 @@
+#include "Logger.h"
+
+#include "Containers/Array.h"
+#include "Utils/Clock.h"
+#include "Utils/Thread.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define LOG_BINARY_MAX_STRING_LENGTH 1024
+#define LOG_BINARY_MAX_FORMAT_LENGTH 4096
+#define LOG_BINARY_FILE_HEADER_SIZE (8 + 4 + 8 + 8 + 8)
+#define LOG_BINARY_MESSAGE_HEADER_SIZE (1 + 4 + 8 + 4 + 2)
+#define LOG_BINARY_MAX_SITE_SIZE (1 + 4 + 1 + 4 + 2 + LOG_BINARY_MAX_STRING_LENGTH + 2 + LOG_BINARY_MAX_FORMAT_LENGTH)
+
+static const size_t LOG_BINARY_BUFFER_SIZE = 64 * 1024;
+static const char LOG_BINARY_MAGIC[8] = "UTCBLOG";
+static const uint32_t LOG_BINARY_VERSION = 2;
+static const uint32_t LOG_SITE_REGISTERING = UINT32_MAX;
+
+/**
+ * @brief The records in a binary log. Every record starts with its type, stored in 1 byte. All numbers are stored in the byte order of the machine that wrote the log.
+ * The log starts with the magic, the uint32 version, and the clock calibration: a double of nanoseconds per tick, and uint64 ticks with the uint64 wall clock nanoseconds they were read at.
+ */
+typedef enum LogBinaryRecordType
+{
+    LOG_BINARY_RECORD_SITE = 1,     // uint32 site ID, uint8 level, int32 line, uint16 + bytes file, uint16 + bytes format string.
+    LOG_BINARY_RECORD_MESSAGE = 2   // uint32 site ID, uint64 timestamp in ticks, uint32 thread ID, uint16 arguments size, arguments.
+} LogBinaryRecordType;
+
+/**
+ * @brief How an argument is read from the argument list, and stored in a message record. Integers, floating point numbers and pointers take 8 bytes, strings take a uint16 length followed by their characters.
+ */
+typedef enum LogArgumentType
+{
+    LOG_ARGUMENT_NONE,
+    LOG_ARGUMENT_INT,
+    LOG_ARGUMENT_LONG,
+    LOG_ARGUMENT_LONG_LONG,
+    LOG_ARGUMENT_INTMAX,
+    LOG_ARGUMENT_SIZE,
+    LOG_ARGUMENT_PTRDIFF,
+    LOG_ARGUMENT_DOUBLE,
+    LOG_ARGUMENT_LONG_DOUBLE,
+    LOG_ARGUMENT_STRING,
+    LOG_ARGUMENT_POINTER,
+    LOG_ARGUMENT_IGNORED    // %n, which is read but not stored.
+} LogArgumentType;
+
+/**
+ * @brief A single conversion specification in a format string, like "%-8.3lx".
+ */
+typedef struct LogFormatSpec
+{
+    const char* start;              // The '%' starting the specification.
+    const char* lengthModifier;     // The length modifier, which also ends the flags, width and precision.
+    const char* conversion;         // The conversion character, ending the specification.
+    uint8_t numStars;               // The number of int arguments for the width and precision, preceding the value.
+    LogArgumentType type;           // The type of the value. LOG_ARGUMENT_NONE for "%%".
+} LogFormatSpec;
+
+/**
+ * @brief The bytes a thread collects binary records in, before writing them to the log file all at once.
+ */
+typedef struct LogBinaryBuffer
+{
+    uint8_t* data;
+    atomic_size_t num;          // Only written by the owning thread.
+    atomic_bool isWritingOut;   // Set while the owning thread writes the buffer to the log file and empties it.
+    struct LogBinaryBuffer* next;
+} LogBinaryBuffer;
+
+/**
+ * @brief The state shared by the logging threads.
+ */
+typedef struct LoggerBinary
+{
+    _Atomic(LogBinaryBuffer*) buffers;  // Every buffer handed out since the logger started, pushed to the front.
+    atomic_bool isRunning;
+    atomic_uint_fast32_t generation;    // Increased every start, so sites and threads know they belong to a previous log.
+    FILE* output;
+} LoggerBinary;
+
+/**
+ * @brief A site definition read back from a binary log.
+ */
+typedef struct LogDecodedSite
+{
+    const uint8_t* file;
+    const uint8_t* format;
+    uint16_t fileLength;
+    uint16_t formatLength;
+    int32_t line;
+    uint8_t level;
+    bool isDefined;
+} LogDecodedSite;
+
+/**
+ * @brief A message read back from a binary log.
+ */
+typedef struct LogDecodedMessage
+{
+    uint64_t timestamp;         // The time the message was logged at, in ticks.
+    uint64_t sequence;          // The position of the message in the log, keeping messages with equal timestamps in order.
+    const uint8_t* arguments;
+    uint32_t siteID;
+    uint32_t threadID;
+    uint16_t argumentsSize;
+} LogDecodedMessage;
+
+static LoggerBinary logger = { 0 };
+static atomic_uint_fast32_t nextSiteID = 1;
+
+static THREAD_LOCAL LogBinaryBuffer* threadBuffer = NULL;
+static THREAD_LOCAL uint32_t threadBufferGeneration = 0;
+
+static LogBinaryBuffer* LoggerBinaryGetThreadBuffer();
+static uint8_t* LoggerBinaryReserve(LogBinaryBuffer* buffer, const size_t size);
+static void LoggerBinaryRegisterSite(LogSite* site, const char* format);
+static void LoggerBinaryWriteSite(LogBinaryBuffer* buffer, const uint32_t siteID, const LogLevel level, const char* file, const int line, const char* format);
+static size_t LoggerBinaryWriteArguments(const LogSite* site, uint8_t* destination, va_list argp);
+static bool LogFormatNextSpec(const char** format, LogFormatSpec* spec);
+static void LogDecodeMessage(FILE* output, const LogDecodedSite* site, const LogDecodedMessage* message, const uint64_t wallNanoseconds);
+static size_t LogFormatIntegerSize(const LogFormatSpec* spec);
+static int LogDecodedMessageCompare(const void* a, const void* b);
+
+/**
+ * @brief Start logging info and warning messages in binary. Instead of formatting a message, a call site only stores its ID, the clock ticks and the raw bytes of its arguments. The format string of a call site is stored once per log.
+ * Starting calibrates the clock first, if it isn't yet, which takes about 10 milliseconds.
+ * The log file can be converted to text afterwards with LoggerBinaryDecode, or the LogDecoder tool. Errors and failed asserts stay text, and first flush the binary logger, so the log is complete when the program exits.
+ * @param filePath The file to write the binary log to. It gets overwritten.
+ * @return bool Wether or not the logger was started. It fails when it's already running, or the file can't be opened.
+ */
+bool LoggerBinaryStart(const char* filePath)
+{
+    LogAssert(filePath != NULL);
+
+    if(atomic_load(&(logger.isRunning)))
+    {
+        return false;
+    }
+
+    logger.output = fopen(filePath, "wb");
+
+    if(logger.output == NULL)
+    {
+        return false;
+    }
+
+    double nanosecondsPerTick = ClockNanosecondsPerTick();
+    uint64_t referenceTicks = ClockTicks();
+    uint64_t referenceWallNanoseconds = ClockTicksToWallNanoseconds(referenceTicks);
+
+    fwrite(LOG_BINARY_MAGIC, 1, sizeof(LOG_BINARY_MAGIC), logger.output);
+    fwrite(&LOG_BINARY_VERSION, sizeof(LOG_BINARY_VERSION), 1, logger.output);
+    fwrite(&nanosecondsPerTick, sizeof(nanosecondsPerTick), 1, logger.output);
+    fwrite(&referenceTicks, sizeof(referenceTicks), 1, logger.output);
+    fwrite(&referenceWallNanoseconds, sizeof(referenceWallNanoseconds), 1, logger.output);
+
+    atomic_store(&(logger.buffers), NULL);
+    atomic_fetch_add(&(logger.generation), 1);
+    atomic_store(&(logger.isRunning), true);
+    return true;
+}
+
+/**
+ * @brief Stop the binary logger, after writing the buffers of all threads to the log file. Messages logged afterwards are logged as text again.
+ * Other threads must not be logging while the logger stops, since their buffers get freed.
+ */
+void LoggerBinaryStop()
+{
+    if(!atomic_exchange(&(logger.isRunning), false))
+    {
+        return;
+    }
+
+    LogBinaryBuffer* buffer = atomic_exchange(&(logger.buffers), NULL);
+
+    while(buffer != NULL)
+    {
+        fwrite(buffer->data, 1, atomic_load_explicit(&(buffer->num), memory_order_relaxed), logger.output);
+
+        LogBinaryBuffer* nextBuffer = buffer->next;
+        free(buffer->data);
+        free(buffer);
+        buffer = nextBuffer;
+    }
+
+    fclose(logger.output);
+    logger.output = NULL;
+}
+
+/**
+ * @brief Check wether the binary logger is running.
+ * @return bool Wether or not messages are currently logged in binary.
+ */
+bool LoggerBinaryIsRunning()
+{
+    return atomic_load_explicit(&(logger.isRunning), memory_order_relaxed);
+}
+
+/**
+ * @brief Convert a binary log to text. The messages are sorted by their timestamp, so the messages of different threads end up interleaved in the order they were logged.
+ * @param binaryFilePath The binary log to convert.
+ * @param textFilePath The file to write the text to. NULL to write it to stdout.
+ * @return bool Wether or not the log was converted. It fails when a file can't be opened, or the binary log is not valid.
+ */
+bool LoggerBinaryDecode(const char* binaryFilePath, const char* textFilePath)
+{
+    LogAssert(binaryFilePath != NULL);
+
+    FILE* input = fopen(binaryFilePath, "rb");
+
+    if(input == NULL)
+    {
+        return false;
+    }
+
+    fseek(input, 0, SEEK_END);
+    long inputSize = ftell(input);
+    fseek(input, 0, SEEK_SET);
+
+    uint8_t* data = malloc(inputSize > 0 ? inputSize : 1);
+    bool isRead = data != NULL && inputSize >= LOG_BINARY_FILE_HEADER_SIZE && fread(data, 1, inputSize, input) == (size_t) inputSize;
+    fclose(input);
+
+    uint32_t version = 0;
+    double nanosecondsPerTick = 0;
+    uint64_t referenceTicks = 0;
+    uint64_t referenceWallNanoseconds = 0;
+
+    if(isRead)
+    {
+        memcpy(&version, data + 8, 4);
+        memcpy(&nanosecondsPerTick, data + 12, 8);
+        memcpy(&referenceTicks, data + 20, 8);
+        memcpy(&referenceWallNanoseconds, data + 28, 8);
+    }
+
+    if(!isRead || memcmp(data, LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC)) != 0 || version != LOG_BINARY_VERSION)
+    {
+        free(data);
+        return false;
+    }
+
+    Array* sites = ArrayNew(sizeof(LogDecodedSite));
+    Array* messages = ArrayNew(sizeof(LogDecodedMessage));
+
+    const uint8_t* position = data + LOG_BINARY_FILE_HEADER_SIZE;
+    const uint8_t* end = data + inputSize;
+    bool isValid = true;
+
+    // A thread can log a message of a site before another thread's definition of that site ends up in the file, so all records are read before decoding any message.
+    while(position < end && isValid)
+    {
+        uint8_t recordType = *(position++);
+        uint32_t siteID;
+
+        if(recordType == LOG_BINARY_RECORD_SITE && end - position >= 4 + 1 + 4 + 2)
+        {
+            LogDecodedSite site;
+            memcpy(&siteID, position, 4);
+            site.level = position[4];
+            memcpy(&(site.line), position + 5, 4);
+            memcpy(&(site.fileLength), position + 9, 2);
+            position += 11;
+
+            site.file = position;
+            position += site.fileLength;
+
+            if(end - position < 2)
+            {
+                isValid = false;
+                break;
+            }
+
+            memcpy(&(site.formatLength), position, 2);
+            site.format = position + 2;
+            position += 2 + site.formatLength;
+            site.isDefined = true;
+
+            LogDecodedSite undefinedSite = { 0 };
+            ArrayReserve(sites, (uint64_t) siteID + 1);
+
+            while(ArrayNum(sites) <= siteID)
+            {
+                ArrayAdd(sites, &undefinedSite);
+            }
+
+            memcpy(ArrayGet(sites, siteID), &site, sizeof(LogDecodedSite));
+        }
+        else if(recordType == LOG_BINARY_RECORD_MESSAGE && end - position >= LOG_BINARY_MESSAGE_HEADER_SIZE - 1)
+        {
+            LogDecodedMessage message;
+            memcpy(&(message.siteID), position, 4);
+            memcpy(&(message.timestamp), position + 4, 8);
+            memcpy(&(message.threadID), position + 12, 4);
+            memcpy(&(message.argumentsSize), position + 16, 2);
+            message.arguments = position + 18;
+            message.sequence = ArrayNum(messages);
+            position += 18 + message.argumentsSize;
+
+            ArrayAdd(messages, &message);
+        }
+        else
+        {
+            isValid = false;
+        }
+    }
+
+    isValid = isValid && position == end;
+
+    FILE* output = textFilePath != NULL ? fopen(textFilePath, "w") : stdout;
+
+    if(isValid && output != NULL)
+    {
+        if(ArrayNum(messages) > 1)
+        {
+            qsort(ArrayGet(messages, 0), ArrayNum(messages), sizeof(LogDecodedMessage), &LogDecodedMessageCompare);
+        }
+
+        for(uint64_t i = 0; i < ArrayNum(messages); ++i)
+        {
+            LogDecodedMessage* message = ArrayGet(messages, i);
+            LogDecodedSite* site = message->siteID < ArrayNum(sites) ? ArrayGet(sites, message->siteID) : NULL;
+
+            if(site == NULL || !site->isDefined)
+            {
+                fprintf(output, "Message of unknown site %u.\n", message->siteID);
+                continue;
+            }
+
+            // The ticks of messages logged before the reference are converted in the other direction, so the unsigned subtraction can't wrap.
+            uint64_t wallNanoseconds = message->timestamp >= referenceTicks ? referenceWallNanoseconds + (uint64_t) ((double) (message->timestamp - referenceTicks) * nanosecondsPerTick) : referenceWallNanoseconds - (uint64_t) ((double) (referenceTicks - message->timestamp) * nanosecondsPerTick);
+            LogDecodeMessage(output, site, message, wallNanoseconds);
+        }
+    }
+
+    if(output != NULL && output != stdout)
+    {
+        fclose(output);
+    }
+
+    ArrayFree(sites);
+    ArrayFree(messages);
+    free(data);
+
+    return isValid && output != NULL;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Store a message in the binary log of the calling thread, if the binary logger is running.
+ * @param site The static state of the call site. NULL if the call site has none, in which case its format string is stored with every message.
+ * @param level The level of the message.
+ * @param file The file where the message was logged from.
+ * @param line The line where the message was logged from.
+ * @param message The format string of the message. This has to stay valid until the logger stops.
+ * @param argp The arguments of the format string.
+ * @return bool Wether or not the binary logger took care of the message. If not, the caller should log it some other way.
+ */
+bool LoggerBinaryWrite(LogSite* site, const LogLevel level, const char* file, const int line, const char* message, va_list argp)
+{
+    if(!atomic_load_explicit(&(logger.isRunning), memory_order_acquire))
+    {
+        return false;
+    }
+
+    LogBinaryBuffer* buffer = LoggerBinaryGetThreadBuffer();
+
+    if(buffer == NULL)
+    {
+        return false;
+    }
+
+    LogSite siteWithoutState = { 0 };
+    site = site != NULL ? site : &siteWithoutState;
+
+    if(atomic_load_explicit(&(site->id), memory_order_acquire) == 0)
+    {
+        LoggerBinaryRegisterSite(site, message);
+    }
+
+    uint32_t siteID;
+
+    // Another thread is reading the argument types of the site, which only takes a moment.
+    while((siteID = atomic_load_explicit(&(site->id), memory_order_acquire)) == LOG_SITE_REGISTERING)
+    {
+        ThreadYield();
+    }
+
+    uint32_t generation = atomic_load_explicit(&(logger.generation), memory_order_relaxed);
+    uint32_t siteGeneration = atomic_load_explicit(&(site->generation), memory_order_relaxed);
+
+    if(siteGeneration != generation && atomic_compare_exchange_strong(&(site->generation), &siteGeneration, generation))
+    {
+        LoggerBinaryWriteSite(buffer, siteID, level, file, line, message);
+    }
+
+    size_t maxArgumentsSize = 0;
+
+    for(uint8_t a = 0; a < site->numArguments; ++a)
+    {
+        maxArgumentsSize += site->argumentTypes[a] == LOG_ARGUMENT_STRING ? 2 + LOG_BINARY_MAX_STRING_LENGTH : 8;
+    }
+
+    uint8_t* record = LoggerBinaryReserve(buffer, LOG_BINARY_MESSAGE_HEADER_SIZE + maxArgumentsSize);
+
+    if(record == NULL)
+    {
+        return false;
+    }
+
+    uint64_t timestamp = ClockTicks();
+    uint32_t threadID = ThreadGetID();
+    uint16_t argumentsSize = (uint16_t) LoggerBinaryWriteArguments(site, record + LOG_BINARY_MESSAGE_HEADER_SIZE, argp);
+
+    record[0] = LOG_BINARY_RECORD_MESSAGE;
+    memcpy(record + 1, &siteID, 4);
+    memcpy(record + 5, &timestamp, 8);
+    memcpy(record + 13, &threadID, 4);
+    memcpy(record + 17, &argumentsSize, 2);
+
+    atomic_store_explicit(&(buffer->num), atomic_load_explicit(&(buffer->num), memory_order_relaxed) + LOG_BINARY_MESSAGE_HEADER_SIZE + argumentsSize, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Write the buffers of all threads to the log file, before an error or failed assert exits the program. Unlike LoggerBinaryStop, the buffers are not freed, since other threads might still be logging to them.
+ * Only the records a thread finished before the flush are written. Threads that fill their buffer afterwards log as text again.
+ */
+void LoggerBinaryFlushFatal()
+{
+    if(!atomic_exchange(&(logger.isRunning), false))
+    {
+        return;
+    }
+
+    for(LogBinaryBuffer* buffer = atomic_load(&(logger.buffers)); buffer != NULL; buffer = buffer->next)
+    {
+        while(atomic_load(&(buffer->isWritingOut)))
+        {
+            ThreadYield();
+        }
+
+        fwrite(buffer->data, 1, atomic_load_explicit(&(buffer->num), memory_order_acquire), logger.output);
+    }
+
+    // The file is left open, since other threads might still be writing their full buffers to it. Exiting closes it.
+    fflush(logger.output);
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Get the buffer of the calling thread, creating it on the thread's first message since the logger started.
+ * @return LogBinaryBuffer* The buffer of the calling thread. NULL if it could not be allocated.
+ */
+static LogBinaryBuffer* LoggerBinaryGetThreadBuffer()
+{
+    uint32_t generation = atomic_load_explicit(&(logger.generation), memory_order_relaxed);
+
+    if(threadBuffer != NULL && threadBufferGeneration == generation)
+    {
+        return threadBuffer;
+    }
+
+    LogBinaryBuffer* newBuffer = malloc(sizeof(LogBinaryBuffer));
+    uint8_t* data = malloc(LOG_BINARY_BUFFER_SIZE);
+
+    if(newBuffer == NULL || data == NULL)
+    {
+        free(newBuffer);
+        free(data);
+        return NULL;
+    }
+
+    newBuffer->data = data;
+    atomic_init(&(newBuffer->num), 0);
+    atomic_init(&(newBuffer->isWritingOut), false);
+
+    newBuffer->next = atomic_load_explicit(&(logger.buffers), memory_order_relaxed);
+    while(!atomic_compare_exchange_weak_explicit(&(logger.buffers), &(newBuffer->next), newBuffer, memory_order_release, memory_order_relaxed));
+
+    threadBuffer = newBuffer;
+    threadBufferGeneration = generation;
+    return newBuffer;
+}
+
+/**
+ * @brief Make room for a record at the end of a buffer, writing the buffer to the log file first if the record might not fit.
+ * @param buffer The buffer to make room in.
+ * @param size The maximum size of the record.
+ * @return uint8_t* The location to write the record to. The caller still has to add the actual size of the record to the buffer. NULL if the buffer is full, and a fatal flush is writing it.
+ */
+static uint8_t* LoggerBinaryReserve(LogBinaryBuffer* buffer, const size_t size)
+{
+    size_t num = atomic_load_explicit(&(buffer->num), memory_order_relaxed);
+
+    if(LOG_BINARY_BUFFER_SIZE - num < size)
+    {
+        // The buffer can't be emptied once a fatal flush started, since the flush might be reading it. LoggerBinaryFlushFatal waits for a buffer being written out.
+        atomic_store(&(buffer->isWritingOut), true);
+
+        if(!atomic_load(&(logger.isRunning)))
+        {
+            atomic_store(&(buffer->isWritingOut), false);
+            return NULL;
+        }
+
+        // The C library locks the file for every write, so a whole buffer of records ends up in the file in one piece.
+        fwrite(buffer->data, 1, num, logger.output);
+        atomic_store_explicit(&(buffer->num), 0, memory_order_relaxed);
+        atomic_store_explicit(&(buffer->isWritingOut), false, memory_order_release);
+        num = 0;
+    }
+
+    return buffer->data + num;
+}
+
+/**
+ * @brief Give a site its ID, and read the types of its arguments from its format string. When multiple threads register the same site at once, only one of them does, and the others wait for it.
+ * @param site The site to register.
+ * @param format The format string of the site.
+ */
+static void LoggerBinaryRegisterSite(LogSite* site, const char* format)
+{
+    uint32_t unregistered = 0;
+
+    if(!atomic_compare_exchange_strong(&(site->id), &unregistered, LOG_SITE_REGISTERING))
+    {
+        return;
+    }
+
+    LogFormatSpec spec;
+    site->numArguments = 0;
+
+    while(LogFormatNextSpec(&format, &spec))
+    {
+        for(uint8_t s = 0; s < spec.numStars && site->numArguments < LOG_SITE_MAX_ARGUMENTS; ++s)
+        {
+            site->argumentTypes[site->numArguments++] = LOG_ARGUMENT_INT;
+        }
+
+        if(spec.type != LOG_ARGUMENT_NONE && site->numArguments < LOG_SITE_MAX_ARGUMENTS)
+        {
+            site->argumentTypes[site->numArguments++] = spec.type;
+        }
+    }
+
+    atomic_store_explicit(&(site->id), atomic_fetch_add_explicit(&nextSiteID, 1, memory_order_relaxed), memory_order_release);
+}
+
+/**
+ * @brief Write the definition of a site to a buffer, so the decoder knows how to format its messages.
+ * @param buffer The buffer to write the definition to.
+ * @param siteID The ID of the site.
+ * @param level The level of the site's messages.
+ * @param file The file the site is in.
+ * @param line The line the site is on.
+ * @param format The format string of the site.
+ */
+static void LoggerBinaryWriteSite(LogBinaryBuffer* buffer, const uint32_t siteID, const LogLevel level, const char* file, const int line, const char* format)
+{
+    uint16_t fileLength = (uint16_t) strnlen(file, LOG_BINARY_MAX_STRING_LENGTH);
+    uint16_t formatLength = (uint16_t) strnlen(format, LOG_BINARY_MAX_FORMAT_LENGTH);
+    int32_t siteLine = line;
+
+    uint8_t* record = LoggerBinaryReserve(buffer, LOG_BINARY_MAX_SITE_SIZE);
+
+    if(record == NULL)
+    {
+        return;
+    }
+
+    record[0] = LOG_BINARY_RECORD_SITE;
+    memcpy(record + 1, &siteID, 4);
+    record[5] = (uint8_t) level;
+    memcpy(record + 6, &siteLine, 4);
+    memcpy(record + 10, &fileLength, 2);
+    memcpy(record + 12, file, fileLength);
+    memcpy(record + 12 + fileLength, &formatLength, 2);
+    memcpy(record + 14 + fileLength, format, formatLength);
+
+    atomic_store_explicit(&(buffer->num), atomic_load_explicit(&(buffer->num), memory_order_relaxed) + 14 + fileLength + formatLength, memory_order_release);
+}
+
+/**
+ * @brief Copy the raw bytes of the arguments of a message, as described by the argument types of its site.
+ * @param site The site of the message.
+ * @param destination The location to write the arguments to.
+ * @param argp The arguments of the message.
+ * @return size_t The number of bytes written.
+ */
+static size_t LoggerBinaryWriteArguments(const LogSite* site, uint8_t* destination, va_list argp)
+{
+    uint8_t* position = destination;
+
+    for(uint8_t a = 0; a < site->numArguments; ++a)
+    {
+        int64_t integer = 0;
+        double floatingPoint = 0;
+        uint64_t pointer = 0;
+
+        switch(site->argumentTypes[a])
+        {
+            case LOG_ARGUMENT_INT:          integer = va_arg(argp, int); break;
+            case LOG_ARGUMENT_LONG:         integer = va_arg(argp, long); break;
+            case LOG_ARGUMENT_LONG_LONG:    integer = va_arg(argp, long long); break;
+            case LOG_ARGUMENT_INTMAX:       integer = va_arg(argp, intmax_t); break;
+            case LOG_ARGUMENT_SIZE:         integer = (int64_t) va_arg(argp, size_t); break;
+            case LOG_ARGUMENT_PTRDIFF:      integer = va_arg(argp, ptrdiff_t); break;
+            case LOG_ARGUMENT_DOUBLE:       floatingPoint = va_arg(argp, double); break;
+            case LOG_ARGUMENT_LONG_DOUBLE:  floatingPoint = (double) va_arg(argp, long double); break;
+            case LOG_ARGUMENT_POINTER:      pointer = (uintptr_t) va_arg(argp, void*); break;
+            case LOG_ARGUMENT_IGNORED:      va_arg(argp, void*); continue;
+            case LOG_ARGUMENT_STRING:
+            {
+                const char* string = va_arg(argp, const char*);
+                string = string != NULL ? string : "(null)";
+
+                uint16_t length = (uint16_t) strnlen(string, LOG_BINARY_MAX_STRING_LENGTH);
+                memcpy(position, &length, 2);
+                memcpy(position + 2, string, length);
+                position += 2 + length;
+                continue;
+            }
+        }
+
+        switch(site->argumentTypes[a])
+        {
+            case LOG_ARGUMENT_DOUBLE:
+            case LOG_ARGUMENT_LONG_DOUBLE:  memcpy(position, &floatingPoint, 8); break;
+            case LOG_ARGUMENT_POINTER:      memcpy(position, &pointer, 8); break;
+            default:                        memcpy(position, &integer, 8); break;
+        }
+
+        position += 8;
+    }
+
+    return position - destination;
+}
+
+/**
+ * @brief Find the next conversion specification in a format string.
+ * @param format The format string to search. This gets moved past the found specification.
+ * @param spec The found specification.
+ * @return bool Wether or not a specification was found.
+ */
+static bool LogFormatNextSpec(const char** format, LogFormatSpec* spec)
+{
+    const char* c = strchr(*format, '%');
+
+    if(c == NULL)
+    {
+        return false;
+    }
+
+    spec->start = c++;
+    spec->numStars = 0;
+
+    while(*c != '\0' && strchr("-+ #0'", *c) != NULL)
+    {
+        ++c;
+    }
+
+    for(int widthAndPrecision = 0; widthAndPrecision < 2; ++widthAndPrecision)
+    {
+        if(widthAndPrecision == 1)
+        {
+            if(*c != '.')
+            {
+                break;
+            }
+
+            ++c;
+        }
+
+        if(*c == '*')
+        {
+            ++(spec->numStars);
+            ++c;
+        }
+
+        while(*c >= '0' && *c <= '9')
+        {
+            ++c;
+        }
+    }
+
+    spec->lengthModifier = c;
+
+    while(*c != '\0' && strchr("hlLqjzt", *c) != NULL)
+    {
+        ++c;
+    }
+
+    if(*c == '\0')
+    {
+        return false;
+    }
+
+    spec->conversion = c;
+    *format = c + 1;
+
+    size_t modifierLength = spec->conversion - spec->lengthModifier;
+    char modifier = modifierLength > 0 ? *(spec->lengthModifier) : '\0';
+
+    switch(*c)
+    {
+        case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+            spec->type = modifier == 'l' ? (modifierLength == 2 ? LOG_ARGUMENT_LONG_LONG : LOG_ARGUMENT_LONG) :
+                         (modifier == 'q') ? LOG_ARGUMENT_LONG_LONG :
+                         (modifier == 'j') ? LOG_ARGUMENT_INTMAX :
+                         (modifier == 'z') ? LOG_ARGUMENT_SIZE :
+                         (modifier == 't') ? LOG_ARGUMENT_PTRDIFF : LOG_ARGUMENT_INT;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->type = modifier == 'L' ? LOG_ARGUMENT_LONG_DOUBLE : LOG_ARGUMENT_DOUBLE;
+            break;
+        case 's': spec->type = LOG_ARGUMENT_STRING; break;
+        case 'p': spec->type = LOG_ARGUMENT_POINTER; break;
+        case 'n': spec->type = LOG_ARGUMENT_IGNORED; break;
+        default: spec->type = LOG_ARGUMENT_NONE; break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Format a message read back from a binary log, and write it to the output.
+ * @param output The file to write the message to.
+ * @param site The site of the message.
+ * @param message The message to format.
+ * @param wallNanoseconds The wall clock time the message was logged at, in nanoseconds since the epoch.
+ */
+static void LogDecodeMessage(FILE* output, const LogDecodedSite* site, const LogDecodedMessage* message, const uint64_t wallNanoseconds)
+{
+    char format[LOG_BINARY_MAX_FORMAT_LENGTH + 1];
+    memcpy(format, site->format, site->formatLength);
+    format[site->formatLength] = '\0';
+
+    char timeBuffer[CLOCK_WALL_STRING_SIZE];
+    ClockFormatWallTime(wallNanoseconds, timeBuffer, CLOCK_WALL_STRING_SIZE);
+
+    LogLevel level = site->level <= LOG_LEVEL_ASSERT ? site->level : LOG_LEVEL_INFO;
+    fprintf(output, "%s.%03u [T%u] %s%.*s:%d | ", timeBuffer, (unsigned) (wallNanoseconds / 1000000 % 1000), message->threadID, LogLevelGetTag(level, false), site->fileLength, (const char*) site->file, site->line);
+
+    const uint8_t* argument = message->arguments;
+    const uint8_t* argumentsEnd = message->arguments + message->argumentsSize;
+    const char* text = format;
+    const char* literal = text;
+    LogFormatSpec spec;
+
+    for(; LogFormatNextSpec(&text, &spec); literal = text)
+    {
+        fwrite(literal, 1, spec.start - literal, output);
+
+        size_t valueSize = (spec.type == LOG_ARGUMENT_NONE || spec.type == LOG_ARGUMENT_IGNORED) ? 0 : (spec.type == LOG_ARGUMENT_STRING ? 2 : 8);
+
+        if(spec.type == LOG_ARGUMENT_NONE)
+        {
+            fwrite(spec.conversion, 1, *(spec.conversion) == '%' ? 1 : 0, output);
+            continue;
+        }
+
+        // Arguments past the maximum per site are not stored, so their specifications are written as they are.
+        if(argumentsEnd - argument < (ptrdiff_t) (spec.numStars * 8 + valueSize))
+        {
+            fwrite(spec.start, 1, spec.conversion + 1 - spec.start, output);
+            argument = argumentsEnd;
+            continue;
+        }
+
+        // The specification is rebuilt with the stored width and precision filled in, and without its length modifier, since every value is decoded to a fixed type.
+        char specFormat[64];
+        size_t specLength = 0;
+
+        for(const char* c = spec.start; c < spec.lengthModifier && specLength < sizeof(specFormat) - 16; ++c)
+        {
+            if(*c != '*')
+            {
+                specFormat[specLength++] = *c;
+                continue;
+            }
+
+            int64_t star;
+            memcpy(&star, argument, 8);
+            argument += 8;
+
+            // A negative precision counts as no precision at all.
+            if(star < 0 && specFormat[specLength - 1] == '.')
+            {
+                --specLength;
+                continue;
+            }
+
+            specLength += snprintf(specFormat + specLength, 16, "%d", (int) star);
+        }
+
+        char conversion = *(spec.conversion);
+        bool isInteger = strchr("diuoxX", conversion) != NULL;
+
+        if(isInteger)
+        {
+            specFormat[specLength++] = 'l';
+            specFormat[specLength++] = 'l';
+        }
+
+        specFormat[specLength++] = conversion;
+        specFormat[specLength] = '\0';
+
+        if(spec.type == LOG_ARGUMENT_IGNORED)
+        {
+            continue;
+        }
+
+        if(spec.type == LOG_ARGUMENT_STRING)
+        {
+            char string[LOG_BINARY_MAX_STRING_LENGTH + 1];
+            uint16_t length;
+            memcpy(&length, argument, 2);
+            length = length <= argumentsEnd - argument - 2 ? length : 0;
+            memcpy(string, argument + 2, length);
+            string[length] = '\0';
+            argument += 2 + length;
+
+            fprintf(output, specFormat, string);
+            continue;
+        }
+
+        uint64_t value;
+        memcpy(&value, argument, 8);
+        argument += 8;
+
+        if(spec.type == LOG_ARGUMENT_DOUBLE || spec.type == LOG_ARGUMENT_LONG_DOUBLE)
+        {
+            double floatingPoint;
+            memcpy(&floatingPoint, &value, 8);
+            fprintf(output, specFormat, floatingPoint);
+        }
+        else if(spec.type == LOG_ARGUMENT_POINTER)
+        {
+            fprintf(output, specFormat, (void*) (uintptr_t) value);
+        }
+        else if(conversion == 'c')
+        {
+            fprintf(output, specFormat, (int) value);
+        }
+        else
+        {
+            // The value is cut back to the size it was passed as, so -1 passed to %u still prints as 4294967295.
+            unsigned int shift = 64 - 8 * (unsigned int) LogFormatIntegerSize(&spec);
+            uint64_t unsignedValue = (value << shift) >> shift;
+            int64_t signedValue = (int64_t) (value << shift) >> shift;
+
+            if(conversion == 'd' || conversion == 'i')
+            {
+                fprintf(output, specFormat, (long long) signedValue);
+            }
+            else
+            {
+                fprintf(output, specFormat, (unsigned long long) unsignedValue);
+            }
+        }
+    }
+
+    fputs(literal, output);
+    fputc('\n', output);
+}
+
+/**
+ * @brief Get the size of the integer type a conversion specification reads, from its length modifier.
+ * @param spec The conversion specification of an integer.
+ * @return size_t The size of the integer type in bytes.
+ */
+static size_t LogFormatIntegerSize(const LogFormatSpec* spec)
+{
+    size_t modifierLength = spec->conversion - spec->lengthModifier;
+
+    if(modifierLength == 0)
+    {
+        return sizeof(int);
+    }
+
+    switch(*(spec->lengthModifier))
+    {
+        case 'h': return modifierLength == 2 ? sizeof(char) : sizeof(short);
+        case 'l': return modifierLength == 2 ? sizeof(long long) : sizeof(long);
+        case 'j': return sizeof(intmax_t);
+        case 'z': return sizeof(size_t);
+        case 't': return sizeof(ptrdiff_t);
+        default: return 8;
+    }
+}
+
+/**
+ * @brief Order decoded messages by their timestamp, and by their position in the log for equal timestamps.
+ * @param a The first message.
+ * @param b The second message.
+ * @return int Negative if a comes first, positive if b comes first.
+ */
+static int LogDecodedMessageCompare(const void* a, const void* b)
+{
+    const LogDecodedMessage* messageA = a;
+    const LogDecodedMessage* messageB = b;
+
+    if(messageA->timestamp != messageB->timestamp)
+    {
+        return messageA->timestamp < messageB->timestamp ? -1 : 1;
+    }
+
+    return messageA->sequence < messageB->sequence ? -1 : (messageA->sequence > messageB->sequence);
+}
\ No newline at end of file
@@ -0,0 +1,293 @@
+#include "Logger.h"
+
+#include "Utils/Clock.h"
+#include "Utils/Thread.h"
+#include "Utils/VirtualMemory.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define LOG_RING_HEADER_SIZE 4096
+#define LOG_RING_MAX_TEXT_LENGTH 512
+
+static const char LOG_RING_MAGIC[8] = "UTCRING";
+static const uint32_t LOG_RING_VERSION = 1;
+
+/**
+ * @brief The start of a ring file, in front of the ring itself. The write offset lives in the file too, so the ring can be read back after the process died.
+ */
+typedef struct LogRingHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t capacity;                  // The size of the ring in bytes, a multiple of 8.
+    _Atomic(uint64_t) writeOffset;      // The total number of bytes ever reserved in the ring. Records live at this offset, modulo the capacity.
+} LogRingHeader;
+
+/**
+ * @brief The header of a record in the ring, followed by its text. Records are 8 byte aligned, so the offset is never split by the end of the ring.
+ * The offset gets written last, and marks the record as complete. A record is only valid when its offset matches its position, which also rejects leftovers of earlier laps around the ring.
+ */
+typedef struct LogRingRecord
+{
+    _Atomic(uint64_t) offset;
+    uint64_t wallNanoseconds;
+    uint32_t size;          // The size of the record including its header and padding, a multiple of 8.
+    uint32_t threadID;
+    uint16_t textLength;
+    uint8_t level;
+    uint8_t padding[5];
+} LogRingRecord;
+
+_Static_assert(sizeof(LogRingRecord) == 32, "LogRingRecord should take exactly 32 bytes.");
+
+/**
+ * @brief The state of the ring logger.
+ */
+typedef struct LoggerRing
+{
+    atomic_bool isRunning;
+    LogRingHeader* header;
+    uint8_t* ring;
+    size_t mappedSize;
+} LoggerRing;
+
+static LoggerRing logger = { 0 };
+
+static void LogRingCopyTo(uint8_t* ring, const uint64_t capacity, const uint64_t offset, const void* source, const size_t size);
+static void LogRingCopyFrom(const uint8_t* ring, const uint64_t capacity, const uint64_t offset, void* destination, const size_t size);
+
+/**
+ * @brief Start copying every message to a ring in a memory mapped file, holding the most recent messages. Writing a message only takes plain stores to memory, but the file still holds them after a crash, or after the process got killed. The ring can be read back with LoggerRingDecode.
+ * The ring keeps running next to the other loggers, and also gets the errors and failed asserts. When the file already holds a ring of the same size, new messages are added after the ones in it.
+ * Every message is formatted into the ring when it's logged, also when the binary logger is running, so running both gives up the time the binary logger saves on formatting.
+ * Starting calibrates the clock first, if it isn't yet, which takes about 10 milliseconds. This way the first message, which might be a failed assert, doesn't have to wait for it.
+ * @param filePath The file to keep the ring in.
+ * @param size The size of the ring in bytes. This gets rounded up to the page size.
+ * @return bool Wether or not the logger was started. It fails when it's already running, or the file can't be mapped.
+ */
+bool LoggerRingStart(const char* filePath, const size_t size)
+{
+    LogAssert(filePath != NULL);
+    LogAssert(size > 0);
+
+    if(atomic_load(&(logger.isRunning)))
+    {
+        return false;
+    }
+
+    // Records hold the wall clock time, which needs the clock calibrated.
+    ClockCalibrate();
+
+    size_t mappedSize = VirtualMemoryRoundToPageSize(LOG_RING_HEADER_SIZE + size);
+    uint8_t* mapping = VirtualMemoryMapFile(filePath, mappedSize);
+
+    if(mapping == NULL)
+    {
+        return false;
+    }
+
+    LogRingHeader* header = (LogRingHeader*) mapping;
+    uint64_t capacity = mappedSize - LOG_RING_HEADER_SIZE;
+
+    if(memcmp(header->magic, LOG_RING_MAGIC, sizeof(LOG_RING_MAGIC)) != 0 || header->version != LOG_RING_VERSION || header->headerSize != LOG_RING_HEADER_SIZE || header->capacity != capacity)
+    {
+        memcpy(header->magic, LOG_RING_MAGIC, sizeof(LOG_RING_MAGIC));
+        header->version = LOG_RING_VERSION;
+        header->headerSize = LOG_RING_HEADER_SIZE;
+        header->capacity = capacity;
+        atomic_store(&(header->writeOffset), 0);
+    }
+
+    logger.header = header;
+    logger.ring = mapping + LOG_RING_HEADER_SIZE;
+    logger.mappedSize = mappedSize;
+
+    atomic_store_explicit(&(logger.isRunning), true, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Stop the ring logger, and unmap its file. Other threads must not be logging while the logger stops, since the mapping goes away.
+ */
+void LoggerRingStop()
+{
+    if(!atomic_exchange(&(logger.isRunning), false))
+    {
+        return;
+    }
+
+    VirtualMemoryUnmapFile(logger.header, logger.mappedSize);
+    logger.header = NULL;
+    logger.ring = NULL;
+}
+
+/**
+ * @brief Check wether the ring logger is running.
+ * @return bool Wether or not messages are currently copied to the ring.
+ */
+bool LoggerRingIsRunning()
+{
+    return atomic_load_explicit(&(logger.isRunning), memory_order_acquire);
+}
+
+/**
+ * @brief Convert the messages in a ring file to text, from the oldest to the newest. Records that were still being written when the process died are skipped.
+ * @param ringFilePath The ring file to convert.
+ * @param textFilePath The file to write the text to. NULL to write it to stdout.
+ * @return bool Wether or not the ring was converted. It fails when a file can't be opened, or the ring file is not valid.
+ */
+bool LoggerRingDecode(const char* ringFilePath, const char* textFilePath)
+{
+    LogAssert(ringFilePath != NULL);
+
+    FILE* input = fopen(ringFilePath, "rb");
+
+    if(input == NULL)
+    {
+        return false;
+    }
+
+    LogRingHeader header;
+    bool isValid = fread(&header, sizeof(LogRingHeader), 1, input) == 1 && memcmp(header.magic, LOG_RING_MAGIC, sizeof(LOG_RING_MAGIC)) == 0 && header.version == LOG_RING_VERSION && header.headerSize >= sizeof(LogRingHeader) && header.capacity > 0 && header.capacity % 8 == 0;
+
+    uint8_t* ring = isValid ? malloc(header.capacity) : NULL;
+    isValid = ring != NULL && fseek(input, header.headerSize, SEEK_SET) == 0 && fread(ring, 1, header.capacity, input) == header.capacity;
+    fclose(input);
+
+    FILE* output = isValid ? (textFilePath != NULL ? fopen(textFilePath, "w") : stdout) : NULL;
+
+    if(output == NULL)
+    {
+        free(ring);
+        return false;
+    }
+
+    uint64_t writeOffset = atomic_load(&(header.writeOffset));
+    uint64_t offset = writeOffset > header.capacity ? writeOffset - header.capacity : 0;
+
+    // The oldest bytes in the ring can be the middle of a record, so the records are searched for 8 bytes at a time until a valid one shows up.
+    while(offset + sizeof(LogRingRecord) <= writeOffset)
+    {
+        LogRingRecord record;
+        LogRingCopyFrom(ring, header.capacity, offset, &record, sizeof(LogRingRecord));
+
+        bool isRecord = atomic_load(&(record.offset)) == offset && record.size >= sizeof(LogRingRecord) && record.size % 8 == 0 && offset + record.size <= writeOffset && record.textLength <= record.size - sizeof(LogRingRecord) && record.textLength <= LOG_RING_MAX_TEXT_LENGTH;
+
+        if(!isRecord)
+        {
+            offset += 8;
+            continue;
+        }
+
+        char text[LOG_RING_MAX_TEXT_LENGTH];
+        LogRingCopyFrom(ring, header.capacity, offset + sizeof(LogRingRecord), text, record.textLength);
+
+        char timeBuffer[CLOCK_WALL_STRING_SIZE];
+        ClockFormatWallTime(record.wallNanoseconds, timeBuffer, CLOCK_WALL_STRING_SIZE);
+
+        LogLevel level = record.level <= LOG_LEVEL_ASSERT ? record.level : LOG_LEVEL_INFO;
+        fprintf(output, "%s.%03u [T%u] %s%.*s\n", timeBuffer, (unsigned) (record.wallNanoseconds / 1000000 % 1000), record.threadID, LogLevelGetTag(level, false), (int) record.textLength, text);
+
+        offset += record.size;
+    }
+
+    if(output != stdout)
+    {
+        fclose(output);
+    }
+
+    free(ring);
+    return true;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Copy a message to the ring, if the ring logger is running. Threads reserve their space with a single atomic add, so they never wait for each other.
+ * @param level The level of the message.
+ * @param file The file where the message was logged from.
+ * @param line The line where the message was logged from.
+ * @param prefix Text to put in front of the message, like the expression of a failed assert. NULL for none.
+ * @param message The format string of the message. NULL for none.
+ * @param argp The arguments of the format string.
+ */
+void LoggerRingWrite(const LogLevel level, const char* file, const int line, const char* prefix, const char* message, va_list argp)
+{
+    if(!atomic_load_explicit(&(logger.isRunning), memory_order_acquire))
+    {
+        return;
+    }
+
+    char text[LOG_RING_MAX_TEXT_LENGTH];
+    int textLength = prefix != NULL ? snprintf(text, LOG_RING_MAX_TEXT_LENGTH, "%s:%d | %s", file, line, prefix) : snprintf(text, LOG_RING_MAX_TEXT_LENGTH, "%s:%d | ", file, line);
+    textLength = textLength < 0 ? 0 : (textLength < LOG_RING_MAX_TEXT_LENGTH ? textLength : LOG_RING_MAX_TEXT_LENGTH - 1);
+
+    if(message != NULL)
+    {
+        if(prefix != NULL)
+        {
+            textLength += snprintf(text + textLength, LOG_RING_MAX_TEXT_LENGTH - textLength, " | ");
+            textLength = textLength < LOG_RING_MAX_TEXT_LENGTH ? textLength : LOG_RING_MAX_TEXT_LENGTH - 1;
+        }
+
+        int messageLength = vsnprintf(text + textLength, LOG_RING_MAX_TEXT_LENGTH - textLength, message, argp);
+        textLength += messageLength < 0 ? 0 : messageLength;
+        textLength = textLength < LOG_RING_MAX_TEXT_LENGTH ? textLength : LOG_RING_MAX_TEXT_LENGTH - 1;
+    }
+
+    LogRingRecord record;
+    record.wallNanoseconds = ClockTicksToWallNanoseconds(ClockTicks());
+    record.size = (sizeof(LogRingRecord) + textLength + 7) & ~7u;
+    record.threadID = ThreadGetID();
+    record.textLength = (uint16_t) textLength;
+    record.level = level;
+    memset(record.padding, 0, sizeof(record.padding));
+
+    uint64_t capacity = logger.header->capacity;
+    uint64_t offset = atomic_fetch_add_explicit(&(logger.header->writeOffset), record.size, memory_order_relaxed);
+
+    // Everything but the offset is written first. The offset is 8 byte aligned, so it never wraps around the end of the ring.
+    LogRingCopyTo(logger.ring, capacity, offset + sizeof(uint64_t), ((uint8_t*) &record) + sizeof(uint64_t), sizeof(LogRingRecord) - sizeof(uint64_t));
+    LogRingCopyTo(logger.ring, capacity, offset + sizeof(LogRingRecord), text, textLength);
+    atomic_store_explicit((_Atomic(uint64_t)*) (logger.ring + (offset % capacity)), offset, memory_order_release);
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Copy bytes into the ring, wrapping around its end.
+ * @param ring The start of the ring.
+ * @param capacity The size of the ring in bytes.
+ * @param offset The offset to copy to. This gets wrapped.
+ * @param source The bytes to copy.
+ * @param size The number of bytes to copy.
+ */
+static void LogRingCopyTo(uint8_t* ring, const uint64_t capacity, const uint64_t offset, const void* source, const size_t size)
+{
+    uint64_t start = offset % capacity;
+    size_t firstSize = size < capacity - start ? size : capacity - start;
+
+    memcpy(ring + start, source, firstSize);
+    memcpy(ring, (const uint8_t*) source + firstSize, size - firstSize);
+}
+
+/**
+ * @brief Copy bytes out of the ring, wrapping around its end.
+ * @param ring The start of the ring.
+ * @param capacity The size of the ring in bytes.
+ * @param offset The offset to copy from. This gets wrapped.
+ * @param destination The location to copy the bytes to.
+ * @param size The number of bytes to copy.
+ */
+static void LogRingCopyFrom(const uint8_t* ring, const uint64_t capacity, const uint64_t offset, void* destination, const size_t size)
+{
+    uint64_t start = offset % capacity;
+    size_t firstSize = size < capacity - start ? size : capacity - start;
+
+    memcpy(destination, ring + start, firstSize);
+    memcpy((uint8_t*) destination + firstSize, ring, size - firstSize);
+}
\ No newline at end of file
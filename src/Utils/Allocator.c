@@ -0,0 +1,217 @@
+#include "Allocator.h"
+
+#include "Logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+static void* DefaultAlloc(void* userData, const size_t size);
+static void* DefaultRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize);
+static void DefaultFree(void* userData, void* memory, const size_t size);
+static size_t AlignedBlockSize(const size_t size, const size_t alignment);
+
+static const Allocator DEFAULT_ALLOCATOR = { DefaultAlloc, DefaultRealloc, DefaultFree, NULL };
+
+/**
+ * @brief Get the default allocator, which uses malloc, realloc and free.
+ * @return const Allocator* A pointer to the default allocator.
+ */
+const Allocator* AllocatorGetDefault()
+{
+    return &DEFAULT_ALLOCATOR;
+}
+
+/**
+ * @brief Allocate a block of memory.
+ * @param allocator The allocator to allocate with. NULL to use the default allocator.
+ * @param size The size of the block in bytes.
+ * @return void* A pointer to the allocated block of memory.
+ */
+void* AllocatorAlloc(const Allocator* allocator, const size_t size)
+{
+    if(allocator == NULL)
+    {
+        allocator = &DEFAULT_ALLOCATOR;
+    }
+
+    void* memory = allocator->allocFunc(allocator->userData, size);
+    LogAssert(memory != NULL || size == 0, "Failed to allocate %zu bytes.", size);
+
+    return memory;
+}
+
+/**
+ * @brief Allocate a block of memory for an array of elements, and set it to 0.
+ * @param allocator The allocator to allocate with. NULL to use the default allocator.
+ * @param num The number of elements.
+ * @param size The memory footprint of 1 element.
+ * @return void* A pointer to the allocated block of memory.
+ */
+void* AllocatorCalloc(const Allocator* allocator, const size_t num, const size_t size)
+{
+    void* memory = AllocatorAlloc(allocator, num * size);
+
+    if(memory != NULL)
+    {
+        memset(memory, 0, num * size);
+    }
+
+    return memory;
+}
+
+/**
+ * @brief Resize a block of memory, preserving its content. If the block grows, the new memory is not initialized.
+ * @param allocator The allocator the block was allocated with. NULL to use the default allocator.
+ * @param memory The block of memory to resize. Can be NULL, in which case a new block gets allocated.
+ * @param prevSize The current size of the block in bytes.
+ * @param newSize The requested size of the block in bytes.
+ * @return void* A pointer to the resized block of memory. This might differ from the given pointer.
+ */
+void* AllocatorRealloc(const Allocator* allocator, void* memory, const size_t prevSize, const size_t newSize)
+{
+    if(allocator == NULL)
+    {
+        allocator = &DEFAULT_ALLOCATOR;
+    }
+
+    void* newMemory = allocator->reallocFunc(allocator->userData, memory, prevSize, newSize);
+    LogAssert(newMemory != NULL || newSize == 0, "Failed to reallocate %zu bytes.", newSize);
+
+    return newMemory;
+}
+
+/**
+ * @brief Free a block of memory.
+ * @param allocator The allocator the block was allocated with. NULL to use the default allocator.
+ * @param memory The block of memory to free. Nothing happens if this is NULL.
+ * @param size The size of the block in bytes.
+ */
+void AllocatorFree(const Allocator* allocator, void* memory, const size_t size)
+{
+    if(memory == NULL)
+    {
+        return;
+    }
+
+    if(allocator == NULL)
+    {
+        allocator = &DEFAULT_ALLOCATOR;
+    }
+
+    allocator->freeFunc(allocator->userData, memory, size);
+}
+
+/**
+ * @brief Allocate a block of memory with a stricter alignment than the allocator provides. The block is over-allocated, and the offset to the start of the underlying allocation is stored right in front of the aligned block.
+ * @param allocator The allocator to allocate with. NULL to use the default allocator.
+ * @param size The size of the block in bytes.
+ * @param alignment The alignment of the block in bytes. This has to be a power of 2. Alignments up to ALLOCATOR_DEFAULT_ALIGNMENT, including 0, don't add any overhead.
+ * @return void* A pointer to the aligned block of memory. This has to be freed with AllocatorFreeAligned. NULL if the allocation failed.
+ */
+void* AllocatorAllocAligned(const Allocator* allocator, const size_t size, const size_t alignment)
+{
+    LogAssert((alignment & (alignment - 1)) == 0, "Alignment %zu is not a power of 2.", alignment);
+
+    if(alignment <= ALLOCATOR_DEFAULT_ALIGNMENT)
+    {
+        return AllocatorAlloc(allocator, size);
+    }
+
+    LogAssert(alignment <= UINT16_MAX);
+
+    uint8_t* memory = AllocatorAlloc(allocator, AlignedBlockSize(size, alignment));
+
+    if(memory == NULL)
+    {
+        return NULL;
+    }
+
+    uint8_t* alignedMemory = (uint8_t*) (((uintptr_t) memory + sizeof(uint16_t) + alignment - 1) & ~(uintptr_t) (alignment - 1));
+
+    uint16_t offset = alignedMemory - memory;
+    memcpy(alignedMemory - sizeof(uint16_t), &offset, sizeof(uint16_t));
+
+    return alignedMemory;
+}
+
+/**
+ * @brief Resize a block of memory allocated with AllocatorAllocAligned, preserving its content. If the block grows, the new memory is not initialized.
+ * @param allocator The allocator the block was allocated with. NULL to use the default allocator.
+ * @param memory The block of memory to resize. Can be NULL, in which case a new block gets allocated.
+ * @param prevSize The current size of the block in bytes.
+ * @param newSize The requested size of the block in bytes.
+ * @param alignment The alignment the block was allocated with.
+ * @return void* A pointer to the resized, aligned block of memory. This might differ from the given pointer.
+ */
+void* AllocatorReallocAligned(const Allocator* allocator, void* memory, const size_t prevSize, const size_t newSize, const size_t alignment)
+{
+    if(alignment <= ALLOCATOR_DEFAULT_ALIGNMENT)
+    {
+        return AllocatorRealloc(allocator, memory, prevSize, newSize);
+    }
+
+    void* newMemory = AllocatorAllocAligned(allocator, newSize, alignment);
+
+    if(newMemory == NULL && newSize > 0) // The old block is left intact, like realloc does.
+    {
+        return NULL;
+    }
+
+    if(memory != NULL)
+    {
+        memcpy(newMemory, memory, prevSize < newSize ? prevSize : newSize);
+        AllocatorFreeAligned(allocator, memory, prevSize, alignment);
+    }
+
+    return newMemory;
+}
+
+/**
+ * @brief Free a block of memory allocated with AllocatorAllocAligned.
+ * @param allocator The allocator the block was allocated with. NULL to use the default allocator.
+ * @param memory The block of memory to free. Nothing happens if this is NULL.
+ * @param size The size of the block in bytes.
+ * @param alignment The alignment the block was allocated with.
+ */
+void AllocatorFreeAligned(const Allocator* allocator, void* memory, const size_t size, const size_t alignment)
+{
+    if(alignment <= ALLOCATOR_DEFAULT_ALIGNMENT || memory == NULL)
+    {
+        AllocatorFree(allocator, memory, size);
+        return;
+    }
+
+    uint16_t offset;
+    memcpy(&offset, (uint8_t*) memory - sizeof(uint16_t), sizeof(uint16_t));
+
+    AllocatorFree(allocator, (uint8_t*) memory - offset, AlignedBlockSize(size, alignment));
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Get the size of the underlying allocation of an aligned block, which leaves room to align the block and to store its offset.
+ * @param size The size of the aligned block in bytes.
+ * @param alignment The alignment of the block.
+ * @return size_t The size of the underlying allocation in bytes.
+ */
+static size_t AlignedBlockSize(const size_t size, const size_t alignment)
+{
+    return size + sizeof(uint16_t) + alignment - 1;
+}
+
+static void* DefaultAlloc(void* userData, const size_t size)
+{
+    return malloc(size);
+}
+
+static void* DefaultRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize)
+{
+    return realloc(memory, newSize);
+}
+
+static void DefaultFree(void* userData, void* memory, const size_t size)
+{
+    free(memory);
+}
\ No newline at end of file
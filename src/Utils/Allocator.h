@@ -0,0 +1,6 @@
+#ifndef ALLOCATOR_I
+#define ALLOCATOR_I
+
+#include "../../include/Utils/Allocator.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,274 @@
+#include "Arena.h"
+
+#include "VirtualMemory.h"
+#include "Thread.h"
+#include "Logger.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+static const size_t ARENA_ALIGNMENT = 16;
+static const size_t ARENA_COMMIT_SIZE = 64 * 1024;
+static const size_t FRAME_ARENA_MAX_SIZE = (size_t) 256 * 1024 * 1024;
+
+static THREAD_LOCAL Arena* frameArena = NULL;
+
+static void* ArenaAllocatorAlloc(void* userData, const size_t size);
+static void* ArenaAllocatorRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize);
+static void ArenaAllocatorFree(void* userData, void* memory, const size_t size);
+static bool ArenaIsLastAllocation(const Arena* arena, const void* memory, const size_t size);
+
+/**
+ * @brief Creates a new arena, and initializes it.
+ * @param maxSize The number of bytes of address space to reserve. Memory only gets committed as the arena is used.
+ * @return Arena* A pointer to the newly created arena.
+ */
+Arena* ArenaNew(const size_t maxSize)
+{
+    LogAssert(maxSize > 0);
+
+    Arena* newArena = malloc(sizeof(Arena));
+    LogAssert(newArena != NULL);
+
+    ArenaInit(newArena, maxSize);
+
+    return newArena;
+}
+
+/**
+ * @brief Allocate a block of memory from the arena. The block is aligned to 16 bytes and its content is not initialized.
+ * @param arena The arena to allocate from.
+ * @param size The size of the block in bytes.
+ * @return void* A pointer to the allocated block. This stays valid until the arena gets reset, or rewound to a mark taken before this allocation. NULL if the block doesn't fit in the reserved address space, or the memory for it could not be committed.
+ */
+void* ArenaAlloc(Arena* arena, const size_t size)
+{
+    LogAssert(arena != NULL);
+
+    size_t start = (arena->num + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+    // Compared against the space that's left, so a huge size can't wrap the end around.
+    if(start > arena->maxSize || size > arena->maxSize - start)
+    {
+        return NULL;
+    }
+
+    size_t end = start + size;
+
+    if(end > arena->committedSize)
+    {
+        size_t newCommittedSize = ((end + ARENA_COMMIT_SIZE - 1) / ARENA_COMMIT_SIZE) * ARENA_COMMIT_SIZE;
+        newCommittedSize = VirtualMemoryRoundToPageSize(newCommittedSize < arena->maxSize ? newCommittedSize : arena->maxSize);
+
+        if(!VirtualMemoryCommit(arena->memory + arena->committedSize, newCommittedSize - arena->committedSize))
+        {
+            return NULL;
+        }
+
+        arena->committedSize = newCommittedSize;
+    }
+
+    arena->num = end;
+
+    return arena->memory + start;
+}
+
+/**
+ * @brief Get the current position of the arena, so allocations made after this point can be released with ArenaRewind.
+ * @param arena The arena to get the position from.
+ * @return size_t The current position of the arena.
+ */
+size_t ArenaMark(const Arena* arena)
+{
+    LogAssert(arena != NULL);
+    return arena->num;
+}
+
+/**
+ * @brief Release all allocations made after a given mark. Committed memory is kept, so it can be reused without asking the OS again.
+ * @param arena The arena to rewind.
+ * @param mark A position previously returned by ArenaMark.
+ */
+void ArenaRewind(Arena* arena, const size_t mark)
+{
+    LogAssert(arena != NULL);
+    LogAssert(mark <= arena->num);
+
+    arena->num = mark;
+}
+
+/**
+ * @brief Release all allocations made from the arena. Committed memory is kept, so it can be reused without asking the OS again.
+ * @param arena The arena to reset.
+ */
+void ArenaReset(Arena* arena)
+{
+    ArenaRewind(arena, 0);
+}
+
+/**
+ * @brief Get an allocator, which allocates from the arena. Freeing or reallocating the most recent allocation happens in place, freeing other blocks does nothing until the arena gets reset.
+ * @param arena The arena to allocate from.
+ * @return const Allocator* A pointer to the allocator. This stays valid as long as the arena.
+ */
+const Allocator* ArenaGetAllocator(Arena* arena)
+{
+    LogAssert(arena != NULL);
+    return &(arena->allocator);
+}
+
+/**
+ * @brief Free the arena, including all memory allocated from it.
+ * @param arena The arena to free.
+ */
+void ArenaFree(Arena* arena)
+{
+    LogAssert(arena != NULL);
+
+    ArenaDeinit(arena);
+    free(arena);
+}
+
+/**
+ * @brief Get the number of bytes currently allocated from the arena, including alignment padding.
+ * @param arena The arena to get the number of bytes from.
+ * @return size_t The number of bytes in use.
+ */
+size_t ArenaNumBytesUsed(const Arena* arena)
+{
+    LogAssert(arena != NULL);
+    return arena->num;
+}
+
+/**
+ * @brief Get the frame arena of the calling thread, for scratch memory which only lives until the end of the frame. Every thread has its own frame arena, which gets created on first use. ECSUpdate releases everything allocated from it during the update when it returns.
+ * @return Arena* The frame arena of the calling thread.
+ */
+Arena* ArenaGetFrame()
+{
+    if(frameArena == NULL)
+    {
+        frameArena = ArenaNew(FRAME_ARENA_MAX_SIZE);
+    }
+
+    return frameArena;
+}
+
+/**
+ * @brief Free the frame arena of the calling thread. Call this before a thread, which used its frame arena, exits.
+ */
+void ArenaFreeFrame()
+{
+    if(frameArena != NULL)
+    {
+        ArenaFree(frameArena);
+        frameArena = NULL;
+    }
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Initialize an existing arena. Only used internally. When calling ArenaNew, the arena will already be initialized.
+ * @param arena The arena to be initialized.
+ * @param maxSize The number of bytes of address space to reserve.
+ */
+void ArenaInit(Arena* arena, const size_t maxSize)
+{
+    LogAssert(arena != NULL);
+    LogAssert(maxSize > 0);
+
+    arena->maxSize = VirtualMemoryRoundToPageSize(maxSize);
+    arena->memory = VirtualMemoryReserve(arena->maxSize);
+    arena->num = 0;
+    arena->committedSize = 0;
+
+    arena->allocator.allocFunc = ArenaAllocatorAlloc;
+    arena->allocator.reallocFunc = ArenaAllocatorRealloc;
+    arena->allocator.freeFunc = ArenaAllocatorFree;
+    arena->allocator.userData = arena;
+
+    LogAssert(arena->memory != NULL);
+}
+
+/**
+ * @brief Deinitialize the arena. This does not free the arena pointer. Use this function instead of free if the arena is stack allocated or allocated locally as a struct member.
+ * @param arena The arena to deinitialize.
+ */
+void ArenaDeinit(Arena* arena)
+{
+    LogAssert(arena != NULL);
+
+    VirtualMemoryRelease(arena->memory, arena->maxSize);
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+static void* ArenaAllocatorAlloc(void* userData, const size_t size)
+{
+    return ArenaAlloc(userData, size);
+}
+
+static void* ArenaAllocatorRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize)
+{
+    Arena* arena = userData;
+
+    if(memory != NULL && ArenaIsLastAllocation(arena, memory, prevSize))
+    {
+        size_t start = (uint8_t*) memory - arena->memory;
+
+        if(newSize > arena->maxSize - start)
+        {
+            return NULL;
+        }
+
+        // Rewinding keeps the aligned start, so the block grows or shrinks in place. When committing the new size fails, the block is kept as it was.
+        size_t mark = arena->num;
+        ArenaRewind(arena, start);
+        void* newMemory = ArenaAlloc(arena, newSize);
+
+        if(newMemory == NULL)
+        {
+            arena->num = mark;
+        }
+
+        return newMemory;
+    }
+
+    void* newMemory = ArenaAlloc(arena, newSize);
+
+    if(newMemory == NULL)
+    {
+        return NULL;
+    }
+
+    if(memory != NULL)
+    {
+        memcpy(newMemory, memory, prevSize < newSize ? prevSize : newSize);
+    }
+
+    return newMemory;
+}
+
+static void ArenaAllocatorFree(void* userData, void* memory, const size_t size)
+{
+    Arena* arena = userData;
+
+    if(ArenaIsLastAllocation(arena, memory, size))
+    {
+        ArenaRewind(arena, (uint8_t*) memory - arena->memory);
+    }
+}
+
+/**
+ * @brief Check wether a block is the most recent allocation of the arena, in which case it can be resized or freed in place.
+ * @param arena The arena the block was allocated from.
+ * @param memory The block of memory.
+ * @param size The size of the block in bytes.
+ * @return bool Wether or not the block ends at the current position of the arena.
+ */
+static bool ArenaIsLastAllocation(const Arena* arena, const void* memory, const size_t size)
+{
+    return (const uint8_t*) memory + size == arena->memory + arena->num;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef ARENA_I
+#define ARENA_I
+
+#include "../../include/Utils/Arena.h"
+
+#include <stdint.h>
+
+/**
+ * @brief A linear allocator, which hands out memory by bumping a pointer through a reserved range of address space. Memory is not freed individually, but all at once by resetting or rewinding the arena.
+ */
+struct Arena
+{
+    uint8_t* memory;        // The start of the reserved range of address space.
+    size_t num;             // The number of bytes handed out, including alignment padding.
+    size_t committedSize;   // The number of bytes at the start of the range, that are backed by memory.
+    size_t maxSize;         // The size of the reserved range in bytes.
+    Allocator allocator;    // Allocator interface, allocating from this arena.
+};
+
+void ArenaInit(Arena* arena, const size_t maxSize);
+void ArenaDeinit(Arena* arena);
+
+#endif
\ No newline at end of file
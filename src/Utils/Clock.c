@@ -0,0 +1,237 @@
+#include "Clock.h"
+
+#include "Thread.h"
+#include "Logger.h"
+
+#include <time.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CLOCK_HAS_TSC
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+static const uint64_t CLOCK_NANOSECONDS_PER_SECOND = 1000000000;
+static const uint64_t CLOCK_CALIBRATION_NANOSECONDS = 10000000;
+
+/**
+ * @brief The relation between the ticks and the other clocks, measured once.
+ */
+typedef struct ClockCalibration
+{
+    uint64_t ticks;                 // The ticks at the end of the calibration.
+    uint64_t wallNanoseconds;       // The wall clock time at the end of the calibration.
+    double nanosecondsPerTick;
+} ClockCalibration;
+
+enum
+{
+    CLOCK_UNCALIBRATED,
+    CLOCK_CALIBRATING,
+    CLOCK_CALIBRATED
+};
+
+static ClockCalibration calibration = { 0 };
+static atomic_int calibrationState = CLOCK_UNCALIBRATED;
+
+static THREAD_LOCAL char wallString[CLOCK_WALL_STRING_SIZE];
+static THREAD_LOCAL uint64_t wallStringExpiration = 0;
+
+static void ClockLocalTime(const time_t seconds, struct tm* localTime);
+
+/**
+ * @brief Read the monotonic clock. It never jumps, not even when the system time gets changed, so it's the clock to measure durations with.
+ * @return uint64_t The number of nanoseconds since an unspecified moment in the past.
+ */
+uint64_t ClockMonotonicNanoseconds()
+{
+#ifdef _WIN32
+    static LARGE_INTEGER frequency = { 0 };
+
+    if(frequency.QuadPart == 0)
+    {
+        QueryPerformanceFrequency(&frequency);
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+
+    uint64_t seconds = counter.QuadPart / frequency.QuadPart;
+    uint64_t remainder = counter.QuadPart % frequency.QuadPart;
+    return seconds * CLOCK_NANOSECONDS_PER_SECOND + (remainder * CLOCK_NANOSECONDS_PER_SECOND) / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * CLOCK_NANOSECONDS_PER_SECOND + now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Read the wall clock.
+ * @return uint64_t The number of nanoseconds since the epoch.
+ */
+uint64_t ClockWallNanoseconds()
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return (uint64_t) now.tv_sec * CLOCK_NANOSECONDS_PER_SECOND + now.tv_nsec;
+}
+
+/**
+ * @brief Read the cheapest clock available, which is the time stamp counter of the CPU on x86. Reading it takes a few nanoseconds, and no system call, so it's meant for timestamping many events. The ticks are converted to time afterwards, with ClockTicksToNanoseconds or ClockTicksToWallNanoseconds.
+ * On other architectures, the ticks are the nanoseconds of the monotonic clock.
+ * @return uint64_t The current number of ticks.
+ */
+uint64_t ClockTicks()
+{
+#ifdef CLOCK_HAS_TSC
+    return __rdtsc();
+#else
+    return ClockMonotonicNanoseconds();
+#endif
+}
+
+/**
+ * @brief Measure the rate of the ticks against the monotonic clock. This busy waits for about 10 milliseconds. It happens automatically the first time ticks get converted, but can be called up front to keep that wait out of a time critical moment.
+ * When multiple threads calibrate at once, only one of them measures, and the others wait for it.
+ */
+void ClockCalibrate()
+{
+    int state = CLOCK_UNCALIBRATED;
+
+    if(!atomic_compare_exchange_strong(&calibrationState, &state, CLOCK_CALIBRATING))
+    {
+        while(atomic_load_explicit(&calibrationState, memory_order_acquire) != CLOCK_CALIBRATED)
+        {
+            ThreadYield();
+        }
+
+        return;
+    }
+
+#ifdef CLOCK_HAS_TSC
+    uint64_t startTicks = ClockTicks();
+    uint64_t startNanoseconds = ClockMonotonicNanoseconds();
+    uint64_t endNanoseconds;
+
+    do
+    {
+        endNanoseconds = ClockMonotonicNanoseconds();
+    } while(endNanoseconds - startNanoseconds < CLOCK_CALIBRATION_NANOSECONDS);
+
+    uint64_t endTicks = ClockTicks();
+    calibration.nanosecondsPerTick = (double) (endNanoseconds - startNanoseconds) / (double) (endTicks - startTicks);
+#else
+    calibration.nanosecondsPerTick = 1.0;
+#endif
+
+    calibration.ticks = ClockTicks();
+    calibration.wallNanoseconds = ClockWallNanoseconds();
+
+    atomic_store_explicit(&calibrationState, CLOCK_CALIBRATED, memory_order_release);
+}
+
+/**
+ * @brief Get the duration of a single tick.
+ * @return double The number of nanoseconds per tick.
+ */
+double ClockNanosecondsPerTick()
+{
+    if(atomic_load_explicit(&calibrationState, memory_order_acquire) != CLOCK_CALIBRATED)
+    {
+        ClockCalibrate();
+    }
+
+    return calibration.nanosecondsPerTick;
+}
+
+/**
+ * @brief Convert a number of ticks to a duration.
+ * @param ticks The number of ticks, like the difference between two reads of ClockTicks.
+ * @return uint64_t The duration in nanoseconds.
+ */
+uint64_t ClockTicksToNanoseconds(const uint64_t ticks)
+{
+    return (uint64_t) ((double) ticks * ClockNanosecondsPerTick());
+}
+
+/**
+ * @brief Convert a read of ClockTicks to the wall clock time it was read at.
+ * @param ticks The ticks to convert.
+ * @return uint64_t The number of nanoseconds since the epoch.
+ */
+uint64_t ClockTicksToWallNanoseconds(const uint64_t ticks)
+{
+    double nanosecondsPerTick = ClockNanosecondsPerTick();
+
+    if(ticks >= calibration.ticks)
+    {
+        return calibration.wallNanoseconds + (uint64_t) ((double) (ticks - calibration.ticks) * nanosecondsPerTick);
+    }
+
+    return calibration.wallNanoseconds - (uint64_t) ((double) (calibration.ticks - ticks) * nanosecondsPerTick);
+}
+
+/**
+ * @brief Get the current local time as text, like "31-12-24 23:59:59". Every thread caches the text, and only formats it again once the second changes, so it's cheap to call for every message.
+ * @return const char* The current local time. The text stays valid until the thread calls this again.
+ */
+const char* ClockWallString()
+{
+    uint64_t now = ClockMonotonicNanoseconds();
+
+    if(now >= wallStringExpiration)
+    {
+        uint64_t wallNanoseconds = ClockWallNanoseconds();
+        ClockFormatWallTime(wallNanoseconds, wallString, CLOCK_WALL_STRING_SIZE);
+
+        // The text stays valid until the wall clock reaches its next second.
+        wallStringExpiration = now + CLOCK_NANOSECONDS_PER_SECOND - (wallNanoseconds % CLOCK_NANOSECONDS_PER_SECOND);
+    }
+
+    return wallString;
+}
+
+/**
+ * @brief Format a wall clock time as local time, like "31-12-24 23:59:59".
+ * @param wallNanoseconds The number of nanoseconds since the epoch.
+ * @param buffer The buffer to write the text to.
+ * @param bufferSize The size of the buffer. CLOCK_WALL_STRING_SIZE is always large enough.
+ */
+void ClockFormatWallTime(const uint64_t wallNanoseconds, char* buffer, const size_t bufferSize)
+{
+    LogAssert(buffer != NULL);
+    LogAssert(bufferSize > 0);
+
+    struct tm localTime = { 0 };
+    ClockLocalTime((time_t) (wallNanoseconds / CLOCK_NANOSECONDS_PER_SECOND), &localTime);
+
+    if(strftime(buffer, bufferSize, "%d-%m-%y %H:%M:%S", &localTime) == 0)
+    {
+        buffer[0] = '\0';
+    }
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Convert a time to local time, in a thread safe way.
+ * @param seconds The number of seconds since the epoch.
+ * @param localTime The local time.
+ */
+static void ClockLocalTime(const time_t seconds, struct tm* localTime)
+{
+#ifdef _WIN32
+    localtime_s(localTime, &seconds);
+#else
+    localtime_r(&seconds, localTime);
+#endif
+}
\ No newline at end of file
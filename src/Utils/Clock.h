@@ -0,0 +1,6 @@
+#ifndef CLOCK_I
+#define CLOCK_I
+
+#include "../../include/Utils/Clock.h"
+
+#endif
\ No newline at end of file
@@ -2,11 +2,38 @@
 
 #include "Logger.h"
 
-static const uint64_t HASH_PRIME_64 = 1099511628211U; // 2^40 + 2^8 + 0xb3
-static const uint64_t HASH_OFFSET_64 = 14695981039346656037U;
+#include <string.h>
+
+// Without -mavx2, GCC and Clang still compile the AVX2 stripes into a separate function, which is only called when the CPU supports AVX2.
+#if (defined(__x86_64__) || defined(_M_X64)) && (defined(__AVX2__) || defined(__GNUC__))
+#define HASH_HAS_AVX2
+#include <immintrin.h>
+
+#ifdef __AVX2__
+#define HASH_AVX2_FUNCTION
+#else
+#define HASH_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+#endif
+
+static const uint64_t HASH_PRIME_64 = HASH_FNV1A64_PRIME; // 2^40 + 2^8 + 0xb3
+static const uint64_t HASH_OFFSET_64 = HASH_FNV1A64_OFFSET;
+
+// Odd constants with well distributed bits, used to mix the data of HashFast64.
+static const uint64_t HASH_FAST_SECRET[4] = { 0xa0761d6478bd642fU, 0xe7037ed1a0b428dbU, 0x8ebc6af09c88c6e3U, 0x589965cc75374cc3U };
+
+static const size_t HASH_FAST_STRIPE_SIZE = 32;     // The number of bytes the long key path consumes per step, 8 bytes in each of its 4 lanes.
+static const size_t HASH_FAST_LONG_KEY_SIZE = 64;   // Keys of at least this size are hashed in stripes.
+
+static uint64_t HashMix(const uint64_t a, const uint64_t b);
+static uint64_t HashReadWord(const uint8_t* data);
+static uint64_t HashFastStripes(const uint8_t* data, const size_t numStripes, const uint64_t hash);
+#ifdef HASH_HAS_AVX2
+static HASH_AVX2_FUNCTION size_t HashFastStripesAVX2(const uint8_t* data, const size_t numStripes, uint64_t lanes[4]);
+#endif
 
 /**
- * @brief Returns a 64 bit hash, computed from the given data.
+ * @brief Returns a 64 bit hash, computed from the given data. This hash is stable across builds and platforms, so use it for IDs that get stored or compared between runs. It processes 1 byte at a time, so prefer HashFast64 for hashing at runtime.
  * @param data The data to be hashed.
  * @param dataSize The memory footprint of the data.
  * @return uint64_t A semi-unique hash, computed from the given data.
@@ -27,4 +54,192 @@ uint64_t HashFNV1a64(const void* data, const size_t dataSize)
     }
 
     return hash;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Returns a 64 bit hash, computed from the given data, for hashing at runtime. Short keys are mixed 8 bytes per step. Long keys are consumed in 32 byte stripes by 4 independent lanes, which the compiler or AVX2 runs in parallel. The result is the same with and without AVX2, but isn't meant to be stored.
+ * @param data The data to be hashed.
+ * @param dataSize The memory footprint of the data.
+ * @return uint64_t A semi-unique hash, computed from the given data.
+ */
+uint64_t HashFast64(const void* data, const size_t dataSize)
+{
+    LogAssert(data != NULL);
+
+    const uint8_t* dataBytes = (const uint8_t*) data;
+    size_t numBytesLeft = dataSize;
+
+    uint64_t hash = HASH_FAST_SECRET[0] ^ (dataSize * HASH_FAST_SECRET[1]);
+
+    if(numBytesLeft >= HASH_FAST_LONG_KEY_SIZE)
+    {
+        size_t numStripes = numBytesLeft / HASH_FAST_STRIPE_SIZE;
+
+        hash = HashFastStripes(dataBytes, numStripes, hash);
+        dataBytes += numStripes * HASH_FAST_STRIPE_SIZE;
+        numBytesLeft -= numStripes * HASH_FAST_STRIPE_SIZE;
+    }
+
+    for(; numBytesLeft >= 16; numBytesLeft -= 16, dataBytes += 16)
+    {
+        hash = HashMix(HashReadWord(dataBytes) ^ HASH_FAST_SECRET[1], HashReadWord(dataBytes + 8) ^ hash);
+    }
+
+    if(numBytesLeft >= 8)
+    {
+        hash = HashMix(HashReadWord(dataBytes) ^ HASH_FAST_SECRET[2], hash);
+        dataBytes += 8;
+        numBytesLeft -= 8;
+    }
+
+    if(numBytesLeft > 0)
+    {
+        uint64_t lastWord = 0;
+        memcpy(&lastWord, dataBytes, numBytesLeft);
+        hash = HashMix(lastWord ^ HASH_FAST_SECRET[3], hash);
+    }
+
+    return HashU64(hash);
+}
+
+/**
+ * @brief Returns a 64 bit hash of an integer key, for dictionaries whose keys are integers or handles. Matches the HashFunction signature.
+ * @param data A pointer to the integer to be hashed.
+ * @param dataSize The memory footprint of the integer. This has to be 1, 2, 4 or 8 bytes.
+ * @return uint64_t A semi-unique hash, computed from the given integer.
+ */
+uint64_t HashInteger(const void* data, const size_t dataSize)
+{
+    LogAssert(data != NULL);
+    LogAssert(dataSize == 1 || dataSize == 2 || dataSize == 4 || dataSize == 8);
+
+    uint64_t key = 0;
+    memcpy(&key, data, dataSize);
+
+    return HashU64(key);
+}
+
+/**
+ * @brief Returns a 64 bit hash of a 64 bit integer. Every bit of the key affects every bit of the hash, so keys that only differ in their high bits still end up in different slots of a hash table.
+ * @param key The integer to be hashed.
+ * @return uint64_t A semi-unique hash, computed from the given integer.
+ */
+uint64_t HashU64(const uint64_t key)
+{
+    uint64_t hash = key;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdU;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53U;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/* ---------------------------------------------------- INTERNALS --------------------------------------------------- */
+
+/**
+ * @brief Check wether HashFast64 consumes the stripes of long keys with AVX2. This needs a CPU with AVX2.
+ * @return bool Wether or not the 4 lanes are updated in a single vector.
+ */
+bool HashFastIsVectorized()
+{
+#ifdef HASH_HAS_AVX2
+#ifdef __AVX2__
+    return true;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+#else
+    return false;
+#endif
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Multiply 2 64 bit integers into a 128 bit product, and fold its halves together. This mixes every bit of both inputs in a single multiplication.
+ * @param a The first integer.
+ * @param b The second integer.
+ * @return uint64_t The low and high half of the product, xor'ed together.
+ */
+static uint64_t HashMix(const uint64_t a, const uint64_t b)
+{
+    __uint128_t product = (__uint128_t) a * b;
+    return (uint64_t) product ^ (uint64_t) (product >> 64);
+}
+
+/**
+ * @brief Read 8 bytes of possibly unaligned data as a 64 bit integer.
+ * @param data The data to read.
+ * @return uint64_t The 8 bytes, as an integer.
+ */
+static uint64_t HashReadWord(const uint8_t* data)
+{
+    uint64_t word;
+    memcpy(&word, data, sizeof(uint64_t));
+    return word;
+}
+
+/**
+ * @brief Consume whole 32 byte stripes of data in 4 independent lanes, and fold the lanes into a hash. Every lane multiplies the low and high 32 bits of its keyed word, which AVX2 can do for all 4 lanes in a single instruction.
+ * @param data The data to consume.
+ * @param numStripes The number of 32 byte stripes to consume.
+ * @param hash The hash so far.
+ * @return uint64_t The hash, including the consumed stripes.
+ */
+static uint64_t HashFastStripes(const uint8_t* data, const size_t numStripes, const uint64_t hash)
+{
+    uint64_t lanes[4] = { hash, HASH_FAST_SECRET[1], HASH_FAST_SECRET[2], HASH_FAST_SECRET[3] };
+    size_t s = 0;
+
+#ifdef HASH_HAS_AVX2
+    if(HashFastIsVectorized())
+    {
+        s = HashFastStripesAVX2(data, numStripes, lanes);
+    }
+#endif
+
+    for(; s < numStripes; ++s)
+    {
+        for(int l = 0; l < 4; ++l)
+        {
+            uint64_t word = HashReadWord(data + s * HASH_FAST_STRIPE_SIZE + l * sizeof(uint64_t));
+            uint64_t keyedWord = word ^ HASH_FAST_SECRET[l];
+
+            lanes[l] += (keyedWord & 0xffffffff) * (keyedWord >> 32) + word;
+        }
+    }
+
+    return HashMix(lanes[0] ^ HASH_FAST_SECRET[0], lanes[1]) ^ HashMix(lanes[2] ^ HASH_FAST_SECRET[2], lanes[3]);
+}
+
+#ifdef HASH_HAS_AVX2
+/**
+ * @brief The AVX2 part of HashFastStripes, updating all 4 lanes with a single vector. Only call this when HashFastIsVectorized.
+ * @param data The data to consume.
+ * @param numStripes The number of 32 byte stripes to consume.
+ * @param lanes The 4 lanes, which get updated with the consumed stripes.
+ * @return size_t The number of stripes consumed. The rest is left to the scalar loop.
+ */
+static HASH_AVX2_FUNCTION size_t HashFastStripesAVX2(const uint8_t* data, const size_t numStripes, uint64_t lanes[4])
+{
+    __m256i laneVector = _mm256_loadu_si256((const __m256i*) lanes);
+    const __m256i secretVector = _mm256_loadu_si256((const __m256i*) HASH_FAST_SECRET);
+
+    size_t s = 0;
+
+    for(; s < numStripes; ++s)
+    {
+        __m256i dataVector = _mm256_loadu_si256((const __m256i*) (data + s * HASH_FAST_STRIPE_SIZE));
+        __m256i keyedVector = _mm256_xor_si256(dataVector, secretVector);
+        __m256i productVector = _mm256_mul_epu32(keyedVector, _mm256_srli_epi64(keyedVector, 32));
+
+        laneVector = _mm256_add_epi64(laneVector, _mm256_add_epi64(productVector, dataVector));
+    }
+
+    _mm256_storeu_si256((__m256i*) lanes, laneVector);
+    return s;
+}
+#endif
\ No newline at end of file
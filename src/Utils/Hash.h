@@ -3,4 +3,8 @@
 
 #include "../../include/Utils/Hash.h"
 
+#include <stdbool.h>
+
+bool HashFastIsVectorized();
+
 #endif
\ No newline at end of file
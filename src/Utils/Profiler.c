@@ -0,0 +1,316 @@
+#include "Profiler.h"
+
+#include "Allocator.h"
+#include "Clock.h"
+#include "Thread.h"
+#include "Logger.h"
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+static const uint32_t PROFILER_DEFAULT_ZONES_PER_THREAD = 64 * 1024;
+
+/**
+ * @brief A zone that ended, waiting to be exported.
+ */
+typedef struct ProfilerZoneRecord
+{
+    const char* name;
+    uint64_t id;
+    uint64_t startTicks;
+    uint64_t endTicks;
+    uint64_t numEntities;
+} ProfilerZoneRecord;
+
+/**
+ * @brief The zones recorded by a single thread. Only the owning thread adds zones, so recording never takes a lock. The buffer never grows, so the zones can be exported while the thread keeps recording.
+ */
+typedef struct ProfilerBuffer
+{
+    atomic_uint_fast32_t numZones;      // Only written by the owning thread.
+    atomic_uint_fast64_t numDropped;    // Only written by the owning thread.
+    uint32_t capacity;
+    uint32_t threadID;
+    struct ProfilerBuffer* next;
+    ProfilerZoneRecord zones[];
+} ProfilerBuffer;
+
+/**
+ * @brief The state shared by all profiled threads.
+ */
+typedef struct Profiler
+{
+    _Atomic(ProfilerBuffer*) buffers;   // Every buffer handed out since the last reset, pushed to the front.
+    atomic_bool isRunning;
+    atomic_uint_fast64_t generation;    // Increased every reset, so threads know their buffer was freed.
+    uint32_t zonesPerThread;
+    uint64_t startTicks;                // The ticks the profiler started at, which is time 0 of the exported trace.
+} Profiler;
+
+static Profiler profiler = { 0 };
+
+static THREAD_LOCAL ProfilerBuffer* threadBuffer = NULL;
+static THREAD_LOCAL uint64_t threadBufferGeneration = 0;
+
+static ProfilerBuffer* ProfilerGetThreadBuffer();
+static void ProfilerWriteJSONString(FILE* file, const char* string);
+
+/**
+ * @brief Start recording zones, throwing away the ones recorded before. Every thread gets its own buffer of zones the first time it ends a zone.
+ * Other threads must not be ending zones while the profiler starts, since their buffers get freed.
+ * @param zonesPerThread The number of zones every thread can record. Zones ending after a thread's buffer is full are dropped. 0 for the default of 65536.
+ * @return bool Wether or not the profiler was started. It fails when it's already running.
+ */
+bool ProfilerStart(const uint32_t zonesPerThread)
+{
+    if(atomic_load(&(profiler.isRunning)))
+    {
+        return false;
+    }
+
+    ProfilerReset();
+
+    // Calibrate now, so the wait doesn't end up in the first exported zone.
+    ClockCalibrate();
+
+    profiler.zonesPerThread = zonesPerThread > 0 ? zonesPerThread : PROFILER_DEFAULT_ZONES_PER_THREAD;
+    profiler.startTicks = ClockTicks();
+
+    atomic_store(&(profiler.isRunning), true);
+    return true;
+}
+
+/**
+ * @brief Stop recording zones. The recorded zones are kept until the profiler is reset or started again, so they can still be exported.
+ */
+void ProfilerStop()
+{
+    atomic_store(&(profiler.isRunning), false);
+}
+
+/**
+ * @brief Check wether the profiler is running.
+ * @return bool Wether or not zones are currently recorded.
+ */
+bool ProfilerIsRunning()
+{
+    return atomic_load_explicit(&(profiler.isRunning), memory_order_relaxed);
+}
+
+/**
+ * @brief Free all recorded zones. Other threads must not be ending zones while the profiler resets.
+ */
+void ProfilerReset()
+{
+    atomic_fetch_add(&(profiler.generation), 1);
+
+    ProfilerBuffer* buffer = atomic_exchange(&(profiler.buffers), NULL);
+
+    while(buffer != NULL)
+    {
+        ProfilerBuffer* nextBuffer = buffer->next;
+        AllocatorFree(NULL, buffer, sizeof(ProfilerBuffer) + buffer->capacity * sizeof(ProfilerZoneRecord));
+        buffer = nextBuffer;
+    }
+}
+
+/**
+ * @brief Get the number of zones recorded since the profiler started.
+ * @return uint64_t The number of recorded zones, over all threads.
+ */
+uint64_t ProfilerNumZones()
+{
+    uint64_t numZones = 0;
+
+    for(ProfilerBuffer* buffer = atomic_load(&(profiler.buffers)); buffer != NULL; buffer = buffer->next)
+    {
+        numZones += atomic_load_explicit(&(buffer->numZones), memory_order_relaxed);
+    }
+
+    return numZones;
+}
+
+/**
+ * @brief Get the number of zones dropped because a thread's buffer was full, since the profiler started.
+ * @return uint64_t The number of dropped zones, over all threads.
+ */
+uint64_t ProfilerNumDropped()
+{
+    uint64_t numDropped = 0;
+
+    for(ProfilerBuffer* buffer = atomic_load(&(profiler.buffers)); buffer != NULL; buffer = buffer->next)
+    {
+        numDropped += atomic_load_explicit(&(buffer->numDropped), memory_order_relaxed);
+    }
+
+    return numDropped;
+}
+
+/**
+ * @brief Write the recorded zones as a Chrome trace event file, which can be opened in Perfetto or chrome://tracing. Every zone becomes a complete event on the track of the thread that recorded it, with the number of entities it updated as argument.
+ * This can be done while the profiler is running. Zones ending during the export might not be included.
+ * @param filePath The path of the file to write. An existing file is overwritten.
+ * @return bool Wether or not the file was written.
+ */
+bool ProfilerExportChromeTrace(const char* filePath)
+{
+    LogAssert(filePath);
+
+    FILE* file = fopen(filePath, "w");
+
+    if(file == NULL)
+    {
+        return false;
+    }
+
+    fputs("{\"traceEvents\":[", file);
+
+    bool isFirstEvent = true;
+
+    for(ProfilerBuffer* buffer = atomic_load(&(profiler.buffers)); buffer != NULL; buffer = buffer->next)
+    {
+        uint32_t numZones = atomic_load_explicit(&(buffer->numZones), memory_order_acquire);
+
+        for(uint32_t z = 0; z < numZones; ++z)
+        {
+            const ProfilerZoneRecord* zone = buffer->zones + z;
+
+            fputs(isFirstEvent ? "\n{\"name\":\"" : ",\n{\"name\":\"", file);
+            ProfilerWriteJSONString(file, zone->name);
+
+            if(zone->id != 0)
+            {
+                fprintf(file, " %016llx", (unsigned long long) zone->id);
+            }
+
+            // Chrome traces count in microseconds, but take fractions, so the nanoseconds aren't lost.
+            double startMicroseconds = ClockTicksToNanoseconds(zone->startTicks - profiler.startTicks) / 1000.0;
+            double durationMicroseconds = ClockTicksToNanoseconds(zone->endTicks - zone->startTicks) / 1000.0;
+
+            fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"entities\":%llu}}", buffer->threadID, startMicroseconds, durationMicroseconds, (unsigned long long) zone->numEntities);
+            isFirstEvent = false;
+        }
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", file);
+
+    bool isWritten = !ferror(file);
+    return fclose(file) == 0 && isWritten;
+}
+
+/**
+ * @brief Begin timing a zone. Use PROFILE_ZONE_BEGIN instead, so the zone compiles out when PROFILE is not defined.
+ * @param name The name of the zone. This has to stay valid until the zones are exported, like a string literal.
+ * @param id An ID shown after the name, to tell zones of the same name apart. 0 to show only the name.
+ * @return ProfilerZone The zone, to end with ProfilerZoneEnd.
+ */
+ProfilerZone ProfilerZoneBegin(const char* name, const uint64_t id)
+{
+    ProfilerZone zone = { name, id, 0 };
+
+    if(atomic_load_explicit(&(profiler.isRunning), memory_order_relaxed))
+    {
+        zone.startTicks = ClockTicks();
+    }
+
+    return zone;
+}
+
+/**
+ * @brief End timing a zone, and record it in the buffer of the calling thread. Zones are not recorded when the profiler did not run during the whole zone. Use PROFILE_ZONE_END instead, so the zone compiles out when PROFILE is not defined.
+ * @param zone The zone to end, as begun with ProfilerZoneBegin.
+ * @param numEntities The number of entities updated in the zone.
+ */
+void ProfilerZoneEnd(const ProfilerZone* zone, const uint64_t numEntities)
+{
+    if(zone->startTicks == 0 || !atomic_load_explicit(&(profiler.isRunning), memory_order_acquire) || zone->startTicks < profiler.startTicks)
+    {
+        return;
+    }
+
+    uint64_t endTicks = ClockTicks();
+    ProfilerBuffer* buffer = ProfilerGetThreadBuffer();
+
+    if(buffer == NULL)
+    {
+        return;
+    }
+
+    uint32_t numZones = atomic_load_explicit(&(buffer->numZones), memory_order_relaxed);
+
+    if(numZones == buffer->capacity)
+    {
+        atomic_store_explicit(&(buffer->numDropped), atomic_load_explicit(&(buffer->numDropped), memory_order_relaxed) + 1, memory_order_relaxed);
+        return;
+    }
+
+    ProfilerZoneRecord* record = buffer->zones + numZones;
+    record->name = zone->name;
+    record->id = zone->id;
+    record->startTicks = zone->startTicks;
+    record->endTicks = endTicks;
+    record->numEntities = numEntities;
+
+    atomic_store_explicit(&(buffer->numZones), numZones + 1, memory_order_release);
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief Get the buffer of the calling thread, creating it on the first zone the thread ends since the last reset.
+ * @return ProfilerBuffer* The buffer of the calling thread. NULL if it could not be allocated.
+ */
+static ProfilerBuffer* ProfilerGetThreadBuffer()
+{
+    uint64_t generation = atomic_load_explicit(&(profiler.generation), memory_order_relaxed);
+
+    if(threadBuffer != NULL && threadBufferGeneration == generation)
+    {
+        return threadBuffer;
+    }
+
+    ProfilerBuffer* newBuffer = AllocatorAlloc(NULL, sizeof(ProfilerBuffer) + profiler.zonesPerThread * sizeof(ProfilerZoneRecord));
+
+    if(newBuffer == NULL)
+    {
+        return NULL;
+    }
+
+    atomic_init(&(newBuffer->numZones), 0);
+    atomic_init(&(newBuffer->numDropped), 0);
+    newBuffer->capacity = profiler.zonesPerThread;
+    newBuffer->threadID = ThreadGetID();
+
+    newBuffer->next = atomic_load_explicit(&(profiler.buffers), memory_order_relaxed);
+    while(!atomic_compare_exchange_weak_explicit(&(profiler.buffers), &(newBuffer->next), newBuffer, memory_order_release, memory_order_relaxed));
+
+    threadBuffer = newBuffer;
+    threadBufferGeneration = generation;
+    return newBuffer;
+}
+
+/**
+ * @brief Write a string to a JSON file, escaping the characters JSON doesn't allow in strings.
+ * @param file The file to write to.
+ * @param string The string to write, without quotes.
+ */
+static void ProfilerWriteJSONString(FILE* file, const char* string)
+{
+    for(const char* c = string; *c != '\0'; ++c)
+    {
+        if(*c == '"' || *c == '\\')
+        {
+            fputc('\\', file);
+            fputc(*c, file);
+        }
+        else if((unsigned char) *c < 0x20)
+        {
+            fprintf(file, "\\u%04x", (unsigned int) *c);
+        }
+        else
+        {
+            fputc(*c, file);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef PROFILER_I
+#define PROFILER_I
+
+#include "../../include/Utils/Profiler.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "Thread.h"
+
+#include "Logger.h"
+
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+/**
+ * @brief A thread of execution, running a single function.
+ */
+struct Thread
+{
+    ThreadFunction function;
+    void* argument;
+#ifdef _WIN32
+    HANDLE handle;
+#else
+    pthread_t handle;
+#endif
+};
+
+static atomic_uint_fast32_t nextThreadID = 1;
+static THREAD_LOCAL uint32_t threadID = 0;
+
+#ifdef _WIN32
+static DWORD WINAPI ThreadStart(LPVOID thread);
+#else
+static void* ThreadStart(void* thread);
+#endif
+
+/**
+ * @brief Create a new thread, and start running a function on it.
+ * @param function The function to run on the thread.
+ * @param argument The argument to pass to the function.
+ * @return Thread* A pointer to the newly created thread. NULL if the thread could not be started.
+ */
+Thread* ThreadNew(ThreadFunction function, void* argument)
+{
+    LogAssert(function != NULL);
+
+    Thread* newThread = malloc(sizeof(Thread));
+    LogAssert(newThread != NULL);
+
+    newThread->function = function;
+    newThread->argument = argument;
+
+#ifdef _WIN32
+    newThread->handle = CreateThread(NULL, 0, ThreadStart, newThread, 0, NULL);
+    bool isStarted = newThread->handle != NULL;
+#else
+    bool isStarted = pthread_create(&(newThread->handle), NULL, ThreadStart, newThread) == 0;
+#endif
+
+    if(!isStarted)
+    {
+        free(newThread);
+        return NULL;
+    }
+
+    return newThread;
+}
+
+/**
+ * @brief Wait for a thread to finish running its function, and free it.
+ * @param thread The thread to wait for.
+ */
+void ThreadJoin(Thread* thread)
+{
+    LogAssert(thread != NULL);
+
+#ifdef _WIN32
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+
+    free(thread);
+}
+
+/**
+ * @brief Suspend the calling thread.
+ * @param milliseconds The minimum amount of time to suspend the thread for, in milliseconds.
+ */
+void ThreadSleep(const uint32_t milliseconds)
+{
+#ifdef _WIN32
+    Sleep(milliseconds);
+#else
+    struct timespec duration = { milliseconds / 1000, (long) (milliseconds % 1000) * 1000000 };
+    nanosleep(&duration, NULL);
+#endif
+}
+
+/**
+ * @brief Give up the rest of the calling thread's time slice, so other threads can run.
+ */
+void ThreadYield()
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/**
+ * @brief Get a small number identifying the calling thread. Thread IDs are handed out in the order threads first ask for them, starting at 1, and are never reused.
+ * @return uint32_t The ID of the calling thread.
+ */
+uint32_t ThreadGetID()
+{
+    if(threadID == 0)
+    {
+        threadID = atomic_fetch_add_explicit(&nextThreadID, 1, memory_order_relaxed);
+    }
+
+    return threadID;
+}
+
+/* ----------------------------------------------------- STATICS ---------------------------------------------------- */
+
+/**
+ * @brief The entry point of every thread, which runs the thread's function.
+ * @param thread The thread being started.
+ */
+#ifdef _WIN32
+static DWORD WINAPI ThreadStart(LPVOID thread)
+#else
+static void* ThreadStart(void* thread)
+#endif
+{
+    Thread* startedThread = thread;
+    startedThread->function(startedThread->argument);
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
\ No newline at end of file
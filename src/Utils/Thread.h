@@ -0,0 +1,12 @@
+#ifndef THREAD_I
+#define THREAD_I
+
+#include "../../include/Utils/Thread.h"
+
+#if defined(_MSC_VER)
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL _Thread_local
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "VirtualMemory.h"
+
+#include "Logger.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Get the size of a page of virtual memory. Reserving, committing and releasing memory happens at this granularity.
+ * @return size_t The page size in bytes.
+ */
+size_t VirtualMemoryPageSize()
+{
+    static size_t pageSize = 0;
+
+    if(pageSize == 0)
+    {
+#ifdef _WIN32
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        pageSize = systemInfo.dwPageSize;
+#else
+        pageSize = sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    return pageSize;
+}
+
+/**
+ * @brief Round a size up to a multiple of the page size.
+ * @param size The size to round up, in bytes.
+ * @return size_t The rounded size in bytes.
+ */
+size_t VirtualMemoryRoundToPageSize(const size_t size)
+{
+    size_t pageSize = VirtualMemoryPageSize();
+    return ((size + pageSize - 1) / pageSize) * pageSize;
+}
+
+/**
+ * @brief Reserve a range of address space, without backing it with memory. The range has to be committed before it can be accessed.
+ * @param size The size of the range in bytes. This gets rounded up to the page size.
+ * @return void* The start of the reserved range. NULL if the address space could not be reserved.
+ */
+void* VirtualMemoryReserve(const size_t size)
+{
+    LogAssert(size > 0);
+
+#ifdef _WIN32
+    return VirtualAlloc(NULL, VirtualMemoryRoundToPageSize(size), MEM_RESERVE, PAGE_NOACCESS);
+#else
+    void* address = mmap(NULL, VirtualMemoryRoundToPageSize(size), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return address == MAP_FAILED ? NULL : address;
+#endif
+}
+
+/**
+ * @brief Make part of a reserved range accessible. Newly committed memory reads as zero. Committing an already committed page leaves its contents untouched.
+ * @param address The page aligned start of the range to commit.
+ * @param size The size of the range in bytes. This gets rounded up to the page size.
+ * @return bool Wether or not the range was committed successfully.
+ */
+bool VirtualMemoryCommit(void* address, const size_t size)
+{
+    LogAssert(address != NULL);
+
+    if(size == 0)
+    {
+        return true;
+    }
+
+#ifdef _WIN32
+    return VirtualAlloc(address, VirtualMemoryRoundToPageSize(size), MEM_COMMIT, PAGE_READWRITE) != NULL;
+#else
+    return mprotect(address, VirtualMemoryRoundToPageSize(size), PROT_READ | PROT_WRITE) == 0;
+#endif
+}
+
+/**
+ * @brief Return the memory behind part of a reserved range to the OS, while keeping the address space reserved.
+ * @param address The page aligned start of the range to decommit.
+ * @param size The size of the range in bytes. This gets rounded up to the page size.
+ */
+void VirtualMemoryDecommit(void* address, const size_t size)
+{
+    LogAssert(address != NULL);
+
+    if(size == 0)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    VirtualFree(address, VirtualMemoryRoundToPageSize(size), MEM_DECOMMIT);
+#else
+    madvise(address, VirtualMemoryRoundToPageSize(size), MADV_DONTNEED);
+    mprotect(address, VirtualMemoryRoundToPageSize(size), PROT_NONE);
+#endif
+}
+
+/**
+ * @brief Release a reserved range, including all memory committed in it.
+ * @param address The start of the range, as returned by VirtualMemoryReserve.
+ * @param size The size the range was reserved with.
+ */
+void VirtualMemoryRelease(void* address, const size_t size)
+{
+    LogAssert(address != NULL);
+
+#ifdef _WIN32
+    VirtualFree(address, 0, MEM_RELEASE);
+#else
+    munmap(address, VirtualMemoryRoundToPageSize(size));
+#endif
+}
+
+/**
+ * @brief Hint the OS to back a range with transparent huge pages, which reduces TLB misses when streaming over large component columns. This is a no-op where unsupported.
+ * @param address The page aligned start of the range.
+ * @param size The size of the range in bytes.
+ */
+void VirtualMemoryAdviseHugePages(void* address, const size_t size)
+{
+    LogAssert(address != NULL);
+
+#ifdef MADV_HUGEPAGE
+    madvise(address, VirtualMemoryRoundToPageSize(size), MADV_HUGEPAGE);
+#endif
+}
+
+/**
+ * @brief Map a file into memory, so writing to the memory writes to the file. The file gets created if it doesn't exist, and resized to the mapped size. Its contents are kept otherwise.
+ * The written memory ends up in the file even when the process crashes or gets killed, since the OS owns the pages, and writes them back on its own.
+ * @param filePath The file to map.
+ * @param size The number of bytes to map. This gets rounded up to the page size.
+ * @return void* The start of the mapped file. NULL if the file could not be opened or mapped.
+ */
+void* VirtualMemoryMapFile(const char* filePath, const size_t size)
+{
+    LogAssert(filePath != NULL);
+    LogAssert(size > 0);
+
+    size_t mappedSize = VirtualMemoryRoundToPageSize(size);
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if(file == INVALID_HANDLE_VALUE)
+    {
+        return NULL;
+    }
+
+    LARGE_INTEGER fileSize;
+    fileSize.QuadPart = mappedSize;
+    bool isResized = SetFilePointerEx(file, fileSize, NULL, FILE_BEGIN) && SetEndOfFile(file);
+
+    HANDLE mapping = isResized ? CreateFileMappingA(file, NULL, PAGE_READWRITE, 0, 0, NULL) : NULL;
+    void* address = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, mappedSize) : NULL;
+
+    // The view keeps the mapping and the file open by itself.
+    if(mapping != NULL)
+    {
+        CloseHandle(mapping);
+    }
+
+    CloseHandle(file);
+    return address;
+#else
+    int file = open(filePath, O_RDWR | O_CREAT, 0644);
+
+    if(file < 0)
+    {
+        return NULL;
+    }
+
+    void* address = ftruncate(file, mappedSize) == 0 ? mmap(NULL, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0) : MAP_FAILED;
+
+    // The mapping keeps the file open by itself.
+    close(file);
+    return address == MAP_FAILED ? NULL : address;
+#endif
+}
+
+/**
+ * @brief Unmap a file mapped with VirtualMemoryMapFile.
+ * @param address The start of the mapped file.
+ * @param size The size the file was mapped with.
+ */
+void VirtualMemoryUnmapFile(void* address, const size_t size)
+{
+    LogAssert(address != NULL);
+
+#ifdef _WIN32
+    UnmapViewOfFile(address);
+#else
+    munmap(address, VirtualMemoryRoundToPageSize(size));
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,6 @@
+#ifndef VIRTUAL_MEMORY_I
+#define VIRTUAL_MEMORY_I
+
+#include "../../include/Utils/VirtualMemory.h"
+
+#endif
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "Containers/Array.h"
+
+DECLARE_ARRAY(double)
+
+void TestArrayAdd()
+{
+    Array* array = ArrayNew(sizeof(int));
+    TEST_CHECK(array != NULL);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        ArrayAdd(array, &i);
+    }
+
+    TEST_CHECK(ArrayNum(array) == 100);
+    TEST_CHECK(ArrayCapacity(array) >= 100);
+    TEST_CHECK(*(int*) ArrayGet(array, 42) == 42);
+
+    int poppedNr;
+    ArrayPopBack(array, &poppedNr);
+    TEST_CHECK(poppedNr == 99);
+    TEST_CHECK(ArrayNum(array) == 99);
+
+    ArrayFree(array);
+}
+
+void TestArrayRange()
+{
+    Array* array = ArrayNew(sizeof(int));
+    int numbers[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    ArrayReserve(array, 50);
+    TEST_CHECK(ArrayCapacity(array) >= 50);
+    TEST_CHECK(ArrayNum(array) == 0);
+
+    ArrayAppend(array, numbers, 10);
+    ArrayAppend(array, numbers, 10);
+    TEST_CHECK(ArrayNum(array) == 20);
+    TEST_CHECK(*(int*) ArrayGet(array, 13) == 3);
+
+    int insertedNumbers[3] = { 100, 101, 102 };
+    ArrayInsert(array, 5, insertedNumbers, 3);
+    TEST_CHECK(ArrayNum(array) == 23);
+    TEST_CHECK(*(int*) ArrayGet(array, 4) == 4);
+    TEST_CHECK(*(int*) ArrayGet(array, 5) == 100);
+    TEST_CHECK(*(int*) ArrayGet(array, 7) == 102);
+    TEST_CHECK(*(int*) ArrayGet(array, 8) == 5);
+
+    ArrayErase(array, 5, 3);
+    TEST_CHECK(ArrayNum(array) == 20);
+    TEST_CHECK(*(int*) ArrayGet(array, 5) == 5);
+    TEST_CHECK(*(int*) ArrayGet(array, 19) == 9);
+
+    int removedNumber;
+    ArraySwapRemove(array, 2, &removedNumber);
+    TEST_CHECK(removedNumber == 2);
+    TEST_CHECK(ArrayNum(array) == 19);
+    TEST_CHECK(*(int*) ArrayGet(array, 2) == 9);
+
+    ArrayFree(array);
+}
+
+void TestArrayReserved()
+{
+    Array* array = ArrayNewReserved(sizeof(int), 1 << 20, false);
+    TEST_CHECK(ArrayCapacity(array) == 0);
+
+    int newNr = 0;
+    ArrayAdd(array, &newNr);
+    int* firstElement = ArrayGet(array, 0);
+
+    for(newNr = 1; newNr < 100000; ++newNr)
+    {
+        ArrayAdd(array, &newNr);
+    }
+
+    TEST_CHECK(ArrayNum(array) == 100000);
+    TEST_CHECK(ArrayGet(array, 0) == firstElement);
+
+    bool allElementsCorrect = true;
+    for(int i = 0; i < 100000; ++i)
+    {
+        int* element = ArrayGet(array, i);
+        allElementsCorrect &= (element == firstElement + i && *element == i);
+    }
+    TEST_CHECK(allElementsCorrect);
+
+    TEST_CHECK(ArrayResize(array, 10));
+    TEST_CHECK(ArrayNum(array) == 10);
+    TEST_CHECK(ArrayCapacity(array) == 10);
+    TEST_CHECK(*(int*) ArrayGet(array, 9) == 9);
+
+    TEST_CHECK(ArrayResize(array, 1 << 20));
+    TEST_CHECK(ArrayGet(array, 0) == firstElement);
+    TEST_CHECK(*(int*) ArrayGet(array, 9) == 9);
+
+    ArrayFree(array);
+}
+
+void TestArrayAligned()
+{
+    Array* array = ArrayNewAligned(sizeof(float), 64, NULL);
+    TEST_CHECK(((uintptr_t) ArrayAdd(array, &(float){ 1.0f }) % 64) == 0);
+
+    for(int i = 1; i < 1000; ++i)
+    {
+        float newNr = i;
+        ArrayAdd(array, &newNr);
+    }
+
+    TEST_CHECK(((uintptr_t) ArrayGet(array, 0) % 64) == 0);
+    TEST_CHECK(*(float*) ArrayGet(array, 999) == 999.0f);
+
+    ArrayFree(array);
+}
+
+void TestArrayTyped()
+{
+    doubleArray array;
+    doubleArrayInit(&array, 1, NULL);
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        doubleArrayAdd(&array, i * 0.5);
+    }
+
+    TEST_CHECK(doubleArrayNum(&array) == 1000);
+    TEST_CHECK(*doubleArrayGet(&array, 10) == 5.0);
+    TEST_CHECK(doubleArrayData(&array)[999] == 499.5);
+    TEST_CHECK(*(double*) ArrayGet(&(array.base), 20) == 10.0);
+    TEST_CHECK(doubleArrayPopBack(&array) == 499.5);
+    TEST_CHECK(doubleArrayNum(&array) == 999);
+
+    doubleArrayDeinit(&array);
+}
+
+void TestArray()
+{
+    TestArrayAdd();
+    TestArrayRange();
+    TestArrayReserved();
+    TestArrayAligned();
+    TestArrayTyped();
+}
\ No newline at end of file
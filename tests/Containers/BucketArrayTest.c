@@ -1,5 +1,7 @@
 #include "Containers/BucketArray.h"
 
+DECLARE_BUCKET_ARRAY(int)
+
 void TestBucketArrayAdd()
 {
     BucketArray* bucketArray = BucketArrayNew(sizeof(char*), 1);
@@ -22,6 +24,42 @@ void TestBucketArrayAdd()
     TEST_CHECK_(strcmp(returnValue, testString) == 0, "%s, %s = %d", returnValue, "Hello world", strcmp(returnValue, "Hello world"));
 }
 
+void TestBucketArrayRange(BucketArray* bucketArray)
+{
+    int numbers[100];
+    for(int i = 0; i < 100; ++i)
+    {
+        numbers[i] = i;
+    }
+
+    TEST_CHECK(BucketArrayReserve(bucketArray, 150));
+    TEST_CHECK(BucketArrayCapacity(bucketArray) >= 150);
+    TEST_CHECK(BucketArrayNum(bucketArray) == 0);
+
+    BucketArrayAppend(bucketArray, numbers, 3);
+    BucketArrayAppend(bucketArray, numbers, 100);
+    TEST_CHECK(BucketArrayNum(bucketArray) == 103);
+
+    bool allElementsCorrect = (*(int*) BucketArrayGet(bucketArray, 2) == 2);
+    for(int i = 0; i < 100; ++i)
+    {
+        allElementsCorrect &= (*(int*) BucketArrayGet(bucketArray, i + 3) == i);
+    }
+    TEST_CHECK(allElementsCorrect);
+
+    int removedNumber;
+    BucketArraySwapRemove(bucketArray, 1, &removedNumber);
+    TEST_CHECK(removedNumber == 1);
+    TEST_CHECK(BucketArrayNum(bucketArray) == 102);
+    TEST_CHECK(*(int*) BucketArrayGet(bucketArray, 1) == 99);
+
+    BucketArraySwapRemove(bucketArray, 101, NULL);
+    TEST_CHECK(BucketArrayNum(bucketArray) == 101);
+    TEST_CHECK(*(int*) BucketArrayGet(bucketArray, 100) == 97);
+
+    BucketArrayFree(bucketArray);
+}
+
 void TestBucketArrayResize()
 {
     BucketArray* bucketArray = BucketArrayNew(sizeof(int), 5);
@@ -83,9 +121,206 @@ void TestBucketArrayClear()
 
 }
 
+void TestBucketArrayGeometric()
+{
+    BucketArray* bucketArray = BucketArrayNewGeometric(sizeof(int), 3);
+    TEST_CHECK(BucketArrayBucketCapacity(bucketArray) == 4);
+    TEST_CHECK(bucketArray->bucketPtrs.num == 1);
+
+    int newNr = 0;
+    BucketArrayAdd(bucketArray, &newNr);
+    int* firstElement = BucketArrayGet(bucketArray, 0);
+
+    for(newNr = 1; newNr < 1000; ++newNr)
+    {
+        BucketArrayAdd(bucketArray, &newNr);
+    }
+
+    // 4 + 8 + 16 + 32 + 64 + 128 + 256 + 512 >= 1000
+    TEST_CHECK(bucketArray->num == 1000);
+    TEST_CHECK(bucketArray->bucketPtrs.num == 8);
+    TEST_CHECK(BucketArrayCapacity(bucketArray) == 1020);
+    TEST_CHECK(BucketArrayGet(bucketArray, 0) == firstElement);
+
+    bool allElementsCorrect = true;
+    for(int i = 0; i < 1000; ++i)
+    {
+        allElementsCorrect &= (*(int*) BucketArrayGet(bucketArray, i) == i);
+    }
+    TEST_CHECK(allElementsCorrect);
+
+    // The last bucket starts at 4 * (2^7 - 1) = 508.
+    while(bucketArray->num > 508)
+    {
+        BucketArrayPopBack(bucketArray, NULL);
+    }
+    TEST_CHECK(bucketArray->bucketPtrs.num == 7);
+
+    BucketArrayResize(bucketArray, 12);
+    TEST_CHECK(bucketArray->num == 12);
+    TEST_CHECK(bucketArray->bucketPtrs.num == 2);
+    TEST_CHECK(*(int*) BucketArrayGet(bucketArray, 11) == 11);
+
+    BucketArrayFree(bucketArray);
+}
+
+void TestBucketArrayReserved()
+{
+    BucketArray* bucketArray = BucketArrayNewReserved(sizeof(int), 1 << 20, false);
+    TEST_CHECK(bucketArray->bucketPtrs.num == 1);
+    TEST_CHECK(BucketArrayCapacity(bucketArray) == 0);
+
+    int newNr = 0;
+    BucketArrayAdd(bucketArray, &newNr);
+    int* firstElement = BucketArrayGet(bucketArray, 0);
+
+    for(newNr = 1; newNr < 100000; ++newNr)
+    {
+        BucketArrayAdd(bucketArray, &newNr);
+    }
+
+    TEST_CHECK(bucketArray->num == 100000);
+    TEST_CHECK(bucketArray->bucketPtrs.num == 1);
+    TEST_CHECK(BucketArrayGet(bucketArray, 0) == firstElement);
+
+    bool allElementsCorrect = true;
+    for(int i = 0; i < 100000; ++i)
+    {
+        int* element = BucketArrayGet(bucketArray, i);
+        allElementsCorrect &= (element == firstElement + i && *element == i);
+    }
+    TEST_CHECK(allElementsCorrect);
+
+    while(bucketArray->num > 10)
+    {
+        BucketArrayPopBack(bucketArray, NULL);
+    }
+
+    Index prevCapacity = BucketArrayCapacity(bucketArray);
+    TEST_CHECK(BucketArrayShrink(bucketArray, 1) == 1);
+    TEST_CHECK(BucketArrayCapacity(bucketArray) < prevCapacity);
+    TEST_CHECK(BucketArrayCapacity(bucketArray) >= 10);
+    TEST_CHECK(*(int*) BucketArrayGet(bucketArray, 9) == 9);
+
+    BucketArrayResize(bucketArray, 5);
+    TEST_CHECK(bucketArray->num == 5);
+    TEST_CHECK(*(int*) BucketArrayGet(bucketArray, 4) == 4);
+
+    TEST_CHECK(BucketArrayResize(bucketArray, 5000));
+    TEST_CHECK(BucketArrayCapacity(bucketArray) >= 5000);
+    TEST_CHECK(BucketArrayGet(bucketArray, 0) == firstElement);
+
+    BucketArrayFree(bucketArray);
+}
+
+void TestBucketArrayAligned()
+{
+    BucketArray* bucketArray = BucketArrayNewAligned(sizeof(float), 3, 64, NULL);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        float newNr = i;
+        BucketArrayAdd(bucketArray, &newNr);
+    }
+
+    bool allBucketsAligned = true;
+    for(Index i = 0; i < BucketArrayNumBuckets(bucketArray); ++i)
+    {
+        allBucketsAligned &= ((uintptr_t) BucketArrayGetBucket(bucketArray, i) % 64) == 0;
+    }
+    TEST_CHECK(allBucketsAligned);
+    TEST_CHECK(*(float*) BucketArrayGet(bucketArray, 99) == 99.0f);
+
+    BucketArrayFree(bucketArray);
+}
+
+void TestBucketArrayTyped()
+{
+    intBucketArray fixedBucketArray;
+    intBucketArray geometricBucketArray;
+    intBucketArrayInit(&fixedBucketArray, 7, NULL);
+    intBucketArrayInitGeometric(&geometricBucketArray, 4, NULL);
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        intBucketArrayAdd(&fixedBucketArray, i);
+        intBucketArrayAdd(&geometricBucketArray, i);
+    }
+
+    bool allElementsCorrect = true;
+    for(int i = 0; i < 1000; ++i)
+    {
+        allElementsCorrect &= (*intBucketArrayGet(&fixedBucketArray, i) == i);
+        allElementsCorrect &= (*intBucketArrayGet(&geometricBucketArray, i) == i);
+        allElementsCorrect &= (intBucketArrayGet(&geometricBucketArray, i) == BucketArrayGet(&(geometricBucketArray.base), i));
+    }
+    TEST_CHECK(allElementsCorrect);
+    TEST_CHECK(intBucketArrayNum(&fixedBucketArray) == 1000);
+    TEST_CHECK(intBucketArrayPopBack(&fixedBucketArray) == 999);
+    TEST_CHECK(intBucketArrayNum(&fixedBucketArray) == 999);
+
+    intBucketArrayDeinit(&fixedBucketArray);
+    intBucketArrayDeinit(&geometricBucketArray);
+}
+
+void TestBucketArrayIterator(BucketArray* bucketArray)
+{
+    void* span;
+    Index spanNum;
+
+    BucketArrayIterator emptyIterator = BucketArrayIterate(bucketArray);
+    TEST_CHECK(BucketArrayIteratorNext(&emptyIterator, &span, &spanNum) == false);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        BucketArrayAdd(bucketArray, &i);
+    }
+
+    int expected = 0;
+    bool allElementsInOrder = true;
+    BucketArrayIterator iterator = BucketArrayIterate(bucketArray);
+
+    while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
+    {
+        for(Index i = 0; i < spanNum; ++i)
+        {
+            allElementsInOrder &= (((int*) span)[i] == expected++);
+        }
+    }
+
+    TEST_CHECK(allElementsInOrder);
+    TEST_CHECK(expected == 100);
+
+    allElementsInOrder = true;
+    iterator = BucketArrayIterateReverse(bucketArray);
+
+    while(BucketArrayIteratorNext(&iterator, &span, &spanNum))
+    {
+        for(Index i = spanNum; i > 0; --i)
+        {
+            allElementsInOrder &= (((int*) span)[i - 1] == --expected);
+        }
+    }
+
+    TEST_CHECK(allElementsInOrder);
+    TEST_CHECK(expected == 0);
+
+    BucketArrayFree(bucketArray);
+}
+
 void TestBucketArray()
 {
     TestBucketArrayAdd();
     TestBucketArrayResize();
     TestBucketArrayClear();
+    TestBucketArrayGeometric();
+    TestBucketArrayReserved();
+    TestBucketArrayAligned();
+    TestBucketArrayTyped();
+    TestBucketArrayRange(BucketArrayNew(sizeof(int), 7));
+    TestBucketArrayRange(BucketArrayNewGeometric(sizeof(int), 4));
+    TestBucketArrayRange(BucketArrayNewReserved(sizeof(int), 1000, false));
+    TestBucketArrayIterator(BucketArrayNew(sizeof(int), 7));
+    TestBucketArrayIterator(BucketArrayNewGeometric(sizeof(int), 4));
+    TestBucketArrayIterator(BucketArrayNewReserved(sizeof(int), 1000, false));
 }
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "Containers/BucketPool.h"
+#include "Containers/BucketArray.h"
+
+void TestBucketPoolRecycle()
+{
+    BucketPool* bucketPool = BucketPoolNew(NULL, 1 << 20);
+    const Allocator* allocator = BucketPoolGetAllocator(bucketPool);
+
+    BucketArray* first = BucketArrayNewWithAllocator(sizeof(int), 16, allocator);
+    BucketArray* second = BucketArrayNewWithAllocator(sizeof(int), 16, allocator);
+
+    for(int i = 0; i < 160; ++i)
+    {
+        BucketArrayAdd(first, &i);
+    }
+
+    void* lastReleasedBucket = BucketArrayGetBucket(first, 1);
+
+    while(BucketArrayNum(first) > 16)
+    {
+        BucketArrayPopBack(first, NULL);
+    }
+
+    TEST_CHECK(BucketPoolIdleSize(bucketPool) >= 9 * 16 * sizeof(int));
+
+    for(int i = 0; i < 32; ++i)
+    {
+        BucketArrayAdd(second, &i);
+    }
+
+    // The second bucket of the second array is the bucket the first array released last.
+    TEST_CHECK(BucketArrayGetBucket(second, 1) == lastReleasedBucket);
+    TEST_CHECK(*(int*) BucketArrayGet(second, 31) == 31);
+
+    BucketArrayFree(first);
+    BucketArrayFree(second);
+    BucketPoolFree(bucketPool);
+}
+
+void TestBucketPoolWatermark()
+{
+    size_t bucketSize = 64 * 1024;
+    BucketPool* bucketPool = BucketPoolNew(NULL, bucketSize);
+    const Allocator* allocator = BucketPoolGetAllocator(bucketPool);
+
+    char* buckets[3];
+    for(int i = 0; i < 3; ++i)
+    {
+        buckets[i] = AllocatorCalloc(allocator, 1, bucketSize);
+        memset(buckets[i], 0xFF, bucketSize);
+    }
+
+    for(int i = 0; i < 3; ++i)
+    {
+        AllocatorFree(allocator, buckets[i], bucketSize);
+    }
+
+    TEST_CHECK(BucketPoolIdleSize(bucketPool) == bucketSize);
+
+    BucketPoolTrim(bucketPool, 0);
+    TEST_CHECK(BucketPoolIdleSize(bucketPool) == 0);
+
+    // Purged buckets are recycled, and read as zero again.
+    char* recycledBucket = AllocatorAlloc(allocator, bucketSize);
+    TEST_CHECK(recycledBucket == buckets[0] || recycledBucket == buckets[1] || recycledBucket == buckets[2]);
+    TEST_CHECK(recycledBucket[0] == 0 && recycledBucket[bucketSize - 1] == 0);
+
+    AllocatorFree(allocator, recycledBucket, bucketSize);
+    BucketPoolFree(bucketPool);
+}
+
+void TestBucketPool()
+{
+    TestBucketPoolRecycle();
+    TestBucketPoolWatermark();
+}
\ No newline at end of file
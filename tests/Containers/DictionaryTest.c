@@ -57,8 +57,37 @@ void TestDictionaryResize()
     TEST_CHECK(dict->elements.num == newCapacity);
 }
 
+void TestDictionaryIntegerKeys()
+{
+    Dictionary* dict = DictionaryNewWithHash(sizeof(uint64_t), sizeof(uint64_t), HashInteger, NULL);
+
+    for(uint64_t i = 0; i < 1000; ++i)
+    {
+        uint64_t key = i << 40;
+        uint64_t value = i * 3;
+        DictionaryAdd(dict, &key, &value);
+    }
+
+    TEST_CHECK(DictionaryNum(dict) == 1000);
+
+    bool allValuesCorrect = true;
+    for(uint64_t i = 0; i < 1000; ++i)
+    {
+        uint64_t key = i << 40;
+        uint64_t* value = DictionaryGet(dict, &key);
+        allValuesCorrect &= (value != NULL && *value == i * 3);
+    }
+    TEST_CHECK(allValuesCorrect);
+
+    uint64_t missingKey = 7;
+    TEST_CHECK(DictionaryGet(dict, &missingKey) == NULL);
+
+    DictionaryFree(dict);
+}
+
 void TestDictionary()
 {
     TestDictionaryAddGet();
     TestDictionaryResize();
+    TestDictionaryIntegerKeys();
 }
\ No newline at end of file
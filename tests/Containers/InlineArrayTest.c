@@ -0,0 +1,50 @@
+#include "Containers/InlineArray.h"
+
+typedef struct InlineArrayData
+{
+    int id;
+    float weight;
+} InlineArrayData;
+
+DECLARE_INLINE_ARRAY(InlineArrayData, 3)
+
+void TestInlineArray()
+{
+    InlineArrayDataInlineArray array;
+    InlineArrayDataInlineArrayInit(&array, NULL);
+
+    for(int i = 0; i < 3; ++i)
+    {
+        InlineArrayDataInlineArrayAdd(&array, (InlineArrayData) { i, i * 0.5f });
+    }
+
+    TEST_CHECK(InlineArrayDataInlineArrayIsInline(&array));
+    TEST_CHECK(InlineArrayDataInlineArrayData(&array) == array.inlineElements);
+
+    // A copy of an inline array still finds its own elements.
+    InlineArrayDataInlineArray copy;
+    memcpy(&copy, &array, sizeof(InlineArrayDataInlineArray));
+    TEST_CHECK(InlineArrayDataInlineArrayGet(&copy, 2)->id == 2);
+    TEST_CHECK(InlineArrayDataInlineArrayData(&copy) == copy.inlineElements);
+
+    for(int i = 3; i < 100; ++i)
+    {
+        InlineArrayDataInlineArrayAdd(&array, (InlineArrayData) { i, i * 0.5f });
+    }
+
+    TEST_CHECK(!InlineArrayDataInlineArrayIsInline(&array));
+    TEST_CHECK(InlineArrayDataInlineArrayNum(&array) == 100);
+
+    bool allElementsCorrect = true;
+    for(int i = 0; i < 100; ++i)
+    {
+        allElementsCorrect &= (InlineArrayDataInlineArrayGet(&array, i)->id == i);
+    }
+    TEST_CHECK(allElementsCorrect);
+
+    TEST_CHECK(InlineArrayDataInlineArrayPopBack(&array).weight == 49.5f);
+    TEST_CHECK(InlineArrayDataInlineArrayNum(&array) == 99);
+
+    InlineArrayDataInlineArrayDeinit(&array);
+    TEST_CHECK(InlineArrayDataInlineArrayIsInline(&array));
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "Containers/SortedArray.h"
+
+void TestSortedArrayBounds(SortedArray* sortedArray, const uint64_t numKeys)
+{
+    // Every even key is present twice, so the bounds of present and missing keys can be checked.
+    for(uint64_t i = 0; i < numKeys; ++i)
+    {
+        SortedArrayInsert(sortedArray, (numKeys - 1 - i) * 2);
+        SortedArrayInsert(sortedArray, i * 2);
+    }
+
+    TEST_CHECK(SortedArrayNum(sortedArray) == numKeys * 2);
+
+    bool allBoundsCorrect = true;
+    for(uint64_t i = 0; i < numKeys; ++i)
+    {
+        allBoundsCorrect &= (SortedArrayLowerBound(sortedArray, i * 2) == i * 2);
+        allBoundsCorrect &= (SortedArrayUpperBound(sortedArray, i * 2) == i * 2 + 2);
+        allBoundsCorrect &= (SortedArrayLowerBound(sortedArray, i * 2 + 1) == i * 2 + 2);
+        allBoundsCorrect &= (SortedArrayUpperBound(sortedArray, i * 2 + 1) == i * 2 + 2);
+        allBoundsCorrect &= SortedArrayContains(sortedArray, i * 2);
+        allBoundsCorrect &= !SortedArrayContains(sortedArray, i * 2 + 1);
+    }
+    TEST_CHECK(allBoundsCorrect);
+
+    TEST_CHECK(SortedArrayRemove(sortedArray, 0));
+    TEST_CHECK(SortedArrayContains(sortedArray, 0));
+    TEST_CHECK(SortedArrayRemove(sortedArray, 0));
+    TEST_CHECK(!SortedArrayContains(sortedArray, 0));
+    TEST_CHECK(!SortedArrayRemove(sortedArray, 1));
+    TEST_CHECK(SortedArrayGet(sortedArray, 0) == 2);
+
+    SortedArrayFree(sortedArray);
+}
+
+void TestSortedArrayBuild()
+{
+    SortedArray* sortedArray = SortedArrayNew();
+
+    // Keys with the highest bit set check that the keys are compared unsigned.
+    uint64_t keys[6] = { UINT64_MAX, 5, (uint64_t) 1 << 63, 0, 5, 42 };
+    SortedArrayBuild(sortedArray, keys, 6);
+
+    TEST_CHECK(SortedArrayNum(sortedArray) == 6);
+    TEST_CHECK(SortedArrayGet(sortedArray, 0) == 0);
+    TEST_CHECK(SortedArrayGet(sortedArray, 3) == 42);
+    TEST_CHECK(SortedArrayGet(sortedArray, 5) == UINT64_MAX);
+    TEST_CHECK(SortedArrayLowerBound(sortedArray, (uint64_t) 1 << 63) == 4);
+    TEST_CHECK(SortedArrayUpperBound(sortedArray, 5) == 3);
+    TEST_CHECK(SortedArrayUpperBound(sortedArray, UINT64_MAX) == 6);
+
+    SortedArrayClear(sortedArray);
+    TEST_CHECK(SortedArrayNum(sortedArray) == 0);
+    TEST_CHECK(SortedArrayLowerBound(sortedArray, 5) == 0);
+
+    SortedArrayFree(sortedArray);
+}
+
+void TestSortedArrayVectorized()
+{
+    TEST_CHECK(SortedArrayIsVectorized() == (bool) __builtin_cpu_supports("avx2"));
+
+    // Every size of linearly searched array, with keys on both sides of the highest bit, ends with a partly filled vector at some point.
+    uint64_t keys[SORTED_ARRAY_LINEAR_SEARCH_MAX_NUM];
+    bool allBoundsCorrect = true;
+
+    for(uint64_t numKeys = 1; numKeys <= SORTED_ARRAY_LINEAR_SEARCH_MAX_NUM; ++numKeys)
+    {
+        SortedArray* sortedArray = SortedArrayNew();
+
+        for(uint64_t i = 0; i < numKeys; ++i)
+        {
+            keys[i] = (i % 2 == 0 ? (uint64_t) 1 << 63 : 0) + i * 3;
+        }
+
+        SortedArrayBuild(sortedArray, keys, numKeys);
+
+        for(uint64_t i = 0; i < numKeys; ++i)
+        {
+            uint64_t numBelow = 0;
+            for(uint64_t k = 0; k < numKeys; ++k)
+            {
+                numBelow += keys[k] < keys[i];
+            }
+
+            allBoundsCorrect &= (SortedArrayLowerBound(sortedArray, keys[i]) == numBelow);
+            allBoundsCorrect &= (SortedArrayUpperBound(sortedArray, keys[i]) == numBelow + 1);
+        }
+
+        SortedArrayFree(sortedArray);
+    }
+
+    TEST_CHECK(allBoundsCorrect);
+}
+
+void TestSortedArray()
+{
+    TestSortedArrayBounds(SortedArrayNew(), 7);       // Searched linearly.
+    TestSortedArrayBounds(SortedArrayNew(), 1000);    // Searched with a binary search.
+    TestSortedArrayBuild();
+    TestSortedArrayVectorized();
+}
\ No newline at end of file
@@ -2,22 +2,206 @@
 
 typedef struct SparseSetData
 {
-    uint64_t index;
+    Index index;
     char* data;
 }SparseSetData;
 
-uint64_t DataGetIndex(const void* data)
+Index DataGetIndex(const void* data)
 {
     SparseSetData* sparseSetData = (SparseSetData*) data;
     return sparseSetData->index;
 }
 
-void DataSetIndex(void* data, uint64_t index)
+DECLARE_SPARSE_SET(SparseSetData)
+
+void DataSetIndex(void* data, Index index)
 {
     SparseSetData* sparseSetData = (SparseSetData*) data;
     sparseSetData->index = index;
 }
 
+void TestSparseSetCompact()
+{
+    SparseSet* s = SparseSetNew(sizeof(SparseSetData), DataGetIndex, 4);
+
+    SparseSetData sData = { 0, "Spike" };
+
+    for(int i = 0; i < 64; ++i)
+    {
+        sData.index = i;
+        SparseSetAdd(s, &sData);
+    }
+
+    TEST_CHECK(BucketArrayNumBuckets(&(s->sparseData)) == 16);
+    TEST_CHECK(BucketArrayNumBuckets(&(s->denseData)) == 16);
+
+    for(int i = 63; i >= 2; --i)
+    {
+        SparseSetRemove(s, i);
+    }
+
+    // Re-adding 0 places it behind 1 in the dense data.
+    SparseSetRemove(s, 0);
+    sData.index = 0;
+    SparseSetAdd(s, &sData);
+
+    TEST_CHECK(BucketArrayNum(SparseSetGetDenseData(s)) == 2);
+
+    // Every call is bounded, so compaction takes several calls to complete.
+    uint64_t numCalls = 0;
+    bool isCompact = false;
+    while(!isCompact && numCalls < 1000)
+    {
+        TEST_CHECK(SparseSetCompact(s, 8, true, &isCompact) <= 8);
+        ++numCalls;
+    }
+
+    TEST_CHECK(isCompact);
+
+    TEST_CHECK(numCalls > 1);
+    TEST_CHECK(BucketArrayNumBuckets(&(s->sparseData)) == 1);
+    TEST_CHECK(BucketArrayNumBuckets(&(s->denseData)) == 1);
+
+    TEST_CHECK(SparseSetContains(s, 0) == true);
+    TEST_CHECK(SparseSetContains(s, 1) == true);
+    TEST_CHECK(SparseSetContains(s, 2) == false);
+    TEST_CHECK(((SparseSetData*) BucketArrayGet(SparseSetGetDenseData(s), 0))->index == 0);
+    TEST_CHECK(((SparseSetData*) SparseSetGet(s, 1))->index == 1);
+
+    SparseSetFree(s);
+}
+
+void TestSparseSetCompactGeometric()
+{
+    SparseSet* s = SparseSetNewGeometric(sizeof(SparseSetData), DataGetIndex, 4);
+
+    SparseSetData sData = { 0, "Spike" };
+
+    for(int i = 0; i < 4096; ++i)
+    {
+        sData.index = i;
+        SparseSetAdd(s, &sData);
+    }
+
+    for(int i = 4095; i >= 64; --i)
+    {
+        SparseSetRemove(s, i);
+    }
+
+    // Swap-removing from the front scatters the remaining elements over the dense data.
+    for(int i = 0; i < 64; i += 4)
+    {
+        SparseSetRemove(s, i);
+        sData.index = i;
+        SparseSetAdd(s, &sData);
+    }
+
+    // The last sparse bucket is much larger than a single call may inspect, so it's scanned over multiple calls.
+    uint64_t numCalls = 0;
+    bool isCompact = false;
+    while(!isCompact && numCalls < 10000)
+    {
+        TEST_CHECK(SparseSetCompact(s, 16, true, &isCompact) <= 16);
+        ++numCalls;
+    }
+
+    TEST_CHECK(isCompact);
+    TEST_CHECK(numCalls > 2048 / 16);
+    TEST_CHECK(BucketArrayNum(&(s->sparseData)) < 128); // Only the buckets up to the one holding index 63 are left.
+    TEST_CHECK(SparseSetCompact(s, 16, true, &isCompact) == 0 && isCompact);
+
+    bool isOrdered = true;
+    for(Index i = 0; i < 64; ++i)
+    {
+        isOrdered = isOrdered && ((SparseSetData*) BucketArrayGet(SparseSetGetDenseData(s), i))->index == i;
+        isOrdered = isOrdered && ((SparseSetData*) SparseSetGet(s, i))->index == i;
+    }
+    TEST_CHECK(isOrdered);
+
+    // A change means the set has to be compacted again.
+    SparseSetRemove(s, 10);
+    TEST_CHECK(SparseSetCompact(s, 0, true, &isCompact) == 0 && !isCompact);
+
+    SparseSetFree(s);
+}
+
+void TestSparseSetContainsBatch(SparseSet* s)
+{
+    SparseSetData sData = { 0, "Batch" };
+
+    for(int i = 0; i < 100; i += 3)
+    {
+        sData.index = i;
+        SparseSetAdd(s, &sData);
+    }
+
+    SparseSetRemove(s, 9);
+
+    Index indices[SPARSE_SET_MAX_BATCH_SIZE];
+    uint64_t expected = 0;
+
+    for(int i = 0; i < SPARSE_SET_MAX_BATCH_SIZE; ++i)
+    {
+        indices[i] = i * 2;
+        expected |= (uint64_t) SparseSetContains(s, indices[i]) << i;
+    }
+
+    TEST_CHECK(SparseSetContainsBatch(s, indices, SPARSE_SET_MAX_BATCH_SIZE) == expected);
+    TEST_CHECK((SparseSetContainsBatch(s, indices, 7) & (1 << 3)) != 0);   // 6
+    TEST_CHECK((SparseSetContainsBatch(s, indices, 7) & (1 << 2)) == 0);   // 4
+    TEST_CHECK(SparseSetContainsBatch(s, indices, 0) == 0);
+
+    indices[0] = 9;
+    TEST_CHECK((SparseSetContainsBatch(s, indices, 1) & 1) == 0);
+
+    // Scattered indices, some far outside of the sparse data, in a batch that doesn't fill the last vector.
+    expected = 0;
+    for(int i = 0; i < 61; ++i)
+    {
+        indices[i] = (i * 37) % 150 + (i % 7 == 0 ? 1000000 : 0);
+        expected |= (uint64_t) SparseSetContains(s, indices[i]) << i;
+    }
+
+    TEST_CHECK(SparseSetContainsBatch(s, indices, 61) == expected);
+
+    // Indices with the highest bit set, which a signed comparison would take for negative numbers.
+    const Index highBit = (Index) 1 << (sizeof(Index) * 8 - 1);
+    Index highIndices[8] = { highBit, 3, (Index) -1, highBit + 3, 6, highBit | 1, (Index) -2, 12 };
+    expected = 0;
+    for(int i = 0; i < 8; ++i)
+    {
+        expected |= (uint64_t) SparseSetContains(s, highIndices[i]) << i;
+    }
+
+    TEST_CHECK(expected == ((1 << 1) | (1 << 4) | (1 << 7)));
+    TEST_CHECK(SparseSetContainsBatch(s, highIndices, 8) == expected);
+
+    SparseSetFree(s);
+}
+
+void TestSparseSetTyped()
+{
+    SparseSetDataSparseSet s;
+    SparseSetDataSparseSetInit(&s, DataGetIndex, 4, NULL);
+
+    for(Index i = 0; i < 100; i += 3)
+    {
+        SparseSetDataSparseSetAdd(&s, (SparseSetData) { i, "Typed" });
+    }
+
+    TEST_CHECK(SparseSetDataSparseSetNum(&s) == 34);
+    TEST_CHECK(SparseSetDataSparseSetContains(&s, 99));
+    TEST_CHECK(!SparseSetDataSparseSetContains(&s, 98));
+    TEST_CHECK(SparseSetDataSparseSetGet(&s, 42)->index == 42);
+    TEST_CHECK(SparseSetDataSparseSetGet(&s, 42) == SparseSetGet(&(s.base), 42));
+
+    SparseSetDataSparseSetRemove(&s, 42);
+    TEST_CHECK(!SparseSetDataSparseSetContains(&s, 42));
+    TEST_CHECK(SparseSetDataSparseSetGet(&s, 45)->index == 45);
+
+    SparseSetDataSparseSetDeinit(&s);
+}
+
 void TestSparseSet()
 {
     SparseSet* s = SparseSetNew(sizeof(SparseSetData), DataGetIndex, 3);
@@ -40,5 +224,28 @@ void TestSparseSet()
     TEST_CHECK(SparseSetContains(s, 0) == false);
     TEST_CHECK(BucketArrayNum(SparseSetGetDenseData(s)) == 1);
 
+    SparseSetData range[4] = { { 2, "Duplicate" }, { 5, "A" }, { 40, "B" }, { 7, "C" } };
+    SparseSetAddRange(s, range, 4);
+    TEST_CHECK(BucketArrayNum(SparseSetGetDenseData(s)) == 4);
+    TEST_CHECK(SparseSetContains(s, 40) == true);
+    TEST_CHECK(strcmp(((SparseSetData*) SparseSetGet(s, 2))->data, "World") == 0);
+    TEST_CHECK(strcmp(((SparseSetData*) SparseSetGet(s, 7))->data, "C") == 0);
+
     // TEST_CHECK(SparseSetGet()
+
+    TestSparseSetCompact();
+    TestSparseSetCompactGeometric();
+    TestSparseSetTyped();
+#if !defined(INDEX_32) && defined(__x86_64__) && defined(__GNUC__)
+    // Sets with geometric or power of 2 buckets look batches up with AVX2 gathers, when the CPU has it, even if the library wasn't compiled with -mavx2.
+    TEST_CHECK(SparseSetBatchIsVectorized(s) == false);
+    SparseSet* vectorizedSet = SparseSetNewGeometric(sizeof(SparseSetData), DataGetIndex, 4);
+    TEST_CHECK(SparseSetBatchIsVectorized(vectorizedSet) == (bool) __builtin_cpu_supports("avx2"));
+    SparseSetFree(vectorizedSet);
+#endif
+
+    TestSparseSetContainsBatch(SparseSetNew(sizeof(SparseSetData), DataGetIndex, 3));
+    TestSparseSetContainsBatch(SparseSetNew(sizeof(SparseSetData), DataGetIndex, 16));
+    TestSparseSetContainsBatch(SparseSetNewGeometric(sizeof(SparseSetData), DataGetIndex, 4));
+    TestSparseSetContainsBatch(SparseSetNewReserved(sizeof(SparseSetData), DataGetIndex, 4, 1 << 16, false));
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Core/Component.h"
 
 #include "Utils/Hash.h"
+#include "Utils/Profiler.h"
 #include "Logger.h"
 
 typedef struct TestComponent1
@@ -26,6 +27,9 @@ typedef struct TestComponent2
 ComponentTypeID testComponent1TypeID;
 ComponentTypeID testComponent2TypeID;
 
+// Component type IDs are constants, so they can fill static tables without hashing at startup.
+static const ComponentTypeID componentTypeIDTable[2] = { COMPONENT_TYPE_ID(TestComponent1), COMPONENT_TYPE_ID(TestComponent2) };
+
 void UpdateTestSystem1(int numComponents, void* componentData[])
 {
     TestComponent1* testComponent1 = (TestComponent1*) componentData;
@@ -59,10 +63,16 @@ void TestECS()
     //TODO: This should be done automatically when creating a new scene. The scene creation will probably have to be done through the ECS system for this to work.
     newScene = ArrayAdd(&(ecs->Scenes), newScene);
 
-    testComponent1TypeID = ECSRegisterComponent(ecs, "TestComponent1", 14, sizeof(TestComponent1));
+    testComponent1TypeID = ECS_REGISTER_COMPONENT(ecs, TestComponent1);
     testComponent2TypeID = ECSRegisterComponent(ecs, "TestComponent2", 14, sizeof(TestComponent2));
 
+    TEST_CHECK(testComponent1TypeID == HashFNV1a64("TestComponent1", 14));
+    TEST_CHECK(testComponent2TypeID == COMPONENT_TYPE_ID(TestComponent2));
+    TEST_CHECK(ECS_REGISTER_COMPONENT(ecs, TestComponent2) == testComponent2TypeID);
+    TEST_CHECK(componentTypeIDTable[1] == testComponent2TypeID);
+
     Entity newEntity = ECSAddEntity(ecs, newScene);
+    TEST_CHECK(SceneGetComponentStore(newScene, 0) == NULL);
 
     TestComponent1 newTestComponent1;
     newTestComponent1.testInt = 1234;
@@ -76,18 +86,60 @@ void TestECS()
     newTestComponent2.testBool2 = false;
     ECSAddComponent(ecs, testComponent2TypeID, &newTestComponent2, newEntity, newScene);
 
+    TEST_CHECK(ECSGetComponentTypeIndex(ecs, testComponent1TypeID) == 0);
+    TEST_CHECK(ECSGetComponentTypeIndex(ecs, testComponent2TypeID) == 1);
+    TEST_CHECK(((TestComponent2*) SparseSetGet(SceneGetComponentStore(newScene, 1), newEntity))->testInt2 == -4321);
+
+    // A scene only gets stores for the component types it uses. Systems needing a type it lacks are skipped.
+    Scene* secondScene = SceneNew();
+    secondScene = ArrayAdd(&(ecs->Scenes), secondScene);
+    newScene = ArrayGetFast(&(ecs->Scenes), 0); // Adding a scene may have moved the others.
+    Entity secondEntity = ECSAddEntity(ecs, secondScene);
+    ECSAddComponent(ecs, testComponent1TypeID, &newTestComponent1, secondEntity, secondScene);
+    TEST_CHECK(SceneGetComponentStore(secondScene, 0) != NULL);
+    TEST_CHECK(SceneGetComponentStore(secondScene, 1) == NULL);
+
     ComponentTypeID componentsToUpdate1[1] = { testComponent1TypeID };
-    System* testSystem1 = SystemNew("testSystem1", 11, componentsToUpdate1, 1, 69, &UpdateTestSystem1);
+    System* testSystem1 = SYSTEM_NEW("testSystem1", componentsToUpdate1, 1, 69, &UpdateTestSystem1);
+    TEST_CHECK(testSystem1->id == SYSTEM_TYPE_ID("testSystem1"));
+    TEST_CHECK(testSystem1->id == HashFNV1a64("testSystem1", 11));
 
     ComponentTypeID componentsToUpdate2[2] = { testComponent1TypeID, testComponent2TypeID };
     System* testSystem2 = SystemNew("testSystem2", 11, componentsToUpdate2, 2, 69, &UpdateTestSystem1And2);
 
-    ECSRegisterSystem(ecs, testSystem1);
-    ECSRegisterSystem(ecs, testSystem2);
+    TEST_CHECK(ECSRegisterSystem(ecs, testSystem1));
+    TEST_CHECK(ECSRegisterSystem(ecs, testSystem2));
+
+    // Systems and components of unregistered component types are refused, instead of reading past the registered types.
+    ComponentTypeID unregisteredComponents[2] = { testComponent1TypeID, COMPONENT_TYPE_ID(UnregisteredComponent) };
+    System* unregisteredSystem = SYSTEM_NEW("unregisteredSystem", unregisteredComponents, 2, 69, &UpdateTestSystem1And2);
+    TEST_CHECK(!ECSRegisterSystem(ecs, unregisteredSystem));
+    SystemFree(unregisteredSystem);
+
+    TEST_CHECK(ECSGetComponentTypeIndex(ecs, COMPONENT_TYPE_ID(UnregisteredComponent)) == COMPONENT_TYPE_INDEX_INVALID);
+    TEST_CHECK(ECSAddComponent(ecs, COMPONENT_TYPE_ID(UnregisteredComponent), &newTestComponent1, newEntity, newScene) == 0);
 
     TEST_CHECK(ecs->systems.num == 2);
 
+    ProfilerStart(0);
     ECSUpdate(ecs, newScene);
+    ECSUpdate(ecs, secondScene);
+    ProfilerStop();
+
+#ifdef PROFILE
+    // Every update and every system in it is a zone, including the system the second scene skips.
+    TEST_CHECK(ProfilerNumZones() >= 2 + 2 * 2);
+#else
+    TEST_CHECK(ProfilerNumZones() == 0);
+#endif
+
+    ProfilerReset();
+
+    Entity spawnedEntities[3];
+    ECSAddEntities(ecs, newScene, spawnedEntities, 3);
+    TEST_CHECK(spawnedEntities[0] == newEntity + 1);
+    TEST_CHECK(spawnedEntities[2] == newEntity + 3);
+    TEST_CHECK(SparseSetContains(&(newScene->entities), spawnedEntities[2]));
 
     ECSFree(ecs);
 }
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "Logger.h"
+#include "Utils/Thread.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+static const char* LOGGER_TEST_FILE_PATH = "LoggerTest.log";
+static const char* LOGGER_TEST_BINARY_FILE_PATH = "LoggerTest.bin";
+static const char* LOGGER_TEST_RING_FILE_PATH = "LoggerTest.ring";
+static const size_t LOGGER_TEST_RING_SIZE = 64 * 1024;
+
+static uint64_t LoggerTestCountLines(const char* text)
+{
+    FILE* file = fopen(LOGGER_TEST_FILE_PATH, "r");
+    TEST_ASSERT(file != NULL);
+
+    uint64_t numLines = 0;
+    char line[512];
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        numLines += strstr(line, text) != NULL;
+    }
+
+    fclose(file);
+    return numLines;
+}
+
+// The logging functions are called directly, since the LogInfo and LogWarning macros compile out without DEBUG.
+static void LoggerTestLogFromThread(void* argument)
+{
+    for(int i = 0; i < 500; ++i)
+    {
+        _LogInfo(NULL, __FILE__, __LINE__, "Async message %d from thread %u", i, ThreadGetID());
+    }
+}
+
+void TestLoggerAsyncBlock()
+{
+    remove(LOGGER_TEST_FILE_PATH);
+
+    LoggerAsyncSettings settings = LoggerAsyncDefaultSettings();
+    settings.filePath = LOGGER_TEST_FILE_PATH;
+    settings.ringCapacity = 50;
+    settings.fullPolicy = LOG_FULL_POLICY_BLOCK;
+    settings.flushIntervalMilliseconds = 1;
+
+    TEST_CHECK(LoggerAsyncStart(&settings));
+    TEST_CHECK(LoggerAsyncIsRunning());
+    TEST_CHECK(!LoggerAsyncStart(&settings));
+
+    Thread* threads[2] = { ThreadNew(&LoggerTestLogFromThread, NULL), ThreadNew(&LoggerTestLogFromThread, NULL) };
+    TEST_ASSERT(threads[0] != NULL && threads[1] != NULL);
+
+    LoggerTestLogFromThread(NULL);
+    _LogWarning(NULL, __FILE__, __LINE__, "Async warning");
+
+    ThreadJoin(threads[0]);
+    ThreadJoin(threads[1]);
+
+    // Blocking loggers wait for room instead of dropping messages.
+    TEST_CHECK(LoggerAsyncNumDropped() == 0);
+
+    LoggerAsyncStop();
+    TEST_CHECK(!LoggerAsyncIsRunning());
+
+    TEST_CHECK(LoggerTestCountLines("Async message") == 1500);
+    TEST_CHECK(LoggerTestCountLines("[WARNING] ") == 1);
+    TEST_CHECK(LoggerTestCountLines("Async message 499 from thread") == 3);
+
+    remove(LOGGER_TEST_FILE_PATH);
+}
+
+void TestLoggerAsyncDrop()
+{
+    remove(LOGGER_TEST_FILE_PATH);
+
+    LoggerAsyncSettings settings = LoggerAsyncDefaultSettings();
+    settings.filePath = LOGGER_TEST_FILE_PATH;
+    settings.ringCapacity = 16;
+    settings.fullPolicy = LOG_FULL_POLICY_DROP;
+    settings.flushIntervalMilliseconds = 1000;
+
+    TEST_CHECK(LoggerAsyncStart(&settings));
+
+    // The flush thread is waiting for its interval, so the ring fills up almost immediately.
+    for(int i = 0; i < 100; ++i)
+    {
+        _LogInfo(NULL, __FILE__, __LINE__, "Async message %d", i);
+    }
+
+    uint64_t numDropped = LoggerAsyncNumDropped();
+    TEST_CHECK(numDropped > 0);
+
+    LoggerAsyncStop();
+
+    TEST_CHECK(LoggerTestCountLines("Async message") == 100 - numDropped);
+    TEST_CHECK(LoggerTestCountLines("Dropped ") >= 1);
+
+    remove(LOGGER_TEST_FILE_PATH);
+}
+
+static void LoggerTestLogBinaryFromThread(void* argument)
+{
+    static LogSite site = { 0 };
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        _LogInfo(&site, __FILE__, __LINE__, "Binary message %d from thread %u", i, ThreadGetID());
+    }
+}
+
+void TestLoggerBinary()
+{
+    remove(LOGGER_TEST_BINARY_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+
+    TEST_CHECK(LoggerBinaryStart(LOGGER_TEST_BINARY_FILE_PATH));
+    TEST_CHECK(LoggerBinaryIsRunning());
+    TEST_CHECK(!LoggerBinaryStart(LOGGER_TEST_BINARY_FILE_PATH));
+
+    static LogSite site = { 0 };
+    const char* text = "text";
+    void* pointer = &site;
+
+    const int line = __LINE__;
+
+    for(int i = 0; i < 3; ++i)
+    {
+        _LogInfo(&site, __FILE__, line, "Binary %d %s %5.2f %p %llu %u %hhd [%*d] [%-*.*s] %c 100%%", i, text, 3.14159, pointer, 1ULL << 40, -1, 300, 6, 7, 4, 2, "abc", 'x');
+    }
+
+    TEST_CHECK(atomic_load(&(site.id)) != 0);
+    TEST_CHECK(site.numArguments == 13);
+
+    // Call sites without state store their format string with every message.
+    _LogWarning(NULL, __FILE__, __LINE__, "Binary warning %s", NULL);
+
+    Thread* thread = ThreadNew(&LoggerTestLogBinaryFromThread, NULL);
+    TEST_ASSERT(thread != NULL);
+    LoggerTestLogBinaryFromThread(NULL);
+    ThreadJoin(thread);
+
+    LoggerBinaryStop();
+    TEST_CHECK(!LoggerBinaryIsRunning());
+
+    TEST_CHECK(LoggerBinaryDecode(LOGGER_TEST_BINARY_FILE_PATH, LOGGER_TEST_FILE_PATH));
+
+    char expected[256];
+    snprintf(expected, sizeof(expected), "[INFO] %s:%d | Binary 2 text  3.14 %p 1099511627776 4294967295 44 [     7] [ab  ] x 100%%\n", __FILE__, line, pointer);
+    TEST_CHECK(LoggerTestCountLines(expected) == 1);
+    TEST_MSG("Expected: %s", expected);
+    TEST_CHECK(LoggerTestCountLines(" text  3.14 ") == 3);
+    TEST_CHECK(LoggerTestCountLines("[WARNING] ") == 1);
+    TEST_CHECK(LoggerTestCountLines("Binary warning (null)") == 1);
+    TEST_CHECK(LoggerTestCountLines("Binary message ") == 2000);
+    TEST_CHECK(LoggerTestCountLines("Binary message 999 from thread") == 2);
+
+    // Logging again after a restart defines the sites again, in the new log.
+    TEST_CHECK(LoggerBinaryStart(LOGGER_TEST_BINARY_FILE_PATH));
+    LoggerTestLogBinaryFromThread(NULL);
+    LoggerBinaryStop();
+
+    TEST_CHECK(LoggerBinaryDecode(LOGGER_TEST_BINARY_FILE_PATH, LOGGER_TEST_FILE_PATH));
+    TEST_CHECK(LoggerTestCountLines("Binary message ") == 1000);
+
+    TEST_CHECK(!LoggerBinaryDecode(LOGGER_TEST_FILE_PATH, NULL));
+
+    remove(LOGGER_TEST_BINARY_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+}
+
+void TestLoggerFilters()
+{
+    remove(LOGGER_TEST_BINARY_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+
+    TEST_CHECK(LoggerGetModuleLevel(LOG_MODULE) == LOG_LEVEL_INFO);
+    TEST_CHECK(LoggerBinaryStart(LOGGER_TEST_BINARY_FILE_PATH));
+
+    for(int i = 0; i < 100; ++i)
+    {
+        LogInfoEveryN(10, "Every 10th call %d", i);
+        LogWarningRateLimited(5, "Rate limited %d", i);
+    }
+
+    LoggerSetModuleLevel(LOG_MODULE, LOG_LEVEL_WARNING);
+    TEST_CHECK(!LOG_IS_ENABLED(LOG_LEVEL_INFO));
+    TEST_CHECK(LOG_IS_ENABLED(LOG_LEVEL_WARNING));
+    TEST_CHECK(LoggerGetModuleLevel(LOG_MODULE_ECS) == LOG_LEVEL_INFO);
+
+    LogInfo("Filtered info");
+    LogWarning("Kept warning");
+
+    // Calls made while the level is disabled don't count towards the sampling.
+    for(int i = 0; i < 100; ++i)
+    {
+        LogInfoEveryN(10, "Every 10th call %d", i);
+    }
+
+    LoggerSetLevel(LOG_LEVEL_NONE);
+    LogWarning("Filtered warning");
+    LoggerSetLevel(LOG_LEVEL_INFO);
+
+    LoggerBinaryStop();
+    TEST_CHECK(LoggerBinaryDecode(LOGGER_TEST_BINARY_FILE_PATH, LOGGER_TEST_FILE_PATH));
+
+    // The macros are compiled out without DEBUG, or below LOG_MIN_LEVEL.
+#if defined(DEBUG) && LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+    TEST_CHECK(LoggerTestCountLines("Every 10th call ") == 10);
+    TEST_CHECK(LoggerTestCountLines("Every 10th call 90") == 1);
+#endif
+#if defined(DEBUG) && LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+    TEST_CHECK(LoggerTestCountLines("Rate limited ") >= 5 && LoggerTestCountLines("Rate limited ") <= 10);
+    TEST_CHECK(LoggerTestCountLines("Kept warning") == 1);
+#endif
+    TEST_CHECK(LoggerTestCountLines("Filtered") == 0);
+
+    LogRateLimit rateLimit = 0;
+    int numAllowed = 0;
+
+    for(int i = 0; i < 100; ++i)
+    {
+        numAllowed += _LogRateLimitAllows(&rateLimit, 3);
+    }
+
+    // The window can roll over to the next second halfway through.
+    TEST_CHECK(numAllowed >= 3 && numAllowed <= 6);
+    TEST_CHECK(!_LogRateLimitAllows(&rateLimit, 0));
+
+    remove(LOGGER_TEST_BINARY_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+}
+
+#ifndef _WIN32
+// Runs a function in a child process, which dies without stopping the ring logger.
+static void LoggerTestRunCrashingChild(void (*function)())
+{
+    fflush(stdout);
+    pid_t child = fork();
+    TEST_ASSERT(child >= 0);
+
+    if(child == 0)
+    {
+        freopen("/dev/null", "w", stdout);
+        LoggerRingStart(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_RING_SIZE);
+        function();
+        _exit(EXIT_SUCCESS);
+    }
+
+    int status;
+    waitpid(child, &status, 0);
+}
+
+static void LoggerTestKilledChild()
+{
+    _LogInfo(NULL, __FILE__, __LINE__, "Before kill %d", 1);
+    kill(getpid(), SIGKILL);
+}
+
+static void LoggerTestAssertingChild()
+{
+    _LogAssert(__FILE__, __LINE__, false, "isCrashing == false", "Crash %d", 42, NULL);
+}
+#endif
+
+void TestLoggerRing()
+{
+    remove(LOGGER_TEST_RING_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+
+    TEST_CHECK(LoggerRingStart(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_RING_SIZE));
+    TEST_CHECK(LoggerRingIsRunning());
+    TEST_CHECK(!LoggerRingStart(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_RING_SIZE));
+
+    // The ring runs next to the other loggers. The binary logger keeps the messages off the console.
+    TEST_CHECK(LoggerBinaryStart(LOGGER_TEST_BINARY_FILE_PATH));
+
+    for(int i = 0; i < 5000; ++i)
+    {
+        _LogInfo(NULL, __FILE__, __LINE__, "Ring message %d.", i);
+    }
+
+    LoggerBinaryStop();
+    LoggerRingStop();
+    TEST_CHECK(!LoggerRingIsRunning());
+
+    // The ring only holds the most recent messages.
+    TEST_CHECK(LoggerRingDecode(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_FILE_PATH));
+    uint64_t numMessages = LoggerTestCountLines("Ring message ");
+    TEST_CHECK(numMessages > 500 && numMessages < 1000);
+    TEST_CHECK(LoggerTestCountLines("[INFO] ") == numMessages);
+    TEST_CHECK(LoggerTestCountLines("Ring message 4999.") == 1);
+    TEST_CHECK(LoggerTestCountLines("Ring message 10.") == 0);
+
+    char oldestMessage[64];
+    snprintf(oldestMessage, sizeof(oldestMessage), "Ring message %d.", (int) (5000 - numMessages));
+    TEST_CHECK(LoggerTestCountLines(oldestMessage) == 1);
+
+#ifndef _WIN32
+    // The messages are in the file as soon as they're logged, without stopping the logger.
+    LoggerTestRunCrashingChild(&LoggerTestKilledChild);
+    LoggerTestRunCrashingChild(&LoggerTestAssertingChild);
+
+    TEST_CHECK(LoggerRingDecode(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_FILE_PATH));
+    TEST_CHECK(LoggerTestCountLines("Ring message 4999.") == 1);
+    TEST_CHECK(LoggerTestCountLines("Before kill 1") == 1);
+    TEST_CHECK(LoggerTestCountLines("[ASSERT] ") == 1);
+    TEST_CHECK(LoggerTestCountLines("isCrashing == false | Crash 42") == 1);
+#endif
+
+    TEST_CHECK(!LoggerRingDecode(LOGGER_TEST_BINARY_FILE_PATH, NULL));
+
+    // A corrupt header is rejected, instead of dividing by a capacity of 0 or reading the ring from inside the header.
+    FILE* ringFile = fopen(LOGGER_TEST_RING_FILE_PATH, "r+b");
+    TEST_ASSERT(ringFile != NULL);
+    const uint64_t zeroCapacity = 0;
+    fseek(ringFile, 16, SEEK_SET);
+    fwrite(&zeroCapacity, sizeof(zeroCapacity), 1, ringFile);
+    fclose(ringFile);
+    TEST_CHECK(!LoggerRingDecode(LOGGER_TEST_RING_FILE_PATH, NULL));
+
+    TEST_CHECK(LoggerRingStart(LOGGER_TEST_RING_FILE_PATH, LOGGER_TEST_RING_SIZE));
+    LoggerRingStop();
+    ringFile = fopen(LOGGER_TEST_RING_FILE_PATH, "r+b");
+    TEST_ASSERT(ringFile != NULL);
+    const uint32_t smallHeaderSize = 8;
+    fseek(ringFile, 12, SEEK_SET);
+    fwrite(&smallHeaderSize, sizeof(smallHeaderSize), 1, ringFile);
+    fclose(ringFile);
+    TEST_CHECK(!LoggerRingDecode(LOGGER_TEST_RING_FILE_PATH, NULL));
+
+    remove(LOGGER_TEST_RING_FILE_PATH);
+    remove(LOGGER_TEST_BINARY_FILE_PATH);
+    remove(LOGGER_TEST_FILE_PATH);
+}
+
+void TestLogger()
+{
+    TestLoggerAsyncBlock();
+    TestLoggerAsyncDrop();
+    TestLoggerBinary();
+    TestLoggerFilters();
+    TestLoggerRing();
+}
\ No newline at end of file
@@ -1,14 +1,34 @@
 #include "acutest.h"
 
+#include "Containers/ArrayTest.c"
 #include "Containers/BucketArrayTest.c"
+#include "Containers/BucketPoolTest.c"
 #include "Containers/DictionaryTest.c"
+#include "Containers/InlineArrayTest.c"
+#include "Containers/SortedArrayTest.c"
 #include "Containers/SparseSetTest.c"
 #include "Core/ECSTest.c"
+#include "LoggerTest.c"
+#include "Utils/AllocatorTest.c"
+#include "Utils/ArenaTest.c"
+#include "Utils/ClockTest.c"
+#include "Utils/HashTest.c"
+#include "Utils/ProfilerTest.c"
 
 TEST_LIST = {
+    {"TestArray", TestArray },
     {"TestBucketArray", TestBucketArray },
+    {"TestBucketPool", TestBucketPool },
     {"TestDictionary", TestDictionary },
+    {"TestInlineArray", TestInlineArray },
+    {"TestSortedArray", TestSortedArray },
     {"TestSparseSet", TestSparseSet },
     {"TestECS", TestECS },
+    {"TestLogger", TestLogger },
+    {"TestAllocator", TestAllocator },
+    {"TestArena", TestArena },
+    {"TestClock", TestClock },
+    {"TestHash", TestHash },
+    {"TestProfiler", TestProfiler },
     {0}
 };
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "Utils/Allocator.h"
+#include "Containers/Dictionary.h"
+#include "Containers/SparseSet.h"
+#include "Containers/Array.h"
+
+typedef struct TrackingAllocatorData
+{
+    uint64_t numAllocations;
+    int64_t numBytesInUse;
+} TrackingAllocatorData;
+
+void* TrackingAlloc(void* userData, const size_t size)
+{
+    TrackingAllocatorData* data = userData;
+    data->numAllocations++;
+    data->numBytesInUse += size;
+    return malloc(size);
+}
+
+void* TrackingRealloc(void* userData, void* memory, const size_t prevSize, const size_t newSize)
+{
+    TrackingAllocatorData* data = userData;
+    data->numAllocations++;
+    data->numBytesInUse += (int64_t) newSize - (int64_t) prevSize;
+    return realloc(memory, newSize);
+}
+
+void TrackingFree(void* userData, void* memory, const size_t size)
+{
+    TrackingAllocatorData* data = userData;
+    data->numBytesInUse -= size;
+    free(memory);
+}
+
+Index AllocatorTestGetIndex(const void* data)
+{
+    return *(Index*) data;
+}
+
+void TestAllocatorDictionary()
+{
+    TrackingAllocatorData data = { 0, 0 };
+    Allocator allocator = { TrackingAlloc, TrackingRealloc, TrackingFree, &data };
+
+    Dictionary* dict = DictionaryNewWithAllocator(sizeof(uint64_t), sizeof(uint64_t), &allocator);
+    TEST_CHECK(data.numAllocations > 0);
+
+    for(uint64_t i = 0; i < 1000; ++i)
+    {
+        DictionaryAdd(dict, &i, &i);
+    }
+
+    uint64_t key = 567;
+    TEST_CHECK(*(uint64_t*) DictionaryGet(dict, &key) == 567);
+
+    DictionaryFree(dict);
+    TEST_CHECK_(data.numBytesInUse == 0, "%lld bytes still in use", (long long) data.numBytesInUse);
+}
+
+void TestAllocatorSparseSet()
+{
+    TrackingAllocatorData data = { 0, 0 };
+    Allocator allocator = { TrackingAlloc, TrackingRealloc, TrackingFree, &data };
+
+    SparseSet* sparseSet = SparseSetNewWithAllocator(sizeof(Index), AllocatorTestGetIndex, 4, &allocator);
+
+    for(Index i = 0; i < 100; ++i)
+    {
+        SparseSetAdd(sparseSet, &i);
+    }
+
+    TEST_CHECK(data.numAllocations > 0);
+
+    for(Index i = 0; i < 100; i += 2)
+    {
+        SparseSetRemove(sparseSet, i);
+    }
+
+    TEST_CHECK(SparseSetContains(sparseSet, 51));
+
+    SparseSetFree(sparseSet);
+    TEST_CHECK_(data.numBytesInUse == 0, "%lld bytes still in use", (long long) data.numBytesInUse);
+}
+
+void TestAllocatorAligned()
+{
+    TrackingAllocatorData data = { 0, 0 };
+    Allocator allocator = { TrackingAlloc, TrackingRealloc, TrackingFree, &data };
+
+    Array* array = ArrayNewAligned(sizeof(double), 128, &allocator);
+
+    for(int i = 0; i < 100; ++i)
+    {
+        double newNr = i;
+        ArrayAdd(array, &newNr);
+        TEST_CHECK(((uintptr_t) ArrayGet(array, 0) % 128) == 0);
+    }
+
+    ArrayFree(array);
+    TEST_CHECK_(data.numBytesInUse == 0, "%lld bytes still in use", (long long) data.numBytesInUse);
+}
+
+void TestAllocator()
+{
+    TestAllocatorDictionary();
+    TestAllocatorSparseSet();
+    TestAllocatorAligned();
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "Utils/Arena.h"
+#include "Containers/Array.h"
+
+void TestArenaAlloc()
+{
+    Arena* arena = ArenaNew(1 << 20);
+
+    char* first = ArenaAlloc(arena, 3);
+    int64_t* second = ArenaAlloc(arena, sizeof(int64_t));
+    TEST_CHECK(((uintptr_t) second % 16) == 0);
+    TEST_CHECK((char*) second > first);
+
+    size_t mark = ArenaMark(arena);
+    void* big = ArenaAlloc(arena, 200000);
+    memset(big, 1, 200000);
+    TEST_CHECK(ArenaNumBytesUsed(arena) >= 200000);
+
+    ArenaRewind(arena, mark);
+    TEST_CHECK(ArenaNumBytesUsed(arena) == mark);
+    TEST_CHECK(ArenaAlloc(arena, 16) == big);
+
+    ArenaReset(arena);
+    TEST_CHECK(ArenaNumBytesUsed(arena) == 0);
+    TEST_CHECK(ArenaAlloc(arena, 1) == first);
+
+    // Blocks past the reserved address space fail without moving the arena, also when the size would wrap the end around.
+    size_t numBytesUsed = ArenaNumBytesUsed(arena);
+    TEST_CHECK(ArenaAlloc(arena, 2 << 20) == NULL);
+    TEST_CHECK(ArenaAlloc(arena, SIZE_MAX) == NULL);
+    TEST_CHECK(ArenaNumBytesUsed(arena) == numBytesUsed);
+
+    ArenaFree(arena);
+}
+
+void TestArenaAllocator()
+{
+    Arena* arena = ArenaNew(1 << 20);
+
+    Array* array = ArrayNewWithAllocator(sizeof(int), ArenaGetAllocator(arena));
+    int newNr = 0;
+    int* firstElement = ArrayAdd(array, &newNr);
+
+    for(newNr = 1; newNr < 1000; ++newNr)
+    {
+        ArrayAdd(array, &newNr);
+    }
+
+    // The elements are the most recent allocation, so growing them happens in place.
+    TEST_CHECK(ArrayGet(array, 0) == firstElement);
+    TEST_CHECK(*(int*) ArrayGet(array, 999) == 999);
+
+    // A block that can't grow is kept as it was. The realloc function is called directly, since AllocatorRealloc asserts on failure in debug builds.
+    const Allocator* allocator = ArenaGetAllocator(arena);
+    size_t numBytesUsed = ArenaNumBytesUsed(arena);
+    TEST_CHECK(allocator->reallocFunc(allocator->userData, ArrayGet(array, 0), ArrayCapacity(array) * sizeof(int), 2 << 20) == NULL);
+    TEST_CHECK(ArenaNumBytesUsed(arena) == numBytesUsed);
+    TEST_CHECK(*(int*) ArrayGet(array, 999) == 999);
+
+    ArenaFree(arena);
+}
+
+void TestArenaFrame()
+{
+    Arena* frameArena = ArenaGetFrame();
+    TEST_CHECK(frameArena != NULL);
+    TEST_CHECK(ArenaGetFrame() == frameArena);
+
+    size_t mark = ArenaMark(frameArena);
+    ArenaAlloc(frameArena, 64);
+    ArenaRewind(frameArena, mark);
+    TEST_CHECK(ArenaNumBytesUsed(frameArena) == mark);
+}
+
+void TestArena()
+{
+    TestArenaAlloc();
+    TestArenaAllocator();
+    TestArenaFrame();
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "Utils/Clock.h"
+#include "Utils/Thread.h"
+
+void TestClockTicks()
+{
+    ClockCalibrate();
+    TEST_CHECK(ClockNanosecondsPerTick() > 0);
+
+    uint64_t startTicks = ClockTicks();
+    uint64_t startNanoseconds = ClockMonotonicNanoseconds();
+
+    ThreadSleep(20);
+
+    uint64_t elapsedTicks = ClockTicks() - startTicks;
+    uint64_t elapsedNanoseconds = ClockMonotonicNanoseconds() - startNanoseconds;
+
+    TEST_CHECK(elapsedNanoseconds >= 19000000);
+
+    // The calibrated ticks should agree with the monotonic clock closely.
+    uint64_t elapsedTickNanoseconds = ClockTicksToNanoseconds(elapsedTicks);
+    TEST_CHECK(elapsedTickNanoseconds > elapsedNanoseconds * 0.9 && elapsedTickNanoseconds < elapsedNanoseconds * 1.1);
+    TEST_MSG("Ticks: %llu ns, monotonic: %llu ns", (unsigned long long) elapsedTickNanoseconds, (unsigned long long) elapsedNanoseconds);
+
+    uint64_t wallNanoseconds = ClockWallNanoseconds();
+    uint64_t tickWallNanoseconds = ClockTicksToWallNanoseconds(ClockTicks());
+    TEST_CHECK(tickWallNanoseconds + 50000000 > wallNanoseconds && tickWallNanoseconds < wallNanoseconds + 50000000);
+}
+
+void TestClockWallString()
+{
+    char expected[CLOCK_WALL_STRING_SIZE];
+    ClockFormatWallTime(ClockWallNanoseconds(), expected, CLOCK_WALL_STRING_SIZE);
+
+    const char* wallString = ClockWallString();
+    TEST_CHECK(strlen(wallString) == 17);
+
+    // The cached text can only differ from the formatted one if the second changed in between.
+    if(strcmp(wallString, expected) != 0)
+    {
+        ClockFormatWallTime(ClockWallNanoseconds(), expected, CLOCK_WALL_STRING_SIZE);
+    }
+
+    TEST_CHECK(strcmp(wallString, expected) == 0);
+    TEST_CHECK(ClockWallString() == wallString);
+}
+
+void TestClock()
+{
+    uint64_t previous = ClockMonotonicNanoseconds();
+    bool isMonotonic = true;
+
+    for(int i = 0; i < 1000; ++i)
+    {
+        uint64_t now = ClockMonotonicNanoseconds();
+        isMonotonic = isMonotonic && now >= previous;
+        previous = now;
+    }
+
+    TEST_CHECK(isMonotonic);
+
+    TestClockTicks();
+    TestClockWallString();
+}
\ No newline at end of file
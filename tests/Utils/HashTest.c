@@ -0,0 +1,80 @@
+#include "Utils/Hash.h"
+
+void TestHashFNV1a64()
+{
+    // Reference values of FNV-1a, which persisted IDs rely on.
+    TEST_CHECK(HashFNV1a64("a", 1) == 0xaf63dc4c8601ec8cU);
+    TEST_CHECK(HashFNV1a64("foobar", 6) == 0x85944171f73967e8U);
+
+    TEST_CHECK(HASH_FNV1A64_LITERAL("foobar") == 0x85944171f73967e8U);
+    TEST_CHECK(HASH_FNV1A64_LITERAL("a") == HashFNV1a64("a", 1));
+
+    const char longName[] = "AComponentNameOfExactlySixtyFourCharactersLongForTheLimitsCheck!";
+    TEST_CHECK(sizeof(longName) == HASH_FNV1A64_LITERAL_MAX_LENGTH + 1);
+    TEST_CHECK(HASH_FNV1A64_LITERAL("AComponentNameOfExactlySixtyFourCharactersLongForTheLimitsCheck!") == HashFNV1a64(longName, sizeof(longName) - 1));
+}
+
+void TestHashFast64()
+{
+    char data[300];
+    for(int i = 0; i < sizeof(data); ++i)
+    {
+        data[i] = (char) (i * 7);
+    }
+
+    // Every key size ends in another combination of the stripe, word and tail paths. Flipping a single byte should always change the hash.
+    bool allHashesDiffer = true;
+    for(int size = 1; size < 200; ++size)
+    {
+        uint64_t hash = HashFast64(data, size);
+
+        data[size - 1] ^= 1;
+        allHashesDiffer &= (HashFast64(data, size) != hash);
+        data[size - 1] ^= 1;
+
+        data[0] ^= 0x80;
+        allHashesDiffer &= (HashFast64(data, size) != hash);
+        data[0] ^= 0x80;
+
+        allHashesDiffer &= (HashFast64(data, size + 1) != hash);
+    }
+    TEST_CHECK(allHashesDiffer);
+
+    // The hash doesn't depend on the alignment of the data.
+    char unalignedData[301];
+    memcpy(unalignedData + 1, data, sizeof(data));
+    TEST_CHECK(HashFast64(unalignedData + 1, 250) == HashFast64(data, 250));
+
+    TEST_CHECK(HashFast64("", 0) != HashFast64("\0", 1));
+
+    // The AVX2 stripes give the same hash as the scalar lanes, which produced these values.
+    TEST_CHECK(HashFastIsVectorized() == (bool) __builtin_cpu_supports("avx2"));
+    TEST_CHECK(HashFast64(data, 64) == 0x0fcc967555a7b67fU);
+    TEST_CHECK(HashFast64(data, 95) == 0xd3d4e06860f1fb24U);
+    TEST_CHECK(HashFast64(data, 128) == 0x8ca44075d6a48084U);
+    TEST_CHECK(HashFast64(data, 255) == 0x0c2dc0d18f84d2e7U);
+    TEST_CHECK(HashFast64(data, 300) == 0xac5775d8e393560dU);
+}
+
+void TestHashInteger()
+{
+    uint64_t key64 = 1234;
+    uint32_t key32 = 1234;
+    uint8_t key8 = 210;
+
+    TEST_CHECK(HashInteger(&key64, sizeof(key64)) == HashU64(1234));
+    TEST_CHECK(HashInteger(&key32, sizeof(key32)) == HashU64(1234));
+    TEST_CHECK(HashInteger(&key8, sizeof(key8)) == HashU64(210));
+
+    // The high bits of a key reach the low bits of its hash, which pick its slot in a hash table.
+    TEST_CHECK((HashU64((uint64_t) 1 << 63) & 0xffffffff) != 0);
+    TEST_CHECK(HashU64(0) == 0);
+    TEST_CHECK(HashU64(1) != 1);
+}
+
+void TestHash()
+{
+    TestHashFNV1a64();
+    TestHashFast64();
+    TestHashInteger();
+}
\ No newline at end of file
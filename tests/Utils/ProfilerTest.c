@@ -0,0 +1,124 @@
+#include "Utils/Profiler.h"
+#include "Utils/Thread.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROFILER_TEST_NUM_THREADS 4
+#define PROFILER_TEST_ZONES_PER_THREAD 100
+
+static const char* PROFILER_TEST_FILE = "ProfilerTest.json";
+
+void ProfilerTestThread(void* argument)
+{
+    for(int i = 0; i < PROFILER_TEST_ZONES_PER_THREAD; ++i)
+    {
+        ProfilerZone outerZone = ProfilerZoneBegin("Outer", (uint64_t) (uintptr_t) argument);
+        ProfilerZone innerZone = ProfilerZoneBegin("Inner \"quoted\"", 0);
+        ProfilerZoneEnd(&innerZone, 1);
+        ProfilerZoneEnd(&outerZone, i);
+    }
+}
+
+/**
+ * @brief Count the occurrences of a string in a file.
+ * @param filePath The path of the file.
+ * @param string The string to count.
+ * @return int The number of times the string occurs in the file.
+ */
+int ProfilerTestCountInFile(const char* filePath, const char* string)
+{
+    FILE* file = fopen(filePath, "rb");
+
+    if(file == NULL)
+    {
+        return -1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* contents = malloc(fileSize + 1);
+    contents[fread(contents, 1, fileSize, file)] = '\0';
+    fclose(file);
+
+    int count = 0;
+
+    for(const char* found = strstr(contents, string); found != NULL; found = strstr(found + 1, string))
+    {
+        ++count;
+    }
+
+    free(contents);
+    return count;
+}
+
+void TestProfilerThreads()
+{
+    TEST_CHECK(ProfilerStart(0));
+    TEST_CHECK(!ProfilerStart(0));
+    TEST_CHECK(ProfilerIsRunning());
+
+    Thread* threads[PROFILER_TEST_NUM_THREADS];
+
+    for(uintptr_t t = 0; t < PROFILER_TEST_NUM_THREADS; ++t)
+    {
+        threads[t] = ThreadNew(&ProfilerTestThread, (void*) (t + 1));
+        TEST_CHECK(threads[t] != NULL);
+    }
+
+    for(int t = 0; t < PROFILER_TEST_NUM_THREADS; ++t)
+    {
+        ThreadJoin(threads[t]);
+    }
+
+    ProfilerStop();
+    TEST_CHECK(!ProfilerIsRunning());
+
+    // Zones outside of a run are not recorded.
+    ProfilerTestThread(NULL);
+
+    TEST_CHECK(ProfilerNumZones() == PROFILER_TEST_NUM_THREADS * PROFILER_TEST_ZONES_PER_THREAD * 2);
+    TEST_CHECK(ProfilerNumDropped() == 0);
+
+    TEST_CHECK(ProfilerExportChromeTrace(PROFILER_TEST_FILE));
+    TEST_CHECK(ProfilerTestCountInFile(PROFILER_TEST_FILE, "{\"traceEvents\":[") == 1);
+    TEST_CHECK(ProfilerTestCountInFile(PROFILER_TEST_FILE, "\"ph\":\"X\"") == PROFILER_TEST_NUM_THREADS * PROFILER_TEST_ZONES_PER_THREAD * 2);
+    TEST_CHECK(ProfilerTestCountInFile(PROFILER_TEST_FILE, "\"name\":\"Outer 0000000000000003\"") == PROFILER_TEST_ZONES_PER_THREAD);
+    TEST_CHECK(ProfilerTestCountInFile(PROFILER_TEST_FILE, "\"name\":\"Inner \\\"quoted\\\"\"") == PROFILER_TEST_NUM_THREADS * PROFILER_TEST_ZONES_PER_THREAD);
+    TEST_CHECK(ProfilerTestCountInFile(PROFILER_TEST_FILE, "\"args\":{\"entities\":99}}") == PROFILER_TEST_NUM_THREADS);
+
+    ProfilerReset();
+    TEST_CHECK(ProfilerNumZones() == 0);
+
+    remove(PROFILER_TEST_FILE);
+}
+
+void TestProfilerDropped()
+{
+    TEST_CHECK(ProfilerStart(10));
+
+    for(int i = 0; i < 25; ++i)
+    {
+        ProfilerZone zone = ProfilerZoneBegin("Zone", 0);
+        ProfilerZoneEnd(&zone, 0);
+    }
+
+    // A zone begun before the profiler stops is not recorded, since its end was not timed.
+    ProfilerZone unfinishedZone = ProfilerZoneBegin("Unfinished", 0);
+    ProfilerStop();
+    ProfilerZoneEnd(&unfinishedZone, 0);
+
+    TEST_CHECK(ProfilerNumZones() == 10);
+    TEST_CHECK(ProfilerNumDropped() == 15);
+
+    ProfilerReset();
+}
+
+void TestProfiler()
+{
+    TestProfilerThreads();
+    TestProfilerDropped();
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#include "Logger.h"
+
+#include <stdio.h>
+
+/**
+ * @brief Convert a binary log, written by the binary logger, to text.
+ * Usage: LogDecoder <binary log> [text file]. Without a text file, the text is written to stdout.
+ */
+int main(int argc, char* argv[])
+{
+    if(argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s <binary log> [text file]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if(!LoggerBinaryDecode(argv[1], argc == 3 ? argv[2] : NULL))
+    {
+        fprintf(stderr, "Could not decode %s.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
\ No newline at end of file